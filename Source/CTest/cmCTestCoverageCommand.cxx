@@ -26,6 +26,8 @@ cmCTestCoverageCommand::InitializeHandler(HandlerArguments& arguments,
     &mf, "CoverageCommand", "CTEST_COVERAGE_COMMAND", args.Quiet);
   this->CTest->SetCTestConfigurationFromCMakeVariable(
     &mf, "CoverageExtraFlags", "CTEST_COVERAGE_EXTRA_FLAGS", args.Quiet);
+  this->CTest->SetCTestConfigurationFromCMakeVariable(
+    &mf, "CoverageGCovJSON", "CTEST_COVERAGE_GCOV_JSON", args.Quiet);
   auto handler = cm::make_unique<cmCTestCoverageHandler>(this->CTest);
 
   // If a LABELS option was given, select only files with the labels.
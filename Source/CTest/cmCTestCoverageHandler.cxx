@@ -6,17 +6,25 @@
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iomanip>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <utility>
 
+#include <cm/optional>
 #include <cmext/algorithm>
 
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+
 #include "cmsys/FStream.hxx"
 #include "cmsys/Glob.hxx"
 #include "cmsys/RegularExpression.hxx"
+#include "cmsys/SystemInformation.hxx"
 
 #include "cmCTest.h"
 #include "cmDuration.h"
@@ -31,6 +39,8 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmUVProcessChain.h"
+#include "cmValue.h"
+#include "cmWorkerPool.h"
 #include "cmWorkingDirectory.h"
 #include "cmXMLWriter.h"
 
@@ -846,6 +856,236 @@ int cmCTestCoverageHandler::HandleBlanketJSCoverage(
   }
   return static_cast<int>(cont->TotalCoverage.size());
 }
+namespace {
+// Lines of gcov output naming the .gcov files it wrote, in each style.
+char const* const GCovStyle1CreatingRegex = "^Creating (.*\\.gcov)\\.";
+char const* const GCovStyle2CreatingRegex = "^(.*)reating [`'](.*\\.gcov)'";
+
+// The output of gcov for one run, with line counts by the names of the
+// .gcov files it wrote or, for the JSON format, by full source path.
+struct cmCTestCoverageGCovRun
+{
+  cmWorkerPool::ProcessResultT Result;
+  bool Failed = false;
+  std::map<std::string,
+           cmCTestCoverageHandlerContainer::SingleFileCoverageVector>
+    GCovFiles;
+};
+
+bool ReadGCovFile(
+  std::string const& gcovFile,
+  cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec)
+{
+  cmsys::ifstream ifile(gcovFile.c_str());
+  if (!ifile) {
+    return false;
+  }
+  std::string nl;
+  while (cmSystemTools::GetLineFromStream(ifile, nl)) {
+    // Skip empty lines
+    if (nl.empty()) {
+      continue;
+    }
+
+    // Skip unused lines
+    if (nl.size() < 12) {
+      continue;
+    }
+
+    // Handle gcov 3.0 non-coverage lines
+    // non-coverage lines seem to always start with something not
+    // a space and don't have a ':' in the 9th position
+    // TODO: Verify that this is actually a robust metric
+    if (nl[0] != ' ' && nl[9] != ':') {
+      continue;
+    }
+
+    // Read the coverage count from the beginning of the gcov output
+    // line
+    std::string prefix = nl.substr(0, 12);
+    int cov = atoi(prefix.c_str());
+
+    // Read the line number starting at the 10th character of the gcov
+    // output line
+    std::string lineNumber = nl.substr(10, 5);
+
+    int lineIdx = atoi(lineNumber.c_str()) - 1;
+    if (lineIdx >= 0) {
+      while (vec.size() <= static_cast<size_t>(lineIdx)) {
+        vec.push_back(-1);
+      }
+
+      // Initially all entries are -1 (not used). If we get coverage
+      // information, increment it to 0 first.
+      if (vec[lineIdx] < 0) {
+        if (cov > 0 || prefix.find('#') != std::string::npos) {
+          vec[lineIdx] = 0;
+        }
+      }
+
+      vec[lineIdx] += cov;
+    }
+  }
+  return true;
+}
+
+// Add the line counts of one run of gcov to the totals of a source file.
+void AddGCovCounts(
+  cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec,
+  cmCTestCoverageHandlerContainer::SingleFileCoverageVector const& counts)
+{
+  if (vec.size() < counts.size()) {
+    vec.resize(counts.size(), -1);
+  }
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    if (counts[i] >= 0) {
+      if (vec[i] < 0) {
+        vec[i] = 0;
+      }
+      vec[i] += counts[i];
+    }
+  }
+}
+}
+
+// Each compilation unit is a document on a line of its own, and is parsed
+// on its own so that only one is held in memory at a time.
+bool cmCTestCoverageHandler::ReadGCovJson(
+  std::string const& output,
+  cmCTestCoverageHandlerContainer::TotalCoverageMap& sources)
+{
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+  bool ok = true;
+  std::string::size_type begin = 0;
+  while (begin < output.size()) {
+    std::string::size_type end = output.find('\n', begin);
+    if (end == std::string::npos) {
+      end = output.size();
+    }
+    char const* first = output.data() + begin;
+    char const* last = output.data() + end;
+    begin = end + 1;
+    if (first == last || *first != '{') {
+      continue;
+    }
+
+    Json::Value unit;
+    if (!reader->parse(first, last, &unit, nullptr) || !unit.isObject()) {
+      ok = false;
+      continue;
+    }
+    std::string const cwd = unit["current_working_directory"].asString();
+    for (Json::Value const& file : unit["files"]) {
+      if (!file.isObject() || !file["file"].isString()) {
+        continue;
+      }
+      cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec =
+        sources[cmSystemTools::CollapseFullPath(file["file"].asString(),
+                                                cwd)];
+      for (Json::Value const& line : file["lines"]) {
+        if (!line.isObject() || !line["line_number"].isIntegral() ||
+            !line["count"].isIntegral()) {
+          continue;
+        }
+        int const lineIdx = line["line_number"].asInt() - 1;
+        if (lineIdx < 0) {
+          continue;
+        }
+        if (vec.size() <= static_cast<size_t>(lineIdx)) {
+          vec.resize(lineIdx + 1, -1);
+        }
+        if (vec[lineIdx] < 0) {
+          vec[lineIdx] = 0;
+        }
+        vec[lineIdx] += static_cast<int>(line["count"].asLargestInt());
+      }
+    }
+  }
+  return ok;
+}
+
+namespace {
+/** Run gcov on coverage data files and read the counts it writes.  */
+class cmCTestCoverageGCovJob : public cmWorkerPool::JobT
+{
+public:
+  using DoneT = std::function<void(std::size_t, cmCTestCoverageGCovRun)>;
+
+  cmCTestCoverageGCovJob(std::size_t index, std::vector<std::string> command,
+                         bool json, std::string const& tempDir,
+                         DoneT const& done)
+    : Index(index)
+    , Command(std::move(command))
+    , Json(json)
+    , TempDir(tempDir)
+    , Done(done)
+  {
+  }
+
+  void Process() override
+  {
+    // gcov names each .gcov file after its source file, so concurrent
+    // runs covering the same header would overwrite each other's files.
+    // Each worker runs gcov in a directory of its own.
+    std::string const workDir =
+      cmStrCat(this->TempDir, "/gcov-", this->WorkerIndex());
+    cmCTestCoverageGCovRun run;
+    if (!cmSystemTools::MakeDirectory(workDir)) {
+      run.Result.ErrorMessage =
+        cmStrCat("Unable to make directory: ", workDir);
+      run.Failed = true;
+      this->Done(this->Index, std::move(run));
+      return;
+    }
+    this->RunProcess(run.Result, this->Command, workDir);
+    // A non-zero exit code is reported, but the output is still used.
+    run.Failed = run.Result.TermSignal != 0 ||
+      (run.Result.ExitStatus == 0 && !run.Result.ErrorMessage.empty());
+    if (!run.Failed && this->Json) {
+      if (!cmCTestCoverageHandler::ReadGCovJson(run.Result.StdOut,
+                                                run.GCovFiles)) {
+        run.Result.StdErr += "Cannot parse JSON output of gcov\n";
+      }
+    } else if (!run.Failed) {
+      cmsys::RegularExpression st1re2(GCovStyle1CreatingRegex);
+      cmsys::RegularExpression st2re3(GCovStyle2CreatingRegex);
+      std::vector<std::string> lines;
+      cmsys::SystemTools::Split(run.Result.StdOut, lines);
+      for (std::string const& line : lines) {
+        std::string gcovFile;
+        if (st1re2.find(line)) {
+          gcovFile = st1re2.match(1);
+        } else if (st2re3.find(line)) {
+          gcovFile = st2re3.match(2);
+        } else {
+          continue;
+        }
+        cmCTestCoverageHandlerContainer::SingleFileCoverageVector vec;
+        if (ReadGCovFile(cmSystemTools::CollapseFullPath(gcovFile, workDir),
+                         vec)) {
+          run.GCovFiles[gcovFile] = std::move(vec);
+        }
+      }
+    }
+    this->Done(this->Index, std::move(run));
+  }
+
+private:
+  std::size_t Index;
+  std::vector<std::string> Command;
+  bool Json;
+  std::string TempDir;
+  DoneT const& Done;
+};
+
+/** Stop the worker pool once all gcov runs are done.  */
+class cmCTestCoverageGCovEndJob : public cmWorkerPool::JobFenceT
+{
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+
 int cmCTestCoverageHandler::HandleGCovCoverage(
   cmCTestCoverageHandlerContainer* cont)
 {
@@ -868,22 +1108,20 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   // Style 1
   std::string st1gcovOutputRex1 =
     "[0-9]+\\.[0-9]+% of [0-9]+ (source |)lines executed in file (.*)$";
-  std::string st1gcovOutputRex2 = "^Creating (.*\\.gcov)\\.";
   cmsys::RegularExpression st1re1(st1gcovOutputRex1.c_str());
-  cmsys::RegularExpression st1re2(st1gcovOutputRex2.c_str());
+  cmsys::RegularExpression st1re2(GCovStyle1CreatingRegex);
 
   // Style 2
   std::string st2gcovOutputRex1 = "^File *[`'](.*)'$";
   std::string st2gcovOutputRex2 =
     "Lines executed: *[0-9]+\\.[0-9]+% of [0-9]+$";
-  std::string st2gcovOutputRex3 = "^(.*)reating [`'](.*\\.gcov)'";
   std::string st2gcovOutputRex4 = "^(.*):unexpected EOF *$";
   std::string st2gcovOutputRex5 = "^(.*):cannot open source file*$";
   std::string st2gcovOutputRex6 =
     "^(.*):source file is newer than graph file `(.*)'$";
   cmsys::RegularExpression st2re1(st2gcovOutputRex1.c_str());
   cmsys::RegularExpression st2re2(st2gcovOutputRex2.c_str());
-  cmsys::RegularExpression st2re3(st2gcovOutputRex3.c_str());
+  cmsys::RegularExpression st2re3(GCovStyle2CreatingRegex);
   cmsys::RegularExpression st2re4(st2gcovOutputRex4.c_str());
   cmsys::RegularExpression st2re5(st2gcovOutputRex5.c_str());
   cmsys::RegularExpression st2re6(st2gcovOutputRex6.c_str());
@@ -907,7 +1145,6 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     cont->Error++;
     return 0;
   }
-  cmWorkingDirectory workdir(tempDir);
 
   int gcovStyle = 0;
 
@@ -928,45 +1165,140 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   std::vector<std::string> basecovargs =
     cmSystemTools::ParseArguments(gcovExtraFlags);
   basecovargs.insert(basecovargs.begin(), gcovCommand);
+
+  // gcov from GCC 10 and above can write the counts of all files given to
+  // one run in its JSON intermediate format.  Use it where available, so
+  // that many files share a run and no .gcov files are written and parsed.
+  // The CoverageGCovJSON setting may turn it off.
+  std::string const jsonSetting =
+    this->CTest->GetCTestConfiguration("CoverageGCovJSON");
+  bool const json = (jsonSetting.empty() || cmIsOn(jsonSetting)) &&
+    this->GCovHasJsonFormat(basecovargs);
+  if (json) {
+    basecovargs.emplace_back("--json-format");
+    basecovargs.emplace_back("--stdout");
+  }
   basecovargs.emplace_back("-o");
 
   // files is a list of *.da and *.gcda files with coverage data in them.
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
-  for (std::string const& f : files) {
+  // Files in the same object directory share a run in the JSON format.
+  std::size_t const maxBatchSize = 32;
+  std::vector<std::vector<std::string>> batches;
+  if (json) {
+    std::map<std::string, std::vector<std::string>> byDir;
+    for (std::string const& f : files) {
+      byDir[cmSystemTools::GetFilenamePath(f)].push_back(f);
+    }
+    for (auto& dir : byDir) {
+      for (std::size_t i = 0; i < dir.second.size(); i += maxBatchSize) {
+        auto first = dir.second.begin() + i;
+        auto last = dir.second.begin() +
+          std::min(i + maxBatchSize, dir.second.size());
+        batches.emplace_back(first, last);
+      }
+    }
+  } else {
+    for (std::string const& f : files) {
+      batches.emplace_back(1, f);
+    }
+  }
+
+  std::vector<std::vector<std::string>> commands;
+  commands.reserve(batches.size());
+  for (std::vector<std::string> const& batch : batches) {
+    std::vector<std::string> covargs = basecovargs;
+    covargs.push_back(cmSystemTools::GetFilenamePath(batch.front()));
+    cm::append(covargs, batch);
+    commands.emplace_back(std::move(covargs));
+  }
+
+  auto countFile = [&]() {
+    file_count++;
+
+    if (file_count % 50 == 0) {
+      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
+                         " processed: " << file_count << " out of "
+                                        << files.size() << std::endl,
+                         this->Quiet);
+      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+    }
+  };
+
+  // Find whether a source file named by gcov is in the source or binary
+  // directory, or report it as missing once.
+  auto findSourceFile = [&](std::string const& sourceFile) -> std::string {
+    if (IsFileInDir(sourceFile, cont->SourceDir)) {
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         "   produced s: " << sourceFile << std::endl,
+                         this->Quiet);
+      *cont->OFS << "  produced in source dir: " << sourceFile << std::endl;
+      return cmSystemTools::CollapseFullPath(sourceFile);
+    }
+    if (IsFileInDir(sourceFile, cont->BinaryDir)) {
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         "   produced b: " << sourceFile << std::endl,
+                         this->Quiet);
+      *cont->OFS << "  produced in binary dir: " << sourceFile << std::endl;
+      return cmSystemTools::CollapseFullPath(sourceFile);
+    }
+
+    if (missingFiles.find(sourceFile) == missingFiles.end()) {
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         "Something went wrong" << std::endl, this->Quiet);
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         "Cannot find file: [" << sourceFile << "]"
+                                               << std::endl,
+                         this->Quiet);
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         " in source dir: [" << cont->SourceDir << "]"
+                                             << std::endl,
+                         this->Quiet);
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                         " or binary dir: [" << cont->BinaryDir.size() << "]"
+                                             << std::endl,
+                         this->Quiet);
+      *cont->OFS << "  Something went wrong. Cannot find file: " << sourceFile
+                 << " in source dir: " << cont->SourceDir
+                 << " or binary dir: " << cont->BinaryDir << std::endl;
+
+      missingFiles.insert(sourceFile);
+    }
+    return std::string();
+  };
+
+  // Summarize the output of gcov for one file.  This is called in the
+  // order of the files, whichever order gcov finishes in.
+  auto handleRun = [&](std::size_t index, cmCTestCoverageGCovRun& run) {
+    std::string const& f = batches[index].front();
     cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
                        this->Quiet);
 
-    // Call gcov to get coverage data for this *.gcda file:
-    //
     std::string fileDir = cmSystemTools::GetFilenamePath(f);
-    std::vector<std::string> covargs = basecovargs;
-    covargs.push_back(fileDir);
-    covargs.push_back(f);
-    std::string const command = joinCommandLine(covargs);
+    std::string const command = joinCommandLine(commands[index]);
 
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                        command << std::endl, this->Quiet);
 
-    std::string output;
-    std::string errors;
-    int retVal = 0;
+    std::string const& output = run.Result.StdOut;
+    std::string errors = run.Result.StdErr;
+    if (run.Failed) {
+      errors += run.Result.ErrorMessage;
+    }
+    int retVal = static_cast<int>(run.Result.ExitStatus);
     *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
     *cont->OFS << "  Command: " << command << std::endl;
-    int res = this->CTest->RunCommand(covargs, &output, &errors, &retVal,
-                                      tempDir.c_str(),
-                                      cmDuration::zero() /*this->TimeOut*/);
-
     *cont->OFS << "  Output: " << output << std::endl;
     *cont->OFS << "  Errors: " << errors << std::endl;
-    if (!res) {
+    if (run.Failed) {
       cmCTestLog(this->CTest, ERROR_MESSAGE,
                  "Problem running coverage on file: " << f << std::endl);
       cmCTestLog(this->CTest, ERROR_MESSAGE,
                  "Command produced error: " << errors << std::endl);
       cont->Error++;
-      continue;
+      return;
     }
     if (retVal != 0) {
       cmCTestLog(this->CTest, ERROR_MESSAGE,
@@ -1127,57 +1459,12 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
                            "   in gcovFile: " << gcovFile << std::endl,
                            this->Quiet);
 
-        cmsys::ifstream ifile(gcovFile.c_str());
-        if (!ifile) {
+        auto gcov = run.GCovFiles.find(gcovFile);
+        if (gcov == run.GCovFiles.end()) {
           cmCTestLog(this->CTest, ERROR_MESSAGE,
                      "Cannot open file: " << gcovFile << std::endl);
         } else {
-          std::string nl;
-          while (cmSystemTools::GetLineFromStream(ifile, nl)) {
-            // Skip empty lines
-            if (nl.empty()) {
-              continue;
-            }
-
-            // Skip unused lines
-            if (nl.size() < 12) {
-              continue;
-            }
-
-            // Handle gcov 3.0 non-coverage lines
-            // non-coverage lines seem to always start with something not
-            // a space and don't have a ':' in the 9th position
-            // TODO: Verify that this is actually a robust metric
-            if (nl[0] != ' ' && nl[9] != ':') {
-              continue;
-            }
-
-            // Read the coverage count from the beginning of the gcov output
-            // line
-            std::string prefix = nl.substr(0, 12);
-            int cov = atoi(prefix.c_str());
-
-            // Read the line number starting at the 10th character of the gcov
-            // output line
-            std::string lineNumber = nl.substr(10, 5);
-
-            int lineIdx = atoi(lineNumber.c_str()) - 1;
-            if (lineIdx >= 0) {
-              while (vec.size() <= static_cast<size_t>(lineIdx)) {
-                vec.push_back(-1);
-              }
-
-              // Initially all entries are -1 (not used). If we get coverage
-              // information, increment it to 0 first.
-              if (vec[lineIdx] < 0) {
-                if (cov > 0 || prefix.find('#') != std::string::npos) {
-                  vec[lineIdx] = 0;
-                }
-              }
-
-              vec[lineIdx] += cov;
-            }
-          }
+          AddGCovCounts(vec, gcov->second);
         }
 
         actualSourceFile.clear();
@@ -1188,63 +1475,142 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
 
         // Is it in the source dir or the binary dir?
         //
-        if (IsFileInDir(sourceFile, cont->SourceDir)) {
-          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                             "   produced s: " << sourceFile << std::endl,
-                             this->Quiet);
-          *cont->OFS << "  produced in source dir: " << sourceFile
-                     << std::endl;
-          actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
-        } else if (IsFileInDir(sourceFile, cont->BinaryDir)) {
-          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                             "   produced b: " << sourceFile << std::endl,
-                             this->Quiet);
-          *cont->OFS << "  produced in binary dir: " << sourceFile
-                     << std::endl;
-          actualSourceFile = cmSystemTools::CollapseFullPath(sourceFile);
-        }
+        actualSourceFile = findSourceFile(sourceFile);
+      }
+    }
 
-        if (actualSourceFile.empty()) {
-          if (missingFiles.find(sourceFile) == missingFiles.end()) {
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               "Something went wrong" << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               "Cannot find file: [" << sourceFile << "]"
-                                                     << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               " in source dir: [" << cont->SourceDir << "]"
-                                                   << std::endl,
-                               this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                               " or binary dir: [" << cont->BinaryDir.size()
-                                                   << "]" << std::endl,
-                               this->Quiet);
-            *cont->OFS << "  Something went wrong. Cannot find file: "
-                       << sourceFile << " in source dir: " << cont->SourceDir
-                       << " or binary dir: " << cont->BinaryDir << std::endl;
+    countFile();
+  };
 
-            missingFiles.insert(sourceFile);
-          }
+  // Add the counts of a run in the JSON format, which are already by
+  // source file.
+  auto handleJsonRun = [&](std::size_t index, cmCTestCoverageGCovRun& run) {
+    std::vector<std::string> const& batch = batches[index];
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
+                         this->Quiet);
+    }
+
+    std::string fileDir = cmSystemTools::GetFilenamePath(batch.front());
+    std::string const command = joinCommandLine(commands[index]);
+
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       command << std::endl, this->Quiet);
+
+    std::string errors = run.Result.StdErr;
+    if (run.Failed) {
+      errors += run.Result.ErrorMessage;
+    }
+    *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
+    *cont->OFS << "  Command: " << command << std::endl;
+    *cont->OFS << "  Errors: " << errors << std::endl;
+    if (run.Failed) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Problem running coverage on files in: " << fileDir
+                                                          << std::endl);
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Command produced error: " << errors << std::endl);
+      cont->Error++;
+      return;
+    }
+    if (run.Result.ExitStatus != 0) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Coverage command returned: "
+                   << run.Result.ExitStatus
+                   << " while processing files in: " << fileDir << std::endl);
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Command produced error: " << errors << std::endl);
+    }
+
+    for (auto const& source : run.GCovFiles) {
+      std::string const fullPath = findSourceFile(source.first);
+      if (fullPath.empty()) {
+        continue;
+      }
+      auto entry = cont->TotalCoverage.emplace(
+        fullPath, cmCTestCoverageHandlerContainer::SingleFileCoverageVector());
+      if (entry.second) {
+        // The JSON format has counts only for lines with code.  Start with
+        // an unused entry for every line of the file.
+        cmsys::ifstream fin(fullPath.c_str());
+        std::string line;
+        while (cmSystemTools::GetLineFromStream(fin, line)) {
+          entry.first->second.push_back(-1);
         }
       }
+      AddGCovCounts(entry.first->second, source.second);
     }
 
-    file_count++;
-
-    if (file_count % 50 == 0) {
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
-                         " processed: " << file_count << " out of "
-                                        << files.size() << std::endl,
-                         this->Quiet);
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      countFile();
     }
+  };
+
+  // Run gcov on as many files at once as tests may run in parallel,
+  // handling each run once those of all files before it are handled.
+  unsigned int threads = 1;
+  cm::optional<size_t> parallelLevel = this->CTest->GetParallelLevel();
+  if (parallelLevel && *parallelLevel > 0) {
+    threads = static_cast<unsigned int>(
+      std::min<size_t>(*parallelLevel, batches.size()));
+  } else {
+    cmsys::SystemInformation info;
+    info.RunCPUCheck();
+    threads = static_cast<unsigned int>(
+      std::min<size_t>(info.GetNumberOfLogicalCPU(), batches.size()));
+  }
+
+  std::mutex mutex;
+  std::map<std::size_t, cmCTestCoverageGCovRun> finished;
+  std::size_t next = 0;
+  cmCTestCoverageGCovJob::DoneT const done =
+    [&](std::size_t index, cmCTestCoverageGCovRun run) {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished.emplace(index, std::move(run));
+      for (auto it = finished.find(next); it != finished.end();
+           it = finished.find(next)) {
+        if (json) {
+          handleJsonRun(next, it->second);
+        } else {
+          handleRun(next, it->second);
+        }
+        finished.erase(it);
+        ++next;
+      }
+    };
+
+  cmWorkerPool pool;
+  pool.SetThreadCount(threads);
+  for (std::size_t i = 0; i < batches.size(); ++i) {
+    pool.EmplaceJob<cmCTestCoverageGCovJob>(i, commands[i], json, tempDir,
+                                            done);
   }
+  pool.EmplaceJob<cmCTestCoverageGCovEndJob>();
+  pool.Process();
 
   return file_count;
 }
 
+bool cmCTestCoverageHandler::GCovHasJsonFormat(
+  std::vector<std::string> const& gcovCommand)
+{
+  std::vector<std::string> args = gcovCommand;
+  args.emplace_back("--help");
+  std::string output;
+  if (!cmSystemTools::RunSingleCommand(args, &output, nullptr, nullptr,
+                                       nullptr, cmSystemTools::OUTPUT_NONE)) {
+    return false;
+  }
+  bool const json = output.find("--json-format") != std::string::npos &&
+    output.find("--stdout") != std::string::npos;
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     (json ? " Using" : " Not using")
+                       << " the JSON intermediate format of gcov."
+                       << std::endl,
+                     this->Quiet);
+  return json;
+}
+
 int cmCTestCoverageHandler::HandleLCovCoverage(
   cmCTestCoverageHandlerContainer* cont)
 {
@@ -54,6 +54,15 @@ public:
   /** Report coverage only for sources with these labels.  */
   void SetLabelFilter(std::set<std::string> const& labels);
 
+  /**
+   * Add the line counts in the JSON intermediate format written by
+   * gcov --json-format --stdout to those of each source file.  Returns
+   * false if a compilation unit cannot be parsed.
+   */
+  static bool ReadGCovJson(
+    std::string const& output,
+    cmCTestCoverageHandlerContainer::TotalCoverageMap& sources);
+
 private:
   bool ShouldIDoCoverage(std::string const& file, std::string const& srcDir,
                          std::string const& binDir);
@@ -66,6 +75,7 @@ private:
 
   //! Handle coverage using GCC's GCov
   int HandleGCovCoverage(cmCTestCoverageHandlerContainer* cont);
+  bool GCovHasJsonFormat(std::vector<std::string> const& gcovCommand);
   void FindGCovFiles(std::vector<std::string>& files);
 
   //! Handle coverage using Intel's LCov
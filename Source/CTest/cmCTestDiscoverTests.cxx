@@ -6,16 +6,32 @@
 #include <cstddef>
 #include <cstdlib>
 #include <iterator>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include <cmsys/Directory.hxx>
+#include <cmsys/FStream.hxx>
 #include <cmsys/RegularExpression.hxx>
 
 #include "cmArgumentParserTypes.h"
+#include "cmCTest.h"
 #include "cmCTestTestHandler.h"
+#include "cmCryptoHash.h"
 #include "cmDuration.h"
 #include "cmEnvironment.h"
 #include "cmExecutionStatus.h"
+#include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
 #include "cmList.h"
 #include "cmProcessOutput.h"
 #include "cmStringAlgorithms.h"
@@ -83,6 +99,207 @@ private:
   cmsys::RegularExpression& RegEx;
 };
 
+/**
+ * Output of discovery commands kept between runs of ctest.
+ *
+ * Each discovery command has a file named by a hash of its command line and
+ * working directory.  The file records the output of the command along with
+ * a hash of the size and modification time of each file named on the
+ * command line, so the command runs again only when one of them changes,
+ * such as when the test executable is rebuilt.  The file also records a
+ * hash of the environment variables that may change the output without
+ * changing the command line, so the command runs again when they change.
+ * The files named on the command line are listed too, so that the entry can
+ * be removed once one of them no longer exists.
+ */
+class DiscoveryCache
+{
+public:
+  DiscoveryCache(cmCTest* ctest, std::vector<std::string> const& command,
+                 std::string const& workingDirectory, std::string environment);
+
+  std::string const& GetFile() const { return this->File; }
+
+  bool Load(std::string& output) const;
+  void Store(std::string const& output) const;
+
+  static std::string GetDirectory(cmCTest* ctest);
+  static bool IsStale(std::string const& file);
+
+private:
+  static std::string HashInputs(std::vector<std::string> const& command,
+                                std::string const& workingDirectory,
+                                std::vector<std::string>& files);
+
+  std::string File;
+  std::vector<std::string> InputFiles;
+  std::string Inputs;
+  std::string Environment;
+};
+
+DiscoveryCache::DiscoveryCache(cmCTest* ctest,
+                               std::vector<std::string> const& command,
+                               std::string const& workingDirectory,
+                               std::string environment)
+  : Inputs(HashInputs(command, workingDirectory, this->InputFiles))
+  , Environment(std::move(environment))
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view value) {
+    hasher.Append(value);
+    hasher.Append(cm::string_view("", 1));
+  };
+  append("discover_tests-v3"_s);
+  for (std::string const& arg : command) {
+    append(arg);
+  }
+  append(workingDirectory);
+  this->File =
+    cmStrCat(GetDirectory(ctest), '/', hasher.FinalizeHex(), ".json");
+}
+
+std::string DiscoveryCache::GetDirectory(cmCTest* ctest)
+{
+  return cmStrCat(ctest->GetBinaryDir(), "/Testing/Temporary/DiscoverTests");
+}
+
+bool DiscoveryCache::IsStale(std::string const& file)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  if (!Json::parseFromStream(builder, fin, &root, &errors) ||
+      !root.isObject() || !root["files"].isArray()) {
+    return true;
+  }
+  for (Json::Value const& input : root["files"]) {
+    if (!input.isString() ||
+        !cmSystemTools::FileExists(input.asString(), true)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string DiscoveryCache::HashInputs(
+  std::vector<std::string> const& command, std::string const& workingDirectory,
+  std::vector<std::string>& files)
+{
+  std::string const dir = cmSystemTools::CollapseFullPath(workingDirectory);
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  for (std::string const& arg : command) {
+    std::string const path = cmSystemTools::CollapseFullPath(arg, dir);
+    cmFileTime time;
+    if (!cmSystemTools::FileExists(path, true) || !time.Load(path)) {
+      continue;
+    }
+    hasher.Append(cmStrCat(path, '\0', cmSystemTools::FileLength(path), '\0',
+                           time.GetTime(), '\0'));
+    files.push_back(path);
+  }
+  return hasher.FinalizeHex();
+}
+
+bool DiscoveryCache::Load(std::string& output) const
+{
+  cmsys::ifstream fin(this->File.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  if (!Json::parseFromStream(builder, fin, &root, &errors) ||
+      !root.isObject() || root["inputs"] != this->Inputs ||
+      root["environment"] != this->Environment ||
+      !root["output"].isString()) {
+    return false;
+  }
+  output = root["output"].asString();
+  return true;
+}
+
+void DiscoveryCache::Store(std::string const& output) const
+{
+  if (!cmSystemTools::MakeDirectory(
+        cmSystemTools::GetFilenamePath(this->File))) {
+    return;
+  }
+  Json::Value root(Json::objectValue);
+  root["inputs"] = this->Inputs;
+  root["environment"] = this->Environment;
+  Json::Value files = Json::arrayValue;
+  for (std::string const& file : this->InputFiles) {
+    files.append(file);
+  }
+  root["files"] = std::move(files);
+  root["output"] = output;
+
+  // Concurrent runs of ctest may store the same entry.  Each writes its
+  // own temporary file and renames it into place.
+  cmGeneratedFileStream fout(this->File);
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> const writer(
+    wbuilder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+}
+
+// Environment variables that change how a discovery command finds the
+// programs and libraries it runs, and so may change its output.
+char const* const DiscoveryEnvironmentAllowList[] = {
+  "DYLD_FALLBACK_LIBRARY_PATH",
+  "DYLD_FRAMEWORK_PATH",
+  "DYLD_LIBRARY_PATH",
+  "LD_LIBRARY_PATH",
+  "LD_PRELOAD",
+  "PATH",
+};
+
+std::string EnvironmentName(std::string const& var)
+{
+  std::string name = var.substr(0, var.find('='));
+#ifdef _WIN32
+  name = cmSystemTools::UpperCase(name);
+#endif
+  return name;
+}
+
+// Hash the discovery environment properties, and the values of the
+// variables they name or that are allowed, in the environment of the run.
+// Other variables of the environment of ctest do not invalidate the cache.
+std::string HashEnvironment(DiscoveryProperties const& props,
+                            std::vector<std::string> const& variables)
+{
+  std::set<std::string> names(std::begin(DiscoveryEnvironmentAllowList),
+                              std::end(DiscoveryEnvironmentAllowList));
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  for (std::string const& var : props.Environment) {
+    names.insert(EnvironmentName(var));
+    hasher.Append(cmStrCat(var, '\0'));
+  }
+  hasher.Append(cm::string_view("", 1));
+  for (std::string const& mod : props.EnvironmentModification) {
+    names.insert(EnvironmentName(mod));
+    hasher.Append(cmStrCat(mod, '\0'));
+  }
+  hasher.Append(cm::string_view("", 1));
+  for (std::string const& var : variables) {
+    if (names.count(EnvironmentName(var))) {
+      hasher.Append(cmStrCat(var, '\0'));
+    }
+  }
+  return hasher.FinalizeHex();
+}
+
 } // namespace
 
 bool cmCTestDiscoverTests(cmTestDiscoveryArgs const& args,
@@ -114,17 +331,25 @@ bool cmCTestDiscoverTests(cmTestDiscoveryArgs const& args,
   std::copy(args.DiscoveryArgs.begin(), args.DiscoveryArgs.end(),
             std::back_inserter(runCommand));
 
+  std::vector<std::string> const variables = env.GetVariables();
+  DiscoveryCache const cache(handler->GetCTestInstance(), runCommand,
+                             props.WorkingDirectory,
+                             HashEnvironment(props, variables));
+  handler->AddDiscoveryCacheFile(cache.GetFile());
   std::string stdOut;
-  std::string stdErr;
-  bool const res = cmSystemTools::RunSingleCommand(
-    runCommand, &stdOut, &stdErr, nullptr, props.WorkingDirectory.c_str(),
-    cmSystemTools::OUTPUT_NONE, props.Timeout, cmProcessOutput::Auto,
-    env.GetVariables());
-  if (!res) {
-    status.SetError(cmStrCat(" failed to run command: ",
-                             cmSystemTools::PrintSingleCommand(runCommand),
-                             "\n", stdErr));
-    return false;
+  if (!cache.Load(stdOut)) {
+    std::string stdErr;
+    bool const res = cmSystemTools::RunSingleCommand(
+      runCommand, &stdOut, &stdErr, nullptr, props.WorkingDirectory.c_str(),
+      cmSystemTools::OUTPUT_NONE, props.Timeout, cmProcessOutput::Auto,
+      variables);
+    if (!res) {
+      status.SetError(cmStrCat(" failed to run command: ",
+                               cmSystemTools::PrintSingleCommand(runCommand),
+                               "\n", stdErr));
+      return false;
+    }
+    cache.Store(stdOut);
   }
 
   auto replace = RegexReplacer{ re };
@@ -161,3 +386,20 @@ bool cmCTestDiscoverTests(cmTestDiscoveryArgs const& args,
 
   return true;
 }
+
+void cmCTestPruneDiscoveryCache(cmCTest* ctest,
+                                std::set<std::string> const& used)
+{
+  std::string const dir = DiscoveryCache::GetDirectory(ctest);
+  cmsys::Directory d;
+  if (!d.Load(dir)) {
+    return;
+  }
+  for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+    std::string const file = cmStrCat(dir, '/', d.GetFileName(i));
+    if (cmHasLiteralSuffix(file, ".json") && !used.count(file) &&
+        DiscoveryCache::IsStale(file)) {
+      cmSystemTools::RemoveFile(file);
+    }
+  }
+}
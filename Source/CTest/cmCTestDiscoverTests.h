@@ -4,10 +4,19 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <set>
+#include <string>
+
 struct cmTestDiscoveryArgs;
+class cmCTest;
 class cmCTestTestHandler;
 class cmExecutionStatus;
 
 bool cmCTestDiscoverTests(cmTestDiscoveryArgs const& args,
                           cmCTestTestHandler* handler,
                           cmExecutionStatus& status);
+
+/** Remove the discovery output cache files not named in \p used whose
+    input files no longer exist.  */
+void cmCTestPruneDiscoveryCache(cmCTest* ctest,
+                                std::set<std::string> const& used);
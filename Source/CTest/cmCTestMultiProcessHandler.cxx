@@ -12,6 +12,7 @@
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <queue>
 #include <sstream>
 #include <stack>
 #include <unordered_map>
@@ -111,8 +112,8 @@ public:
   // Sorts tests in descending order of cost
   bool operator()(int index1, int index2) const
   {
-    return this->Handler->Properties[index1]->Cost >
-      this->Handler->Properties[index2]->Cost;
+    return this->Handler->GetTestCost(index1) >
+      this->Handler->GetTestCost(index2);
   }
 
 private:
@@ -137,9 +138,22 @@ bool cmCTestMultiProcessHandler::SetTests(TestMap tests,
 {
   this->PendingTests = std::move(tests);
   this->Properties = std::move(properties);
+  // Shards are selected by cost even when only showing the tests.
+  bool const sharded = this->TestHandler->TestOptions.ShardCount > 1;
+  if (sharded || !this->CTest->GetShowOnly()) {
+    if (this->TestHandler->TestOptions.TestHistory) {
+      this->ReadTestHistory();
+    }
+    this->ReadCostData();
+    if (this->TestHandler->TestOptions.TestMemoryLimit != 0) {
+      this->ReadMemoryData();
+    }
+  }
+  if (sharded) {
+    this->SelectShard();
+  }
   this->Total = this->PendingTests.size();
   if (!this->CTest->GetShowOnly()) {
-    this->ReadCostData();
     this->HasCycles = !this->CheckCycles();
     this->HasInvalidGeneratedResourceSpec =
       !this->CheckGeneratedResourceSpec();
@@ -241,11 +255,24 @@ void cmCTestMultiProcessHandler::RunTests()
   }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
 
+  auto const startTime = std::chrono::steady_clock::now();
   this->InitializeLoop();
   this->StartNextTestsOnIdle();
   uv_run(this->Loop, UV_RUN_DEFAULT);
   this->FinalizeLoop();
 
+  if (this->PredictedMakespan) {
+    std::chrono::duration<double> const actual =
+      std::chrono::steady_clock::now() - startTime;
+    cmCTestLog(this->CTest, HANDLER_OUTPUT,
+               "Critical path: " << std::fixed << std::setprecision(2)
+                                 << *this->PredictedCriticalPath
+                                 << " sec, predicted test time: "
+                                 << *this->PredictedMakespan
+                                 << " sec, actual: " << actual.count()
+                                 << " sec" << std::endl);
+  }
+
   if (!this->StopTimePassed && !this->CheckStopOnFailure()) {
     assert(this->Complete());
     assert(this->PendingTests.empty());
@@ -254,6 +281,12 @@ void cmCTestMultiProcessHandler::RunTests()
 
   this->MarkFinished();
   this->UpdateCostData();
+  if (this->TestHandler->TestOptions.TestMemoryLimit != 0) {
+    this->UpdateMemoryData();
+  }
+  if (this->TestHistory) {
+    this->UpdateTestHistory();
+  }
 }
 
 void cmCTestMultiProcessHandler::StartTestProcess(int test)
@@ -492,12 +525,27 @@ bool cmCTestMultiProcessHandler::ResourceLocksAvailable(int test)
                      });
 }
 
+bool cmCTestMultiProcessHandler::MemoryAvailable(int test) const
+{
+  unsigned long long const limit =
+    this->TestHandler->TestOptions.TestMemoryLimit;
+  if (limit == 0 || this->RunningCount == 0) {
+    // A test that needs more than the whole budget runs alone.
+    return true;
+  }
+  return this->RunningMemory +
+    this->Properties.at(test)->ExpectedMemory <=
+    limit;
+}
+
 void cmCTestMultiProcessHandler::LockResources(int index)
 {
   this->RunningCount += this->GetProcessorsUsed(index);
 
   auto* properties = this->Properties[index];
 
+  this->RunningMemory += properties->ExpectedMemory;
+
   this->ProjectResourcesLocked.insert(properties->ProjectResources.begin(),
                                       properties->ProjectResources.end());
 
@@ -536,6 +584,7 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
     this->SerialTestRunning = false;
   }
 
+  this->RunningMemory -= properties->ExpectedMemory;
   this->RunningCount -= this->GetProcessorsUsed(index);
 }
 
@@ -697,6 +746,17 @@ void cmCTestMultiProcessHandler::StartNextTests()
       continue;
     }
 
+    // Exclude tests whose expected memory does not fit in the budget.
+    if (!this->MemoryAvailable(test)) {
+      cmCTestLog(this->CTest, DEBUG,
+                 "Not enough memory to run "
+                   << this->GetName(test) << ", it requires "
+                   << this->Properties[test]->ExpectedMemory
+                   << " KiB & running tests require " << this->RunningMemory
+                   << " KiB" << std::endl);
+      continue;
+    }
+
     // Allocate system resources needed by this test.
     if (!this->AllocateResources(test)) {
       continue;
@@ -826,7 +886,13 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   cmsys::ofstream fout;
   fout.open(tmpout.c_str());
 
-  PropertiesMap temp = this->Properties;
+  // Sharded runs keep the recorded costs so that every shard run in
+  // this tree selects its tests from the same costs.
+  bool const sharded = this->TestHandler->TestOptions.ShardCount > 1;
+  PropertiesMap temp;
+  if (!sharded) {
+    temp = this->Properties;
+  }
 
   if (cmSystemTools::FileExists(fname)) {
     cmsys::ifstream fin;
@@ -844,8 +910,9 @@ void cmCTestMultiProcessHandler::UpdateCostData()
       }
 
       int index = this->SearchByName(entry->name);
-      if (index == -1) {
-        // This test is not in memory. We just rewrite the entry
+      if (index == -1 || sharded) {
+        // This test is not in memory or its cost is kept. We just rewrite
+        // the entry
         fout << entry->name << " " << entry->prevRuns << " " << entry->cost
              << "\n";
       } else {
@@ -903,9 +970,13 @@ void cmCTestMultiProcessHandler::ReadCostData()
 
       this->Properties[index]->PreviousRuns = entry->prevRuns;
       // When not running in parallel mode, don't use cost data
-      if (this->GetParallelLevel() > 1 && this->Properties[index] &&
-          this->Properties[index]->Cost == 0) {
-        this->Properties[index]->Cost = entry->cost;
+      // except to select a shard
+      if (this->Properties[index] && this->Properties[index]->Cost == 0) {
+        if (this->GetParallelLevel() > 1) {
+          this->Properties[index]->Cost = entry->cost;
+        } else {
+          this->ShardCosts.emplace(index, entry->cost);
+        }
       }
     }
     // Next part of the file is the failed tests
@@ -918,6 +989,252 @@ void cmCTestMultiProcessHandler::ReadCostData()
   }
 }
 
+std::string cmCTestMultiProcessHandler::GetMemoryDataFile()
+{
+  return cmStrCat(
+    cmSystemTools::GetFilenamePath(this->CTest->GetCostDataFile()),
+    "/CTestMemoryData.txt");
+}
+
+void cmCTestMultiProcessHandler::UpdateMemoryData()
+{
+  if (std::none_of(this->Properties.begin(), this->Properties.end(),
+                   [](PropertiesMap::value_type const& p) {
+                     return p.second->PeakMemory != 0;
+                   })) {
+    return;
+  }
+
+  std::string fname = this->GetMemoryDataFile();
+  std::string tmpout = fname + ".tmp";
+  cmsys::ofstream fout;
+  fout.open(tmpout.c_str());
+
+  std::set<int> written;
+  cmsys::ifstream fin;
+  fin.open(fname.c_str());
+  std::string line;
+  while (std::getline(fin, line)) {
+    // Format: <name> <peak_memory_kib>
+    std::string::size_type const pos = line.rfind(' ');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    cm::string_view const name = cm::string_view(line).substr(0, pos);
+    int index = this->SearchByName(name);
+    if (index != -1 && this->Properties[index]->PeakMemory != 0) {
+      // Update with the peak memory of this run.
+      fout << name << " " << this->Properties[index]->PeakMemory << "\n";
+      written.insert(index);
+    } else {
+      fout << line << "\n";
+      if (index != -1) {
+        written.insert(index);
+      }
+    }
+  }
+  fin.close();
+
+  // Add all tests measured for the first time.
+  for (auto const& p : this->Properties) {
+    if (p.second->PeakMemory != 0 && written.count(p.first) == 0) {
+      fout << p.second->Name << " " << p.second->PeakMemory << "\n";
+    }
+  }
+  fout.close();
+  cmSystemTools::RenameFile(tmpout, fname);
+}
+
+void cmCTestMultiProcessHandler::ReadMemoryData()
+{
+  cmsys::ifstream fin;
+  fin.open(this->GetMemoryDataFile().c_str());
+  std::string line;
+  while (std::getline(fin, line)) {
+    // Format: <name> <peak_memory_kib>
+    std::string::size_type const pos = line.rfind(' ');
+    unsigned long long peak;
+    if (pos == std::string::npos ||
+        !cmStrToULongLong(line.substr(pos + 1), &peak)) {
+      continue;
+    }
+    int index = this->SearchByName(cm::string_view(line).substr(0, pos));
+    if (index != -1) {
+      this->Properties[index]->ExpectedMemory = peak;
+    }
+  }
+}
+
+void cmCTestMultiProcessHandler::ReadTestHistory()
+{
+  this->TestHistory.emplace(cmStrCat(
+    this->CTest->GetBinaryDir(), "/Testing/Temporary/CTestTestHistory.log"));
+  this->TestHistory->Load();
+
+  // When not running in parallel mode, don't use the durations.  Tests
+  // with an explicit COST keep it.  Shards are not selected by the
+  // durations because every run records new ones.
+  if (this->GetParallelLevel() <= 1) {
+    return;
+  }
+  std::string const& config = this->CTest->GetConfigType();
+  for (auto const& p : this->Properties) {
+    if (p.second->Cost != 0) {
+      continue;
+    }
+    if (cm::optional<cmCTestTestHistory::Statistics> stats =
+          this->TestHistory->GetStatistics(p.second->Name, config)) {
+      this->TestHistoryCosts[p.first] =
+        static_cast<float>(stats->Percentile90);
+    }
+  }
+}
+
+void cmCTestMultiProcessHandler::UpdateTestHistory()
+{
+  std::string const& config = this->CTest->GetConfigType();
+  std::vector<cmCTestTestHistory::Run> runs;
+  for (cmCTestTestHandler::cmCTestTestResult const& result :
+       *this->TestResults) {
+    if (result.Status == cmCTestTestHandler::NOT_RUN ||
+        !result.StartTestTime) {
+      continue;
+    }
+    cmCTestTestHistory::Run run;
+    run.Name = result.Name;
+    run.Config = config;
+    run.StartTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(
+        *result.StartTestTime)
+        .count();
+    run.Duration = result.ExecutionTime.count();
+    run.Passed = result.Status == cmCTestTestHandler::COMPLETED;
+    runs.emplace_back(std::move(run));
+  }
+  this->TestHistory->Record(runs);
+  this->TestHistory->WriteJson(cmStrCat(
+    this->CTest->GetBinaryDir(), "/Testing/Temporary/CTestTestHistory.json"));
+}
+
+float cmCTestMultiProcessHandler::GetTestCost(int index)
+{
+  auto it = this->TestHistoryCosts.find(index);
+  if (it != this->TestHistoryCosts.end()) {
+    return it->second;
+  }
+  return this->Properties[index]->Cost;
+}
+
+void cmCTestMultiProcessHandler::SelectShard()
+{
+  // Tests that depend on each other, directly or through fixtures, or
+  // that lock a common resource, must run in the same shard.
+  std::map<int, int> parent;
+  for (auto const& t : this->PendingTests) {
+    parent[t.first] = t.first;
+  }
+  std::function<int(int)> find = [&parent, &find](int test) -> int {
+    int& p = parent.at(test);
+    if (p != test) {
+      p = find(p);
+    }
+    return p;
+  };
+  auto unite = [&parent, &find](int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) {
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  };
+  std::map<std::string, int> resourceTests;
+  for (auto const& t : this->PendingTests) {
+    for (int dep : t.second.Depends) {
+      // Dependencies that do not run, e.g. because they passed before
+      // a resumed run, do not tie tests together.
+      if (this->PendingTests.count(dep) != 0) {
+        unite(t.first, dep);
+      }
+    }
+    for (std::string const& resource :
+         this->Properties[t.first]->ProjectResources) {
+      auto it = resourceTests.emplace(resource, t.first).first;
+      unite(t.first, it->second);
+    }
+  }
+
+  // Tests without a known cost are assumed to take the average time.
+  std::map<int, float> costs;
+  float totalCost = 0;
+  std::size_t knownCosts = 0;
+  for (auto const& t : this->PendingTests) {
+    auto it = this->ShardCosts.find(t.first);
+    float const cost = it != this->ShardCosts.end()
+      ? it->second
+      : this->Properties[t.first]->Cost;
+    costs[t.first] = cost;
+    if (cost > 0) {
+      totalCost += cost;
+      ++knownCosts;
+    }
+  }
+  float const defaultCost =
+    knownCosts > 0 ? totalCost / static_cast<float>(knownCosts) : 1.0f;
+
+  struct Group
+  {
+    int Root;
+    double Cost = 0;
+    TestList Tests;
+  };
+  std::map<int, Group> groups;
+  for (auto const& t : this->PendingTests) {
+    int const root = find(t.first);
+    Group& group = groups[root];
+    group.Root = root;
+    group.Cost += costs[t.first] > 0 ? costs[t.first] : defaultCost;
+    group.Tests.push_back(t.first);
+  }
+
+  // Assign the most costly groups first, each to the shard with the least
+  // cost so far.  The result depends only on the tests and their costs,
+  // so every shard computes the same partition.
+  std::vector<Group const*> order;
+  order.reserve(groups.size());
+  for (auto const& g : groups) {
+    order.push_back(&g.second);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](Group const* l, Group const* r) {
+                     if (l->Cost != r->Cost) {
+                       return l->Cost > r->Cost;
+                     }
+                     return l->Root < r->Root;
+                   });
+  std::size_t const shardCount = this->TestHandler->TestOptions.ShardCount;
+  std::size_t const shardIndex = this->TestHandler->TestOptions.ShardIndex;
+  std::vector<double> shardCosts(shardCount, 0);
+  for (Group const* group : order) {
+    auto const shard = static_cast<std::size_t>(
+      std::min_element(shardCosts.begin(), shardCosts.end()) -
+      shardCosts.begin());
+    shardCosts[shard] += group->Cost;
+    if (shard != shardIndex) {
+      for (int test : group->Tests) {
+        this->PendingTests.erase(test);
+        this->Properties.erase(test);
+      }
+    }
+  }
+
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Selected shard " << shardIndex << " of " << shardCount
+                                       << ": " << this->PendingTests.size()
+                                       << " tests, estimated cost "
+                                       << shardCosts[shardIndex] << std::endl,
+                     this->Quiet);
+}
+
 int cmCTestMultiProcessHandler::SearchByName(cm::string_view name)
 {
   int index = -1;
@@ -932,7 +1249,10 @@ int cmCTestMultiProcessHandler::SearchByName(cm::string_view name)
 
 void cmCTestMultiProcessHandler::CreateTestCostList()
 {
-  if (this->GetParallelLevel() > 1) {
+  if (this->GetParallelLevel() > 1 &&
+      this->CTest->GetScheduleType() == "CriticalPath") {
+    this->CreateCriticalPathTestCostList();
+  } else if (this->GetParallelLevel() > 1) {
     this->CreateParallelTestCostList();
   } else {
     this->CreateSerialTestCostList();
@@ -997,6 +1317,121 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
   }
 }
 
+void cmCTestMultiProcessHandler::CreateCriticalPathTestCostList()
+{
+  // Tests with no recorded cost are assumed to take as long as the
+  // average of those with one.
+  double totalCost = 0;
+  size_t costCount = 0;
+  for (auto const& t : this->PendingTests) {
+    if (this->GetTestCost(t.first) > 0) {
+      totalCost += this->GetTestCost(t.first);
+      ++costCount;
+    }
+  }
+  double const defaultCost = costCount > 0 ? totalCost / costCount : 1.0;
+  auto getCost = [this, defaultCost](int test) -> double {
+    float const cost = this->GetTestCost(test);
+    return cost > 0 ? cost : defaultCost;
+  };
+
+  // Sort the tests so that each follows its dependencies.
+  std::unordered_map<int, TestList> dependents;
+  std::unordered_map<int, size_t> dependsCount;
+  TestList sortedTests;
+  for (auto const& t : this->PendingTests) {
+    size_t count = 0;
+    for (int dep : t.second.Depends) {
+      if (cm::contains(this->PendingTests, dep)) {
+        dependents[dep].push_back(t.first);
+        ++count;
+      }
+    }
+    dependsCount[t.first] = count;
+    if (count == 0) {
+      sortedTests.push_back(t.first);
+    }
+  }
+  {
+    std::unordered_map<int, size_t> waiting = dependsCount;
+    for (size_t i = 0; i < sortedTests.size(); ++i) {
+      for (int dependent : dependents[sortedTests[i]]) {
+        if (--waiting[dependent] == 0) {
+          sortedTests.push_back(dependent);
+        }
+      }
+    }
+  }
+
+  // The priority of a test is the time from its start to the end of the
+  // longest chain of tests that must run after it.
+  std::unordered_map<int, double> priority;
+  double criticalPath = 0;
+  for (int test : cmReverseRange(sortedTests)) {
+    double longest = 0;
+    for (int dependent : dependents[test]) {
+      longest = std::max(longest, priority[dependent]);
+    }
+    priority[test] = getCost(test) + longest;
+    criticalPath = std::max(criticalPath, priority[test]);
+  }
+  std::stable_sort(sortedTests.begin(), sortedTests.end(),
+                   [&priority, &getCost](int l, int r) {
+                     if (priority[l] != priority[r]) {
+                       return priority[l] > priority[r];
+                     }
+                     return getCost(l) > getCost(r);
+                   });
+  this->OrderedTests.assign(sortedTests.begin(), sortedTests.end());
+
+  // Predict the makespan by simulating the schedule with the costs as
+  // durations.  Resources and the test load are not taken into account.
+  size_t const parallelLevel = this->GetParallelLevel();
+  auto getProcessors = [this, parallelLevel](int test) -> size_t {
+    return this->Properties[test]->RunSerial ? parallelLevel
+                                             : this->GetProcessorsUsed(test);
+  };
+  std::unordered_map<int, size_t> position;
+  for (size_t i = 0; i < sortedTests.size(); ++i) {
+    position[sortedTests[i]] = i;
+  }
+  std::set<std::pair<size_t, int>> ready;
+  for (auto const& t : dependsCount) {
+    if (t.second == 0) {
+      ready.emplace(position[t.first], t.first);
+    }
+  }
+  using RunningTest = std::pair<double, int>;
+  std::priority_queue<RunningTest, std::vector<RunningTest>,
+                      std::greater<RunningTest>>
+    running;
+  double now = 0;
+  size_t available = parallelLevel;
+  while (!ready.empty() || !running.empty()) {
+    for (auto it = ready.begin(); it != ready.end() && available > 0;) {
+      size_t const processors = getProcessors(it->second);
+      if (processors > available) {
+        ++it;
+        continue;
+      }
+      available -= processors;
+      running.emplace(now + getCost(it->second), it->second);
+      it = ready.erase(it);
+    }
+    RunningTest const finished = running.top();
+    running.pop();
+    now = finished.first;
+    available += getProcessors(finished.second);
+    for (int dependent : dependents[finished.second]) {
+      if (--dependsCount[dependent] == 0) {
+        ready.emplace(position[dependent], dependent);
+      }
+    }
+  }
+  this->PredictedCriticalPath = criticalPath;
+  this->PredictedMakespan = now;
+}
+
 void cmCTestMultiProcessHandler::GetAllTestDependencies(int test,
                                                         TestList& dependencies)
 {
@@ -19,6 +19,7 @@
 #include "cmCTestResourceAllocator.h"
 #include "cmCTestResourceSpec.h"
 #include "cmCTestTestHandler.h"
+#include "cmCTestTestHistory.h"
 #include "cmUVHandlePtr.h"
 #include "cmUVJobServerClient.h"
 
@@ -110,6 +111,20 @@ protected:
 
   void UpdateCostData();
   void ReadCostData();
+  // Record the peak memory of tests next to their costs.
+  std::string GetMemoryDataFile();
+  void UpdateMemoryData();
+  void ReadMemoryData();
+  // Use the recorded durations of tests as their costs, and record the
+  // durations of this run.
+  void ReadTestHistory();
+  void UpdateTestHistory();
+  // Return the cost of a test used to order tests.
+  float GetTestCost(int index);
+  // Keep only the tests of the selected shard.  Tests are partitioned by
+  // cost, keeping dependent tests and tests locking a common resource
+  // together.
+  void SelectShard();
   // Return index of a test based on its name
   int SearchByName(cm::string_view name);
 
@@ -119,6 +134,9 @@ protected:
   void CreateSerialTestCostList();
 
   void CreateParallelTestCostList();
+  // Order tests by the longest chain of dependent tests they start,
+  // using their costs as durations, and predict the makespan.
+  void CreateCriticalPathTestCostList();
 
   // Removes the checkpoint file
   void MarkFinished();
@@ -145,6 +163,8 @@ protected:
   void FinalizeLoop();
 
   bool ResourceLocksAvailable(int test);
+  // Check that the expected memory of a test fits in the budget.
+  bool MemoryAvailable(int test) const;
   void LockResources(int index);
   void UnlockResources(int index);
 
@@ -181,11 +201,17 @@ private:
   TestMap PendingTests;
   // List of pending test indexes, ordered by cost.
   std::list<int> OrderedTests;
+  // Predicted durations of the longest dependency chain and of all tests
+  // when scheduling by critical path, in seconds.
+  cm::optional<double> PredictedCriticalPath;
+  cm::optional<double> PredictedMakespan;
   // Total number of tests we'll be running
   size_t Total = 0;
   // Number of tests that are complete
   size_t Completed = 0;
   size_t RunningCount = 0;
+  // Sum of the expected memory of running tests in KiB.
+  unsigned long long RunningMemory = 0;
   std::set<size_t> ProcessorsAvailable;
   size_t HaveAffinity;
   bool StopTimePassed = false;
@@ -195,6 +221,11 @@ private:
   std::vector<std::string>* Passed;
   std::vector<std::string>* Failed;
   std::vector<std::string> LastTestsFailed;
+  cm::optional<cmCTestTestHistory> TestHistory;
+  std::map<int, float> TestHistoryCosts;
+  // Recorded costs used only to select a shard, when not running in
+  // parallel.
+  std::map<int, float> ShardCosts;
   std::set<std::string> ProjectResourcesLocked;
   std::map<int,
            std::vector<std::map<std::string, std::vector<ResourceAllocation>>>>
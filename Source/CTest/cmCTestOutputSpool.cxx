@@ -0,0 +1,93 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmCTestOutputSpool.h"
+
+#include <utility>
+
+#include <cm3p/zlib.h>
+
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+cmCTestOutputSpool::cmCTestOutputSpool(std::string file, std::size_t keep)
+  : File(std::move(file))
+  , Keep(keep)
+{
+}
+
+cmCTestOutputSpool::~cmCTestOutputSpool()
+{
+  this->Close();
+}
+
+void cmCTestOutputSpool::Append(cm::string_view text)
+{
+  if (!this->Stream && !this->Failed && this->Size == 0) {
+    cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(this->File));
+    this->Stream = gzopen(this->File.c_str(), "wb");
+    this->Failed = !this->Stream;
+  }
+  if (this->Stream && !text.empty() &&
+      gzwrite(this->Stream, text.data(), static_cast<unsigned>(text.size())) !=
+        static_cast<int>(text.size())) {
+    gzclose(this->Stream);
+    this->Stream = nullptr;
+    this->Failed = true;
+  }
+  this->Size += text.size();
+
+  // Without a complete file, keep everything not yet dropped.
+  if (this->Head.size() < this->Keep || (this->Failed && this->Tail.empty())) {
+    this->Head.append(text.data(), text.size());
+    return;
+  }
+  this->Tail.append(text.data(), text.size());
+  if (this->Tail.size() > 2 * this->Keep) {
+    this->Tail.erase(0, this->Tail.size() - this->Keep);
+  }
+}
+
+bool cmCTestOutputSpool::Close()
+{
+  if (this->Stream) {
+    this->Failed = gzclose(this->Stream) != Z_OK;
+    this->Stream = nullptr;
+  }
+  return !this->Failed;
+}
+
+bool cmCTestOutputSpool::IsTruncated() const
+{
+  return this->Head.size() + this->Tail.size() < this->Size;
+}
+
+std::string cmCTestOutputSpool::GetOutput() const
+{
+  if (!this->IsTruncated()) {
+    return cmStrCat(this->Head, this->Tail);
+  }
+  unsigned long long const omitted =
+    this->Size - this->Head.size() - this->Tail.size();
+  return cmStrCat(this->Head, "\n[", omitted,
+                  " bytes of the test output were omitted here",
+                  this->Failed
+                    ? std::string(".]\n")
+                    : cmStrCat("; the full output is in\n \"", this->File,
+                               "\".]\n"),
+                  this->Tail);
+}
+
+bool cmCTestOutputSpool::Read(std::string const& file, std::string& output)
+{
+  gzFile in = gzopen(file.c_str(), "rb");
+  if (!in) {
+    return false;
+  }
+  output.clear();
+  char buffer[65536];
+  int n;
+  while ((n = gzread(in, buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<std::size_t>(n));
+  }
+  return gzclose(in) == Z_OK && n == 0;
+}
@@ -0,0 +1,59 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+
+#include <cm/string_view>
+
+struct gzFile_s;
+
+/** \class cmCTestOutputSpool
+ * \brief Output of a test written to a compressed file as it arrives
+ *
+ * The whole output is written to a gzip file.  Only its beginning and end
+ * are kept in memory, each at least as long as the given size, so that a
+ * test printing a lot of output takes bounded memory.  If the file cannot
+ * be written, all output is kept in memory instead.
+ */
+class cmCTestOutputSpool
+{
+public:
+  cmCTestOutputSpool(std::string file, std::size_t keep);
+  ~cmCTestOutputSpool();
+
+  cmCTestOutputSpool(cmCTestOutputSpool const&) = delete;
+  cmCTestOutputSpool& operator=(cmCTestOutputSpool const&) = delete;
+
+  /** Append output.  The file is created when output first arrives.  */
+  void Append(cm::string_view text);
+
+  /** Finish writing the file.  Returns false if it could not be written.  */
+  bool Close();
+
+  std::string const& GetFile() const { return this->File; }
+
+  /** Return true if part of the output is kept only in the file.  */
+  bool IsTruncated() const;
+
+  /**
+   * Return the output kept in memory.  If part of it is kept only in the
+   * file, a note naming the file takes its place.
+   */
+  std::string GetOutput() const;
+
+  /** Read the whole output from a spool file.  */
+  static bool Read(std::string const& file, std::string& output);
+
+private:
+  std::string File;
+  std::size_t Keep;
+  gzFile_s* Stream = nullptr;
+  bool Failed = false;
+  std::string Head;
+  std::string Tail;
+  unsigned long long Size = 0;
+};
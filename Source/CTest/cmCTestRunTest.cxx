@@ -16,10 +16,12 @@
 #include <cm/optional>
 
 #include "cmsys/RegularExpression.hxx"
+#include "cmsys/String.h"
 
 #include "cmCTest.h"
 #include "cmCTestMemCheckHandler.h"
 #include "cmCTestMultiProcessHandler.h"
+#include "cmCTestOutputSpool.h"
 #include "cmDuration.h"
 #include "cmEnvironment.h"
 #include "cmInstrumentation.h"
@@ -75,6 +77,26 @@ void cmCTestRunTest::CheckOutput(std::string const& line)
     }
   }
 
+  if (this->OutputSpool) {
+    this->OutputSpool->Append(line);
+    this->OutputSpool->Append("\n");
+    if (line.find("<DartMeasurement") != std::string::npos ||
+        line.find("<CTestMeasurement") != std::string::npos) {
+      this->InSpooledMeasurement = true;
+    }
+    if (this->InSpooledMeasurement) {
+      this->SpooledMeasurements += line;
+      this->SpooledMeasurements += "\n";
+      this->InSpooledMeasurement =
+        line.find("</DartMeasurement") == std::string::npos &&
+        line.find("</CTestMeasurement") == std::string::npos;
+    }
+    if (line.find("CTEST_FULL_OUTPUT") != std::string::npos) {
+      this->SpooledFullOutput = true;
+    }
+    return;
+  }
+
   this->ProcessOutput += line;
   this->ProcessOutput += "\n";
 
@@ -104,6 +126,10 @@ cmCTestRunTest::EndTestResult cmCTestRunTest::EndTest(size_t completed,
                                                       size_t total,
                                                       bool started)
 {
+  if (this->OutputSpool) {
+    this->OutputSpool->Close();
+    this->ProcessOutput = this->OutputSpool->GetOutput();
+  }
   this->WriteLogOutputTop(completed, total);
   std::string reason;
   bool passed = true;
@@ -362,6 +388,7 @@ cmCTestRunTest::EndTestResult cmCTestRunTest::EndTest(size_t completed,
     this->TestResult.Output =
       compress ? compressedOutput : this->ProcessOutput;
     this->TestResult.CompressOutput = compress;
+    this->FinishOutputSpool();
     this->TestResult.ReturnValue = this->TestProcess->GetExitValue();
     if (!skipped) {
       this->TestResult.CompletionStatus = "Completed";
@@ -371,6 +398,9 @@ cmCTestRunTest::EndTestResult cmCTestRunTest::EndTest(size_t completed,
     this->TestResult.ExecutionTime = this->TestProcess->GetTotalTime();
     this->MemCheckPostProcess();
     this->ComputeWeightedCost();
+    if (unsigned long long peak = this->TestProcess->GetPeakMemory()) {
+      this->TestProperties->PeakMemory = peak;
+    }
   }
   // If the test does not need to rerun push the current TestResult onto the
   // TestHandler vector
@@ -490,6 +520,7 @@ void cmCTestRunTest::StartFailure(size_t total, std::string const& output,
   }
 
   this->ProcessOutput.clear();
+  this->OutputSpool.reset();
   if (!output.empty()) {
     *this->TestHandler->LogFile << output << std::endl;
     cmCTestLog(this->CTest, ERROR_MESSAGE, output << std::endl);
@@ -498,6 +529,7 @@ void cmCTestRunTest::StartFailure(size_t total, std::string const& output,
   this->TestResult.Properties = this->TestProperties;
   this->TestResult.ExecutionTime = cmDuration::zero();
   this->TestResult.CompressOutput = false;
+  this->TestResult.OutputFile.clear();
   this->TestResult.ReturnValue = -1;
   this->TestResult.CompletionStatus = detail;
   this->TestResult.Status = cmCTestTestHandler::NOT_RUN;
@@ -560,10 +592,12 @@ bool cmCTestRunTest::StartTest(size_t completed, size_t total)
   }
 
   this->ProcessOutput.clear();
+  this->StartOutputSpool();
 
   this->TestResult.Properties = this->TestProperties;
   this->TestResult.ExecutionTime = cmDuration::zero();
   this->TestResult.CompressOutput = false;
+  this->TestResult.OutputFile.clear();
   this->TestResult.ReturnValue = -1;
   this->TestResult.TestCount = this->TestProperties->Index;
   this->TestResult.Name = this->TestProperties->Name;
@@ -756,11 +790,15 @@ void cmCTestRunTest::ComputeArguments()
 
 void cmCTestRunTest::ParseOutputForMeasurements()
 {
-  if (!this->ProcessOutput.empty() &&
-      (this->ProcessOutput.find("<DartMeasurement") != std::string::npos ||
-       this->ProcessOutput.find("<CTestMeasurement") != std::string::npos)) {
-    if (this->TestHandler->AllTestMeasurementsRegex.find(
-          this->ProcessOutput)) {
+  // Measurements may be in spooled output no longer kept in memory.
+  std::string const& output =
+    this->OutputSpool && this->OutputSpool->IsTruncated()
+    ? this->SpooledMeasurements
+    : this->ProcessOutput;
+  if (!output.empty() &&
+      (output.find("<DartMeasurement") != std::string::npos ||
+       output.find("<CTestMeasurement") != std::string::npos)) {
+    if (this->TestHandler->AllTestMeasurementsRegex.find(output)) {
       this->TestResult.TestMeasurementsOutput =
         this->TestHandler->AllTestMeasurementsRegex.match(1);
       // keep searching and replacing until none are left
@@ -775,6 +813,66 @@ void cmCTestRunTest::ParseOutputForMeasurements()
   }
 }
 
+void cmCTestRunTest::StartOutputSpool()
+{
+  this->OutputSpool.reset();
+  this->SpooledMeasurements.clear();
+  this->InSpooledMeasurement = false;
+  this->SpooledFullOutput = false;
+
+  cmCTestTestOptions const& options = this->TestHandler->TestOptions;
+  if (!options.OutputSpool || this->TestHandler->MemCheck ||
+      !this->TestProperties->RequiredRegularExpressions.empty() ||
+      !this->TestProperties->ErrorRegularExpressions.empty() ||
+      !this->TestProperties->SkipRegularExpressions.empty() ||
+      !this->TestProperties->TimeoutRegularExpressions.empty()) {
+    return;
+  }
+
+  // Keep enough output in memory to truncate it for the test results.
+  // If they keep all output, it is read back from the file.
+  std::size_t keep = static_cast<std::size_t>(
+    std::max(std::max(options.OutputSizePassed, options.OutputSizeFailed),
+             0));
+  if (keep == 0) {
+    keep = 1024 * 1024;
+  }
+
+  // Names that differ only in replaced characters are told apart by the
+  // number of the test.
+  std::string name = this->TestProperties->Name;
+  std::replace_if(
+    name.begin(), name.end(),
+    [](char c) {
+      return !(cmsysString_isalnum(c) || c == '.' || c == '-' || c == '_');
+    },
+    '_');
+  this->OutputSpool = cm::make_unique<cmCTestOutputSpool>(
+    cmStrCat(this->CTest->GetBinaryDir(), "/Testing/Temporary/TestOutput/",
+             this->Index, '-', name, ".log.gz"),
+    keep);
+}
+
+void cmCTestRunTest::FinishOutputSpool()
+{
+  if (!this->OutputSpool) {
+    return;
+  }
+  bool const passed =
+    this->TestResult.Status == cmCTestTestHandler::COMPLETED;
+  int const length = passed ? this->TestHandler->TestOptions.OutputSizePassed
+                            : this->TestHandler->TestOptions.OutputSizeFailed;
+  bool const complete = this->OutputSpool->Close();
+  if (complete && this->OutputSpool->IsTruncated() &&
+      (length == 0 || this->SpooledFullOutput)) {
+    // The test results keep all output.  Read it from the file.
+    this->TestResult.OutputFile = this->OutputSpool->GetFile();
+  } else if (passed || !complete) {
+    // Keep the output of tests that did not pass.
+    cmSystemTools::RemoveFile(this->OutputSpool->GetFile());
+  }
+}
+
 bool cmCTestRunTest::ForkProcess()
 {
   this->TestProcess->SetId(this->Index);
@@ -882,6 +980,8 @@ bool cmCTestRunTest::ForkProcess()
 
   this->TestProcess->SetEnvironment(env.GetVariables());
   this->TestResult.Environment = env.RecordDifference(originalEnvironment);
+  this->TestProcess->SetMeasureMemory(
+    this->TestHandler->TestOptions.TestMemoryLimit != 0);
   return this->TestProcess->StartProcess(*this->MultiTestHandler.Loop,
                                          &this->TestProperties->Affinity);
 }
@@ -13,6 +13,7 @@
 
 #include "cmCTest.h"
 #include "cmCTestMultiProcessHandler.h"
+#include "cmCTestOutputSpool.h"
 #include "cmCTestTestHandler.h"
 #include "cmProcess.h"
 
@@ -109,6 +110,10 @@ public:
 private:
   bool NeedsToRepeat();
   void ParseOutputForMeasurements();
+  // Spool the output of the test if it does not need all of its output
+  // in memory.
+  void StartOutputSpool();
+  void FinishOutputSpool();
   void ExeNotFound(std::string exe);
   bool ForkProcess();
   void WriteLogOutputTop(size_t completed, size_t total);
@@ -128,6 +133,12 @@ private:
 
   std::unique_ptr<cmProcess> TestProcess;
   std::string ProcessOutput;
+  std::unique_ptr<cmCTestOutputSpool> OutputSpool;
+  // Measurements found in spooled output, and whether the test asked
+  // for its full output.
+  std::string SpooledMeasurements;
+  bool InSpooledMeasurement = false;
+  bool SpooledFullOutput = false;
   cmCTestTestHandler::cmCTestTestResult TestResult;
   std::set<std::string> FailedDependencies;
   std::string StartTime;
@@ -14,6 +14,7 @@
 #include "cmCTest.h"
 #include "cmCTestGenericHandler.h"
 #include "cmCTestTestHandler.h"
+#include "cmCTestTypes.h"
 #include "cmDuration.h"
 #include "cmExecutionStatus.h"
 #include "cmMakefile.h"
@@ -69,6 +70,9 @@ std::unique_ptr<cmCTestGenericHandler> cmCTestTestCommand::InitializeHandler(
   if (!args.IncludeTestsFromFile.empty()) {
     handler->TestOptions.TestListFile = args.IncludeTestsFromFile;
   }
+  if (!args.AffectedBy.empty()) {
+    handler->TestOptions.AffectedByFile = args.AffectedBy;
+  }
 
   if (!args.ExcludeFixture.empty()) {
     handler->TestOptions.ExcludeFixtureRegularExpression = args.ExcludeFixture;
@@ -93,6 +97,46 @@ std::unique_ptr<cmCTestGenericHandler> cmCTestTestCommand::InitializeHandler(
   if (!args.ScheduleRandom.empty()) {
     handler->TestOptions.ScheduleRandom = cmValue(args.ScheduleRandom).IsOn();
   }
+  if (!args.ScheduleCriticalPath.empty()) {
+    handler->TestOptions.ScheduleCriticalPath =
+      cmValue(args.ScheduleCriticalPath).IsOn();
+  }
+  if (!args.TestHistory.empty()) {
+    handler->TestOptions.TestHistory = cmValue(args.TestHistory).IsOn();
+  }
+  if (!args.ShardCount.empty()) {
+    unsigned long shardCount;
+    if (cmStrToULong(args.ShardCount, &shardCount) && shardCount > 0) {
+      handler->TestOptions.ShardCount = shardCount;
+    } else {
+      cmCTestLog(this->CTest, WARNING,
+                 "Invalid value for 'SHARD_COUNT' : " << args.ShardCount
+                                                      << std::endl);
+    }
+  }
+  if (!args.ShardIndex.empty()) {
+    unsigned long shardIndex;
+    if (cmStrToULong(args.ShardIndex, &shardIndex)) {
+      handler->TestOptions.ShardIndex = shardIndex;
+    } else {
+      cmCTestLog(this->CTest, WARNING,
+                 "Invalid value for 'SHARD_INDEX' : " << args.ShardIndex
+                                                      << std::endl);
+    }
+  }
+  if (!args.TestMemoryLimit.empty()) {
+    unsigned long long limit;
+    if (cmCTestTypes::ParseMemorySize(args.TestMemoryLimit, limit)) {
+      handler->TestOptions.TestMemoryLimit = limit;
+    } else {
+      cmCTestLog(this->CTest, WARNING,
+                 "Invalid value for 'TEST_MEMORY_LIMIT' : "
+                   << args.TestMemoryLimit << std::endl);
+    }
+  }
+  if (!args.OutputSpool.empty()) {
+    handler->TestOptions.OutputSpool = cmValue(args.OutputSpool).IsOn();
+  }
   if (!args.ResourceSpecFile.empty()) {
     handler->TestOptions.ResourceSpecFile = args.ResourceSpecFile;
   }
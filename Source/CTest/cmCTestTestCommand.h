@@ -35,6 +35,7 @@ protected:
     std::string IncludeLabel;
     std::string IncludeTestsFromFile;
     std::string ExcludeTestsFromFile;
+    std::string AffectedBy;
     std::string ExcludeFixture;
     std::string ExcludeFixtureSetup;
     std::string ExcludeFixtureCleanup;
@@ -42,6 +43,12 @@ protected:
     std::string Repeat;
     std::string ScheduleRandom;
     std::string ScheduleRandomSeed;
+    std::string ScheduleCriticalPath;
+    std::string TestHistory;
+    std::string ShardCount;
+    std::string ShardIndex;
+    std::string TestMemoryLimit;
+    std::string OutputSpool;
     std::string StopTime;
     std::string TestLoad;
     std::string ResourceSpecFile;
@@ -63,6 +70,7 @@ protected:
       .Bind("INCLUDE_LABEL"_s, &TestArguments::IncludeLabel)
       .Bind("EXCLUDE_FROM_FILE"_s, &TestArguments::ExcludeTestsFromFile)
       .Bind("INCLUDE_FROM_FILE"_s, &TestArguments::IncludeTestsFromFile)
+      .Bind("AFFECTED_BY"_s, &TestArguments::AffectedBy)
       .Bind("EXCLUDE_FIXTURE"_s, &TestArguments::ExcludeFixture)
       .Bind("EXCLUDE_FIXTURE_SETUP"_s, &TestArguments::ExcludeFixtureSetup)
       .Bind("EXCLUDE_FIXTURE_CLEANUP"_s, &TestArguments::ExcludeFixtureCleanup)
@@ -70,6 +78,12 @@ protected:
       .Bind("REPEAT"_s, &TestArguments::Repeat)
       .Bind("SCHEDULE_RANDOM"_s, &TestArguments::ScheduleRandom)
       .Bind("SCHEDULE_RANDOM_SEED"_s, &TestArguments::ScheduleRandomSeed)
+      .Bind("SCHEDULE_CRITICAL_PATH"_s, &TestArguments::ScheduleCriticalPath)
+      .Bind("TEST_HISTORY"_s, &TestArguments::TestHistory)
+      .Bind("SHARD_COUNT"_s, &TestArguments::ShardCount)
+      .Bind("SHARD_INDEX"_s, &TestArguments::ShardIndex)
+      .Bind("TEST_MEMORY_LIMIT"_s, &TestArguments::TestMemoryLimit)
+      .Bind("OUTPUT_SPOOL"_s, &TestArguments::OutputSpool)
       .Bind("STOP_TIME"_s, &TestArguments::StopTime)
       .Bind("TEST_LOAD"_s, &TestArguments::TestLoad)
       .Bind("RESOURCE_SPEC_FILE"_s, &TestArguments::ResourceSpecFile)
@@ -27,6 +27,9 @@
 #include <cmext/algorithm>
 #include <cmext/string_view>
 
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+
 #include "cmsys/FStream.hxx"
 #include <cmsys/Base64.h>
 #include <cmsys/Directory.hxx>
@@ -38,7 +41,9 @@
 #include "cmCTest.h"
 #include "cmCTestDiscoverTests.h"
 #include "cmCTestMultiProcessHandler.h"
+#include "cmCTestOutputSpool.h"
 #include "cmCTestResourceGroupsLexerHelper.h"
+#include "cmCTestTestImpact.h"
 #include "cmCTestTestMeasurementXMLParser.h"
 #include "cmDuration.h"
 #include "cmExecutionStatus.h"
@@ -92,7 +97,54 @@ public:
   cmCTestTestHandler* TestHandler;
 };
 
-bool ReadSubdirectory(std::string fname, cmExecutionStatus& status)
+// Find the test file in the current working directory.
+char const* FindTestFile()
+{
+  if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
+    // does the CTestTestfile.cmake exist ?
+    return "CTestTestfile.cmake";
+  }
+  if (cmSystemTools::FileExists("DartTestfile.txt")) {
+    // does the DartTestfile.txt exist ?
+    return "DartTestfile.txt";
+  }
+  return nullptr;
+}
+
+// Read the manifest named in the header of a test file generated in the
+// current working directory.  Returns false if there is none or it is not
+// readable, in which case the test file must be evaluated.
+bool ReadTestManifest(std::string const& testFilename, Json::Value& manifest)
+{
+  cmsys::ifstream fin(testFilename.c_str(), std::ios::in | std::ios::binary);
+  std::string manifestFilename;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line) &&
+         cmHasLiteralPrefix(line, "#")) {
+    if (cmHasLiteralPrefix(line, "# Test manifest: ")) {
+      manifestFilename = line.substr(17);
+      break;
+    }
+  }
+  if (manifestFilename.empty()) {
+    return false;
+  }
+
+  cmsys::ifstream mfin(manifestFilename.c_str(),
+                       std::ios::in | std::ios::binary);
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  if (!mfin || !Json::parseFromStream(builder, mfin, &manifest, &errors) ||
+      !manifest.isObject()) {
+    return false;
+  }
+  Json::Value const& version = manifest["version"];
+  return version.isObject() && version["major"].isInt() &&
+    version["major"].asInt() == 1;
+}
+
+bool ReadSubdirectory(std::string fname, cmMakefile& mf,
+                      cmCTestTestHandler* handler, std::string& error)
 {
   if (!cmSystemTools::FileExists(fname)) {
     // No subdirectory? So what...
@@ -102,33 +154,39 @@ bool ReadSubdirectory(std::string fname, cmExecutionStatus& status)
   {
     cmWorkingDirectory workdir(fname);
     if (workdir.Failed()) {
-      status.SetError(workdir.GetError());
+      error = workdir.GetError();
       return false;
     }
-    char const* testFilename;
-    if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
-      // does the CTestTestfile.cmake exist ?
-      testFilename = "CTestTestfile.cmake";
-    } else if (cmSystemTools::FileExists("DartTestfile.txt")) {
-      // does the DartTestfile.txt exist ?
-      testFilename = "DartTestfile.txt";
-    } else {
+    char const* testFilename = FindTestFile();
+    if (!testFilename) {
       // No CTestTestfile? Who cares...
       return true;
     }
+    Json::Value manifest;
+    if (ReadTestManifest(testFilename, manifest)) {
+      return handler->AddTestsFromManifest(manifest, mf);
+    }
     fname += "/";
     fname += testFilename;
-    readit = status.GetMakefile().ReadDependentFile(fname);
+    readit = mf.ReadDependentFile(fname);
   }
   if (!readit) {
-    status.SetError(cmStrCat("Could not find include file: ", fname));
+    error = cmStrCat("Could not find include file: ", fname);
     return false;
   }
   return true;
 }
 
-bool cmCTestSubdirCommand(std::vector<std::string> const& args,
-                          cmExecutionStatus& status)
+class cmCTestSubdirCommand : public cmCTestCommand
+{
+public:
+  using cmCTestCommand::cmCTestCommand;
+  bool InitialPass(std::vector<std::string> const& args,
+                   cmExecutionStatus& status) override;
+};
+
+bool cmCTestSubdirCommand::InitialPass(std::vector<std::string> const& args,
+                                       cmExecutionStatus& status)
 {
   if (args.empty()) {
     status.SetError("called with incorrect number of arguments");
@@ -144,15 +202,28 @@ bool cmCTestSubdirCommand(std::vector<std::string> const& args,
       fname = cmStrCat(cwd, '/', arg);
     }
 
-    if (!ReadSubdirectory(std::move(fname), status)) {
+    std::string error;
+    if (!ReadSubdirectory(std::move(fname), status.GetMakefile(),
+                          this->TestHandler, error)) {
+      if (!error.empty()) {
+        status.SetError(error);
+      }
       return false;
     }
   }
   return true;
 }
 
-bool cmCTestAddSubdirectoryCommand(std::vector<std::string> const& args,
-                                   cmExecutionStatus& status)
+class cmCTestAddSubdirectoryCommand : public cmCTestCommand
+{
+public:
+  using cmCTestCommand::cmCTestCommand;
+  bool InitialPass(std::vector<std::string> const& args,
+                   cmExecutionStatus& status) override;
+};
+
+bool cmCTestAddSubdirectoryCommand::InitialPass(
+  std::vector<std::string> const& args, cmExecutionStatus& status)
 {
   if (args.empty()) {
     status.SetError("called with incorrect number of arguments");
@@ -162,7 +233,15 @@ bool cmCTestAddSubdirectoryCommand(std::vector<std::string> const& args,
   std::string fname =
     cmStrCat(cmSystemTools::GetLogicalWorkingDirectory(), '/', args[0]);
 
-  return ReadSubdirectory(std::move(fname), status);
+  std::string error;
+  if (!ReadSubdirectory(std::move(fname), status.GetMakefile(),
+                        this->TestHandler, error)) {
+    if (!error.empty()) {
+      status.SetError(error);
+    }
+    return false;
+  }
+  return true;
 }
 
 class cmCTestAddTestCommand : public cmCTestCommand
@@ -501,6 +580,21 @@ bool cmCTestTestHandler::ProcessOptions()
   this->SetTestsToRunInformation(this->TestOptions.TestsToRunInformation);
   if (this->TestOptions.ScheduleRandom) {
     this->CTest->SetScheduleType("Random");
+  } else if (this->TestOptions.ScheduleCriticalPath) {
+    this->CTest->SetScheduleType("CriticalPath");
+  }
+  if (this->TestOptions.ShardIndex >= this->TestOptions.ShardCount) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Shard index " << this->TestOptions.ShardIndex
+                              << " is not less than the shard count "
+                              << this->TestOptions.ShardCount << std::endl);
+    return false;
+  }
+  if (this->TestOptions.ShardCount > 1 && this->TestOptions.ScheduleRandom) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "Tests cannot be split into shards with a random schedule"
+                 << std::endl);
+    return false;
   }
   if (auto repeat = this->Repeat) {
     cmsys::RegularExpression repeatRegex(
@@ -941,6 +1035,10 @@ bool cmCTestTestHandler::ComputeTestList()
       }
     }
 
+    if (this->TestImpact && !this->TestImpact->IsAffected(tp.Name)) {
+      continue;
+    }
+
     tp.Index = cnt; // save the index into the test list for this test
     finalList.push_back(tp);
   }
@@ -1521,13 +1619,18 @@ void cmCTestTestHandler::GenerateCTestXML(cmXMLWriter& xml)
       xml.Element("Value", measure.second);
       xml.EndElement(); // NamedMeasurement
     }
+    std::string spooledOutput;
+    bool compress = result.CompressOutput;
+    bool const spooled = this->ReadSpooledOutput(
+      result, spooledOutput,
+      this->CTest->ShouldCompressTestOutput() ? &compress : nullptr);
     xml.StartElement("Measurement");
     xml.StartElement("Value");
-    if (result.CompressOutput) {
+    if (compress) {
       xml.Attribute("encoding", "base64");
       xml.Attribute("compression", "gzip");
     }
-    xml.Content(result.Output);
+    xml.Content(spooled ? spooledOutput : result.Output);
     xml.EndElement(); // Value
     xml.EndElement(); // Measurement
 
@@ -1817,11 +1920,11 @@ bool cmCTestTestHandler::GetListOfTests()
                                    cmCTestDiscoverTestsCommand(this));
 
   // Add handler for SUBDIRS
-  cm.GetState()->AddBuiltinCommand("subdirs", cmCTestSubdirCommand);
+  cm.GetState()->AddBuiltinCommand("subdirs", cmCTestSubdirCommand(this));
 
   // Add handler for ADD_SUBDIRECTORY
   cm.GetState()->AddBuiltinCommand("add_subdirectory",
-                                   cmCTestAddSubdirectoryCommand);
+                                   cmCTestAddSubdirectoryCommand(this));
 
   // Add handler for SET_TESTS_PROPERTIES
   cm.GetState()->AddBuiltinCommand("set_tests_properties",
@@ -1832,18 +1935,19 @@ bool cmCTestTestHandler::GetListOfTests()
   cm.GetState()->AddBuiltinCommand("set_directory_properties",
                                    cmCTestSetDirectoryPropertiesCommand(this));
 
-  char const* testFilename;
-  if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
-    // does the CTestTestfile.cmake exist ?
-    testFilename = "CTestTestfile.cmake";
-  } else if (cmSystemTools::FileExists("DartTestfile.txt")) {
-    // does the DartTestfile.txt exist ?
-    testFilename = "DartTestfile.txt";
-  } else {
+  char const* testFilename = FindTestFile();
+  if (!testFilename) {
     return true;
   }
 
-  if (!mf.ReadListFile(testFilename)) {
+  // Load the tests from the manifest generated with the test file, if
+  // any, rather than evaluating it.
+  Json::Value manifest;
+  if (ReadTestManifest(testFilename, manifest)) {
+    if (!this->AddTestsFromManifest(manifest, mf)) {
+      return false;
+    }
+  } else if (!mf.ReadListFile(testFilename)) {
     return false;
   }
   if (cmSystemTools::GetErrorOccurredFlag()) {
@@ -1869,6 +1973,14 @@ bool cmCTestTestHandler::GetListOfTests()
       return false;
     }
   }
+  if (!this->TestOptions.AffectedByFile.empty() && !this->LoadTestImpact()) {
+    return false;
+  }
+
+  // Every discovery command has run.  The other files of the discovery
+  // output cache may belong to other configurations or test selections,
+  // so only those whose input files no longer exist are removed.
+  cmCTestPruneDiscoveryCache(this->CTest, this->DiscoveryCacheFiles);
 
   cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                      "Done constructing a list of tests" << std::endl,
@@ -2057,6 +2169,35 @@ cm::optional<std::set<std::string>> cmCTestTestHandler::ReadTestListFile(
   return result;
 }
 
+bool cmCTestTestHandler::LoadTestImpact()
+{
+  this->TestImpact = cm::nullopt;
+  cm::optional<std::set<std::string>> changedFiles =
+    this->ReadTestListFile(this->TestOptions.AffectedByFile);
+  if (!changedFiles) {
+    return false;
+  }
+
+  std::string const index =
+    cmCTestTestImpact::FindIndex(this->CTest->GetBinaryDir());
+  if (index.empty()) {
+    cmCTestLog(this->CTest, WARNING,
+               "No test impact index found for "
+                 << this->CTest->GetBinaryDir()
+                 << ".  Running all tests." << std::endl);
+    return true;
+  }
+  cmCTestTestImpact impact;
+  std::string error;
+  if (!impact.Load(index, error)) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, error << std::endl);
+    return false;
+  }
+  impact.Select(*changedFiles);
+  this->TestImpact = std::move(impact);
+  return true;
+}
+
 void cmCTestTestHandler::RecordCustomTestMeasurements(cmXMLWriter& xml,
                                                       std::string content)
 {
@@ -2152,6 +2293,25 @@ void cmCTestTestHandler::SetTestsToRunInformation(std::string const& in)
   }
 }
 
+bool cmCTestTestHandler::ReadSpooledOutput(cmCTestTestResult const& result,
+                                           std::string& output,
+                                           bool* compress)
+{
+  if (result.OutputFile.empty() ||
+      !cmCTestOutputSpool::Read(result.OutputFile, output)) {
+    return false;
+  }
+  if (compress) {
+    std::string compressed = output;
+    *compress = this->CTest->CompressString(compressed) &&
+      compressed.size() < output.size();
+    if (*compress) {
+      output = std::move(compressed);
+    }
+  }
+  return true;
+}
+
 void cmCTestTestHandler::CleanTestOutput(std::string& output, size_t length,
                                          cmCTestTypes::TruncationMode truncate)
 {
@@ -2242,186 +2402,191 @@ bool cmCTestTestHandler::SetTestsProperties(
     std::string const& val = *it;
     for (std::string const& t : tests) {
       for (cmCTestTestProperties& rt : this->TestList) {
-        if (t == rt.Name) {
-          if (key == "_BACKTRACE_TRIPLES"_s) {
-            // allow empty args in the triples
-            cmList triples{ val, cmList::EmptyElements::Yes };
-
-            // Ensure we have complete triples otherwise the data is corrupt.
-            if (triples.size() % 3 == 0) {
-              cmState state(cmState::Role::Internal);
-              rt.Backtrace = cmListFileBacktrace();
-
-              // the first entry represents the top of the trace so we need to
-              // reconstruct the backtrace in reverse
-              for (auto i = triples.size(); i >= 3; i -= 3) {
-                cmListFileContext fc;
-                fc.FilePath = triples[i - 3];
-                long line = 0;
-                if (!cmStrToLong(triples[i - 2], &line)) {
-                  line = 0;
-                }
-                fc.Line = line;
-                fc.Name = triples[i - 1];
-                rt.Backtrace = rt.Backtrace.Push(fc);
-              }
-            }
-          } else if (key == "WILL_FAIL"_s) {
-            rt.WillFail = cmIsOn(val);
-          } else if (key == "DISABLED"_s) {
-            rt.Disabled = cmIsOn(val);
-          } else if (key == "ATTACHED_FILES"_s) {
-            cmExpandList(val, rt.AttachedFiles);
-          } else if (key == "ATTACHED_FILES_ON_FAIL"_s) {
-            cmExpandList(val, rt.AttachOnFail);
-          } else if (key == "RESOURCE_LOCK"_s) {
-            cmList lval{ val };
-
-            rt.ProjectResources.insert(lval.begin(), lval.end());
-          } else if (key == "FIXTURES_SETUP"_s) {
-            cmList lval{ val };
-
-            rt.FixturesSetup.insert(lval.begin(), lval.end());
-          } else if (key == "FIXTURES_CLEANUP"_s) {
-            cmList lval{ val };
-
-            rt.FixturesCleanup.insert(lval.begin(), lval.end());
-          } else if (key == "FIXTURES_REQUIRED"_s) {
-            cmList lval{ val };
-
-            rt.FixturesRequired.insert(lval.begin(), lval.end());
-          } else if (key == "TIMEOUT"_s) {
-            rt.Timeout = cmDuration(atof(val.c_str()));
-          } else if (key == "TIMEOUT_SIGNAL_NAME"_s) {
+        if (t == rt.Name && !this->SetTestProperty(rt, key, val)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool cmCTestTestHandler::SetTestProperty(cmCTestTestProperties& rt,
+                                         std::string const& key,
+                                         std::string const& val)
+{
+  if (key == "_BACKTRACE_TRIPLES"_s) {
+    // allow empty args in the triples
+    cmList triples{ val, cmList::EmptyElements::Yes };
+
+    // Ensure we have complete triples otherwise the data is corrupt.
+    if (triples.size() % 3 == 0) {
+      rt.Backtrace = cmListFileBacktrace();
+
+      // the first entry represents the top of the trace so we need to
+      // reconstruct the backtrace in reverse
+      for (auto i = triples.size(); i >= 3; i -= 3) {
+        cmListFileContext fc;
+        fc.FilePath = triples[i - 3];
+        long line = 0;
+        if (!cmStrToLong(triples[i - 2], &line)) {
+          line = 0;
+        }
+        fc.Line = line;
+        fc.Name = triples[i - 1];
+        rt.Backtrace = rt.Backtrace.Push(fc);
+      }
+    }
+  } else if (key == "WILL_FAIL"_s) {
+    rt.WillFail = cmIsOn(val);
+  } else if (key == "DISABLED"_s) {
+    rt.Disabled = cmIsOn(val);
+  } else if (key == "ATTACHED_FILES"_s) {
+    cmExpandList(val, rt.AttachedFiles);
+  } else if (key == "ATTACHED_FILES_ON_FAIL"_s) {
+    cmExpandList(val, rt.AttachOnFail);
+  } else if (key == "RESOURCE_LOCK"_s) {
+    cmList lval{ val };
+
+    rt.ProjectResources.insert(lval.begin(), lval.end());
+  } else if (key == "FIXTURES_SETUP"_s) {
+    cmList lval{ val };
+
+    rt.FixturesSetup.insert(lval.begin(), lval.end());
+  } else if (key == "FIXTURES_CLEANUP"_s) {
+    cmList lval{ val };
+
+    rt.FixturesCleanup.insert(lval.begin(), lval.end());
+  } else if (key == "FIXTURES_REQUIRED"_s) {
+    cmList lval{ val };
+
+    rt.FixturesRequired.insert(lval.begin(), lval.end());
+  } else if (key == "TIMEOUT"_s) {
+    rt.Timeout = cmDuration(atof(val.c_str()));
+  } else if (key == "TIMEOUT_SIGNAL_NAME"_s) {
 #ifdef _WIN32
-            rt.AppendError("TIMEOUT_SIGNAL_NAME is not supported on Windows.");
+    rt.AppendError("TIMEOUT_SIGNAL_NAME is not supported on Windows.");
 #else
-            std::string const& signalName = val;
-            Signal s;
-            if (signalName == "SIGINT"_s) {
-              s.Number = SIGINT;
-            } else if (signalName == "SIGQUIT"_s) {
-              s.Number = SIGQUIT;
-            } else if (signalName == "SIGTERM"_s) {
-              s.Number = SIGTERM;
-            } else if (signalName == "SIGUSR1"_s) {
-              s.Number = SIGUSR1;
-            } else if (signalName == "SIGUSR2"_s) {
-              s.Number = SIGUSR2;
-            }
-            if (s.Number) {
-              s.Name = signalName;
-              rt.TimeoutSignal = std::move(s);
-            } else {
-              rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_NAME \"", signalName,
-                                      "\" not supported on this platform."));
-            }
+    std::string const& signalName = val;
+    Signal s;
+    if (signalName == "SIGINT"_s) {
+      s.Number = SIGINT;
+    } else if (signalName == "SIGQUIT"_s) {
+      s.Number = SIGQUIT;
+    } else if (signalName == "SIGTERM"_s) {
+      s.Number = SIGTERM;
+    } else if (signalName == "SIGUSR1"_s) {
+      s.Number = SIGUSR1;
+    } else if (signalName == "SIGUSR2"_s) {
+      s.Number = SIGUSR2;
+    }
+    if (s.Number) {
+      s.Name = signalName;
+      rt.TimeoutSignal = std::move(s);
+    } else {
+      rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_NAME \"", signalName,
+                              "\" not supported on this platform."));
+    }
 #endif
-          } else if (key == "TIMEOUT_SIGNAL_GRACE_PERIOD"_s) {
+  } else if (key == "TIMEOUT_SIGNAL_GRACE_PERIOD"_s) {
 #ifdef _WIN32
-            rt.AppendError(
-              "TIMEOUT_SIGNAL_GRACE_PERIOD is not supported on Windows.");
+    rt.AppendError("TIMEOUT_SIGNAL_GRACE_PERIOD is not supported on Windows.");
 #else
-            std::string const& gracePeriod = val;
-            static cmDuration minGracePeriod{ 0 };
-            static cmDuration maxGracePeriod{ 60 };
-            cmDuration gp = cmDuration(atof(gracePeriod.c_str()));
-            if (gp <= minGracePeriod) {
-              rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_GRACE_PERIOD \"",
-                                      gracePeriod, "\" is not greater than \"",
-                                      minGracePeriod.count(), "\" seconds."));
-            } else if (gp > maxGracePeriod) {
-              rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_GRACE_PERIOD \"",
-                                      gracePeriod,
-                                      "\" is not less than the maximum of \"",
-                                      maxGracePeriod.count(), "\" seconds."));
-            } else {
-              rt.TimeoutGracePeriod = gp;
-            }
+    std::string const& gracePeriod = val;
+    static cmDuration minGracePeriod{ 0 };
+    static cmDuration maxGracePeriod{ 60 };
+    cmDuration gp = cmDuration(atof(gracePeriod.c_str()));
+    if (gp <= minGracePeriod) {
+      rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_GRACE_PERIOD \"", gracePeriod,
+                              "\" is not greater than \"",
+                              minGracePeriod.count(), "\" seconds."));
+    } else if (gp > maxGracePeriod) {
+      rt.AppendError(cmStrCat("TIMEOUT_SIGNAL_GRACE_PERIOD \"", gracePeriod,
+                              "\" is not less than the maximum of \"",
+                              maxGracePeriod.count(), "\" seconds."));
+    } else {
+      rt.TimeoutGracePeriod = gp;
+    }
 #endif
-          } else if (key == "COST"_s) {
-            rt.Cost = static_cast<float>(atof(val.c_str()));
-          } else if (key == "REQUIRED_FILES"_s) {
-            cmExpandList(val, rt.RequiredFiles);
-          } else if (key == "RUN_SERIAL"_s) {
-            rt.RunSerial = cmIsOn(val);
-          } else if (key == "FAIL_REGULAR_EXPRESSION"_s) {
-            cmList lval{ val };
-            for (std::string const& cr : lval) {
-              rt.ErrorRegularExpressions.emplace_back(cr, cr);
-            }
-          } else if (key == "SKIP_REGULAR_EXPRESSION"_s) {
-            cmList lval{ val };
-            for (std::string const& cr : lval) {
-              rt.SkipRegularExpressions.emplace_back(cr, cr);
-            }
-          } else if (key == "PROCESSORS"_s) {
-            rt.Processors = atoi(val.c_str());
-            if (rt.Processors < 1) {
-              rt.Processors = 1;
-            }
-          } else if (key == "PROCESSOR_AFFINITY"_s) {
-            rt.WantAffinity = cmIsOn(val);
-          } else if (key == "RESOURCE_GROUPS"_s) {
-            if (!ParseResourceGroupsProperty(val, rt.ResourceGroups)) {
-              return false;
-            }
-          } else if (key == "GENERATED_RESOURCE_SPEC_FILE"_s) {
-            rt.GeneratedResourceSpecFile = val;
-          } else if (key == "SKIP_RETURN_CODE"_s) {
-            rt.SkipReturnCode = atoi(val.c_str());
-            if (rt.SkipReturnCode < 0 || rt.SkipReturnCode > 255) {
-              rt.SkipReturnCode = -1;
-            }
-          } else if (key == "DEPENDS"_s) {
-            cmExpandList(val, rt.Depends);
-          } else if (key == "ENVIRONMENT"_s) {
-            cmExpandList(val, rt.Environment);
-          } else if (key == "ENVIRONMENT_MODIFICATION"_s) {
-            cmExpandList(val, rt.EnvironmentModification);
-          } else if (key == "LABELS"_s) {
-            cmList Labels{ val };
-            rt.Labels.insert(rt.Labels.end(), Labels.begin(), Labels.end());
-            // sort the array
-            std::sort(rt.Labels.begin(), rt.Labels.end());
-            // remove duplicates
-            auto new_end = std::unique(rt.Labels.begin(), rt.Labels.end());
-            rt.Labels.erase(new_end, rt.Labels.end());
-          } else if (key == "MEASUREMENT"_s) {
-            size_t pos = val.find_first_of('=');
-            if (pos != std::string::npos) {
-              std::string mKey = val.substr(0, pos);
-              std::string mVal = val.substr(pos + 1);
-              rt.Measurements[mKey] = std::move(mVal);
-            } else {
-              rt.Measurements[val] = "1";
-            }
-          } else if (key == "PASS_REGULAR_EXPRESSION"_s) {
-            cmList lval{ val };
-            for (std::string const& cr : lval) {
-              rt.RequiredRegularExpressions.emplace_back(cr, cr);
-            }
-          } else if (key == "WORKING_DIRECTORY"_s) {
-            rt.Directory = val;
-          } else if (key == "TIMEOUT_AFTER_MATCH"_s) {
-            cmList propArgs{ val };
-            if (propArgs.size() != 2) {
-              cmCTestLog(this->CTest, WARNING,
-                         "TIMEOUT_AFTER_MATCH expects two arguments, found "
-                           << propArgs.size() << std::endl);
-            } else {
-              rt.AlternateTimeout = cmDuration(atof(propArgs[0].c_str()));
-              cmList lval{ propArgs[1] };
-              for (std::string const& cr : lval) {
-                rt.TimeoutRegularExpressions.emplace_back(cr, cr);
-              }
-            }
-          } else {
-            rt.CustomProperties[key] = val;
-          }
-        }
+  } else if (key == "COST"_s) {
+    rt.Cost = static_cast<float>(atof(val.c_str()));
+  } else if (key == "REQUIRED_FILES"_s) {
+    cmExpandList(val, rt.RequiredFiles);
+  } else if (key == "RUN_SERIAL"_s) {
+    rt.RunSerial = cmIsOn(val);
+  } else if (key == "FAIL_REGULAR_EXPRESSION"_s) {
+    cmList lval{ val };
+    for (std::string const& cr : lval) {
+      rt.ErrorRegularExpressions.emplace_back(cr, cr);
+    }
+  } else if (key == "SKIP_REGULAR_EXPRESSION"_s) {
+    cmList lval{ val };
+    for (std::string const& cr : lval) {
+      rt.SkipRegularExpressions.emplace_back(cr, cr);
+    }
+  } else if (key == "PROCESSORS"_s) {
+    rt.Processors = atoi(val.c_str());
+    if (rt.Processors < 1) {
+      rt.Processors = 1;
+    }
+  } else if (key == "PROCESSOR_AFFINITY"_s) {
+    rt.WantAffinity = cmIsOn(val);
+  } else if (key == "RESOURCE_GROUPS"_s) {
+    if (!ParseResourceGroupsProperty(val, rt.ResourceGroups)) {
+      return false;
+    }
+  } else if (key == "GENERATED_RESOURCE_SPEC_FILE"_s) {
+    rt.GeneratedResourceSpecFile = val;
+  } else if (key == "SKIP_RETURN_CODE"_s) {
+    rt.SkipReturnCode = atoi(val.c_str());
+    if (rt.SkipReturnCode < 0 || rt.SkipReturnCode > 255) {
+      rt.SkipReturnCode = -1;
+    }
+  } else if (key == "DEPENDS"_s) {
+    cmExpandList(val, rt.Depends);
+  } else if (key == "ENVIRONMENT"_s) {
+    cmExpandList(val, rt.Environment);
+  } else if (key == "ENVIRONMENT_MODIFICATION"_s) {
+    cmExpandList(val, rt.EnvironmentModification);
+  } else if (key == "LABELS"_s) {
+    cmList Labels{ val };
+    rt.Labels.insert(rt.Labels.end(), Labels.begin(), Labels.end());
+    // sort the array
+    std::sort(rt.Labels.begin(), rt.Labels.end());
+    // remove duplicates
+    auto new_end = std::unique(rt.Labels.begin(), rt.Labels.end());
+    rt.Labels.erase(new_end, rt.Labels.end());
+  } else if (key == "MEASUREMENT"_s) {
+    size_t pos = val.find_first_of('=');
+    if (pos != std::string::npos) {
+      std::string mKey = val.substr(0, pos);
+      std::string mVal = val.substr(pos + 1);
+      rt.Measurements[mKey] = std::move(mVal);
+    } else {
+      rt.Measurements[val] = "1";
+    }
+  } else if (key == "PASS_REGULAR_EXPRESSION"_s) {
+    cmList lval{ val };
+    for (std::string const& cr : lval) {
+      rt.RequiredRegularExpressions.emplace_back(cr, cr);
+    }
+  } else if (key == "WORKING_DIRECTORY"_s) {
+    rt.Directory = val;
+  } else if (key == "TIMEOUT_AFTER_MATCH"_s) {
+    cmList propArgs{ val };
+    if (propArgs.size() != 2) {
+      cmCTestLog(this->CTest, WARNING,
+                 "TIMEOUT_AFTER_MATCH expects two arguments, found "
+                   << propArgs.size() << std::endl);
+    } else {
+      rt.AlternateTimeout = cmDuration(atof(propArgs[0].c_str()));
+      cmList lval{ propArgs[1] };
+      for (std::string const& cr : lval) {
+        rt.TimeoutRegularExpressions.emplace_back(cr, cr);
       }
     }
+  } else {
+    rt.CustomProperties[key] = val;
   }
   return true;
 }
@@ -2471,6 +2636,100 @@ bool cmCTestTestHandler::SetDirectoryProperties(
   return true;
 }
 
+bool cmCTestTestHandler::AddTestsFromManifest(Json::Value const& manifest,
+                                              cmMakefile& mf)
+{
+  auto getString = [](Json::Value const& value) -> std::string {
+    return value.isString() ? value.asString() : std::string();
+  };
+
+  std::string const resourceSpecFile =
+    getString(manifest["resourceSpecFile"]);
+  if (!resourceSpecFile.empty()) {
+    mf.AddDefinition("CTEST_RESOURCE_SPEC_FILE", resourceSpecFile);
+  }
+
+  // Select the variant of each test for the configuration being tested,
+  // as the generated test file does.
+  std::string const config =
+    cmSystemTools::UpperCase(mf.GetSafeDefinition("CTEST_CONFIGURATION_TYPE"));
+  auto matches = [&config, &getString](Json::Value const& configs) -> bool {
+    return !configs.isArray() ||
+      std::any_of(configs.begin(), configs.end(),
+                  [&config, &getString](Json::Value const& c) {
+                    return cmSystemTools::UpperCase(getString(c)) == config;
+                  });
+  };
+  for (Json::Value const& test : manifest["tests"]) {
+    Json::Value const* variant = nullptr;
+    for (Json::Value const& v : test["variants"]) {
+      if (matches(v["configurations"])) {
+        variant = &v;
+        break;
+      }
+    }
+
+    std::vector<std::string> args{ getString(test["name"]) };
+    if (variant) {
+      for (Json::Value const& arg : (*variant)["command"]) {
+        args.emplace_back(getString(arg));
+      }
+    } else if (test["notAvailable"].isBool() &&
+               test["notAvailable"].asBool()) {
+      args.emplace_back("NOT_AVAILABLE");
+    } else {
+      continue;
+    }
+    if (args.size() < 2) {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+                 "Test \"" << args[0] << "\" has no command in manifest of "
+                           << cmSystemTools::GetLogicalWorkingDirectory()
+                           << std::endl);
+      return false;
+    }
+
+    // The properties apply only to the test just added, if it was.
+    std::size_t const count = this->TestList.size();
+    if (!this->AddTest(args)) {
+      return false;
+    }
+    if (variant && this->TestList.size() > count) {
+      cmCTestTestProperties& rt = this->TestList.back();
+      for (Json::Value const& p : (*variant)["properties"]) {
+        if (p.isArray() && p.size() == 2 &&
+            !this->SetTestProperty(rt, getString(p[0]), getString(p[1]))) {
+          return false;
+        }
+      }
+    }
+  }
+
+  std::string const cwd = cmSystemTools::GetLogicalWorkingDirectory();
+  for (Json::Value const& subdir : manifest["subdirectories"]) {
+    std::string fname = getString(subdir);
+    if (!cmSystemTools::FileIsFullPath(fname)) {
+      fname = cmStrCat(cwd, '/', fname);
+    }
+    std::string error;
+    if (!ReadSubdirectory(std::move(fname), mf, this, error)) {
+      if (!error.empty()) {
+        cmCTestLog(this->CTest, ERROR_MESSAGE, error << std::endl);
+      }
+      return false;
+    }
+  }
+
+  Json::Value const& labels = manifest["labels"];
+  if (labels.isArray() && !labels.empty()) {
+    cmList list;
+    for (Json::Value const& label : labels) {
+      list.emplace_back(getString(label));
+    }
+    this->SetDirectoryProperties({ "PROPERTIES", "LABELS", list.to_string() });
+  }
+  return true;
+}
+
 bool cmCTestTestHandler::AddTest(std::vector<std::string> const& args)
 {
   std::string const& testname = args[0];
@@ -2598,6 +2857,20 @@ bool cmCTestTestHandler::WriteJUnitXML()
                 cmts.CreateTimestampFromTimeT(start_test_time_t,
                                               "%Y-%m-%dT%H:%M:%S", false));
 
+  // Identify the shard so that the reports of all shards can be merged.
+  if (this->TestOptions.ShardCount > 1) {
+    xml.StartElement("properties");
+    xml.StartElement("property");
+    xml.Attribute("name", "cmake_shard_index");
+    xml.Attribute("value", this->TestOptions.ShardIndex);
+    xml.EndElement(); // </property>
+    xml.StartElement("property");
+    xml.Attribute("name", "cmake_shard_count");
+    xml.Attribute("value", this->TestOptions.ShardCount);
+    xml.EndElement(); // </property>
+    xml.EndElement(); // </properties>
+  }
+
   // Write <testcase> elements.
   for (cmCTestTestResult const& result : resultsSet) {
     xml.StartElement("testcase");
@@ -2646,7 +2919,11 @@ bool cmCTestTestHandler::WriteJUnitXML()
 
     // Note: compressed test output is unconditionally disabled when
     // --output-junit is specified.
-    xml.Element("system-out", result.Output);
+    std::string spooledOutput;
+    xml.Element("system-out",
+                this->ReadSpooledOutput(result, spooledOutput, nullptr)
+                  ? spooledOutput
+                  : result.Output);
     xml.EndElement(); // </testcase>
   }
 
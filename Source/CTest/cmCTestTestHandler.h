@@ -21,19 +21,34 @@
 
 #include "cmCTest.h"
 #include "cmCTestGenericHandler.h"
+#include "cmCTestTestImpact.h"
 #include "cmCTestTypes.h" // IWYU pragma: keep
 #include "cmDuration.h"
 #include "cmListFileCache.h"
 
+class cmMakefile;
 class cmXMLWriter;
 
+namespace Json {
+class Value;
+}
+
 struct cmCTestTestOptions
 {
   bool RerunFailed = false;
   bool ScheduleRandom = false;
+  bool ScheduleCriticalPath = false;
+  bool TestHistory = false;
   bool StopOnFailure = false;
   bool UseUnion = false;
   cm::optional<unsigned int> ScheduleRandomSeed;
+  unsigned long ShardCount = 1;
+  unsigned long ShardIndex = 0;
+  // Budget of expected peak memory of running tests in KiB, or 0.
+  unsigned long long TestMemoryLimit = 0;
+  // Write test output to files as it arrives, keeping only part of it
+  // in memory.
+  bool OutputSpool = false;
 
   int OutputSizePassed = 1 * 1024;
   int OutputSizeFailed = 300 * 1024;
@@ -53,6 +68,7 @@ struct cmCTestTestOptions
 
   std::string TestListFile;
   std::string ExcludeTestListFile;
+  std::string AffectedByFile;
   std::string ResourceSpecFile;
   std::string JUnitXMLFileName;
 
@@ -110,6 +126,21 @@ public:
    */
   bool SetDirectoryProperties(std::vector<std::string> const& args);
 
+  /**
+   * Add the tests of a directory and its subdirectories from the manifest
+   * generated with its test file, as evaluating the test file would.
+   */
+  bool AddTestsFromManifest(Json::Value const& manifest, cmMakefile& mf);
+
+  /**
+   * Record a file of the discovery output cache used while constructing
+   * the list of tests, so that the files of other commands are pruned.
+   */
+  void AddDiscoveryCacheFile(std::string file)
+  {
+    this->DiscoveryCacheFiles.emplace(std::move(file));
+  }
+
   struct cmCTestTestResourceRequirement
   {
     std::string ResourceType;
@@ -152,6 +183,10 @@ public:
     bool Disabled = false;
     float Cost = 0;
     int PreviousRuns = 0;
+    // Peak resident memory in KiB recorded by a previous run, and
+    // measured by this one.
+    unsigned long long ExpectedMemory = 0;
+    unsigned long long PeakMemory = 0;
     bool RunSerial = false;
     cm::optional<cmDuration> Timeout;
     cm::optional<Signal> TimeoutSignal;
@@ -193,6 +228,9 @@ public:
     std::string CompletionStatus;
     std::string CustomCompletionStatus;
     std::string Output;
+    // Spool file holding the whole output, when Output holds only part
+    // of output that must be kept whole.
+    std::string OutputFile;
     std::string TestMeasurementsOutput;
     std::string InstrumentationFile;
     int TestCount = 0;
@@ -231,6 +269,11 @@ public:
   // Support for writing test results in JUnit XML format.
   void SetJUnitXMLFileName(std::string const& id);
 
+  // Read the whole output of a test from its spool file, compressing it
+  // if requested and smaller.  Returns false if it has no spool file.
+  bool ReadSpooledOutput(cmCTestTestResult const& result, std::string& output,
+                         bool* compress);
+
 protected:
   using SetOfTests =
     std::set<cmCTestTestHandler::cmCTestTestResult, cmCTestTestResultLess>;
@@ -332,6 +375,9 @@ private:
 
   void UpdateMaxTestNameWidth();
 
+  bool SetTestProperty(cmCTestTestProperties& rt, std::string const& key,
+                       std::string const& val);
+
   bool GetValue(char const* tag, std::string& value, std::istream& fin);
   bool GetValue(char const* tag, int& value, std::istream& fin);
   bool GetValue(char const* tag, size_t& value, std::istream& fin);
@@ -347,6 +393,7 @@ private:
   void ExpandTestsToRunInformationForRerunFailed();
   cm::optional<std::set<std::string>> ReadTestListFile(
     std::string const& testListFileName) const;
+  bool LoadTestImpact();
 
   std::vector<std::string> CustomPreTest;
   std::vector<std::string> CustomPostTest;
@@ -362,6 +409,8 @@ private:
   cmsys::RegularExpression ExcludeTestsRegularExpression;
   cm::optional<std::set<std::string>> TestsToRunByName;
   cm::optional<std::set<std::string>> TestsToExcludeByName;
+  cm::optional<cmCTestTestImpact> TestImpact;
+  std::set<std::string> DiscoveryCacheFiles;
   cm::optional<std::string> ParallelLevel;
   cm::optional<std::string> Repeat;
 
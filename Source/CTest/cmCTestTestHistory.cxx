@@ -0,0 +1,217 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmCTestTestHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ios>
+#include <memory>
+#include <utility>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmGeneratedFileStream.h"
+
+std::size_t const cmCTestTestHistory::Window = 32;
+
+namespace {
+Json::Value RunToJson(cmCTestTestHistory::Run const& run)
+{
+  Json::Value value(Json::objectValue);
+  value["name"] = run.Name;
+  value["config"] = run.Config;
+  value["start"] = run.StartTime;
+  value["duration"] = run.Duration;
+  value["passed"] = run.Passed;
+  return value;
+}
+
+void WriteRun(std::ostream& out, Json::StreamWriter& writer,
+              cmCTestTestHistory::Run const& run)
+{
+  writer.write(RunToJson(run), &out);
+  out << '\n';
+}
+
+std::unique_ptr<Json::StreamWriter> NewLineWriter()
+{
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return std::unique_ptr<Json::StreamWriter>(builder.newStreamWriter());
+}
+
+// Nearest-rank percentile of sorted values.
+double Percentile(std::vector<double> const& sorted, double p)
+{
+  auto rank = static_cast<std::size_t>(
+    std::ceil(p * static_cast<double>(sorted.size())));
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+}
+
+cmCTestTestHistory::cmCTestTestHistory(std::string file)
+  : File(std::move(file))
+{
+}
+
+void cmCTestTestHistory::Load()
+{
+  this->Runs.clear();
+  this->Lines = 0;
+
+  cmsys::ifstream fin(this->File.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return;
+  }
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+  std::string line;
+  while (std::getline(fin, line)) {
+    ++this->Lines;
+    Json::Value value;
+    if (!reader->parse(line.data(), line.data() + line.size(), &value,
+                       nullptr) ||
+        !value.isObject() || !value["name"].isString() ||
+        !value["config"].isString() || !value["start"].isNumeric() ||
+        !value["duration"].isNumeric() || !value["passed"].isBool()) {
+      continue;
+    }
+    Run run;
+    run.Name = value["name"].asString();
+    run.Config = value["config"].asString();
+    run.StartTime = value["start"].asDouble();
+    run.Duration = value["duration"].asDouble();
+    run.Passed = value["passed"].asBool();
+    this->Add(std::move(run));
+  }
+}
+
+void cmCTestTestHistory::Add(Run run)
+{
+  std::deque<Run>& runs = this->Runs[Key(run.Name, run.Config)];
+  runs.emplace_back(std::move(run));
+  if (runs.size() > Window) {
+    runs.pop_front();
+  }
+}
+
+bool cmCTestTestHistory::Record(std::vector<Run> const& runs)
+{
+  for (Run const& run : runs) {
+    this->Add(run);
+  }
+
+  // Rewrite the file once most of its lines are runs no longer kept.
+  std::size_t const lines = this->Lines + runs.size();
+  if (lines > 2 * Window * this->Runs.size()) {
+    this->Lines = 0;
+    for (auto const& r : this->Runs) {
+      this->Lines += r.second.size();
+    }
+    return this->Compact();
+  }
+
+  cmsys::ofstream fout(this->File.c_str(),
+                       std::ios::out | std::ios::app | std::ios::binary);
+  if (!fout) {
+    return false;
+  }
+  std::unique_ptr<Json::StreamWriter> const writer = NewLineWriter();
+  for (Run const& run : runs) {
+    WriteRun(fout, *writer, run);
+  }
+  this->Lines = lines;
+  return static_cast<bool>(fout);
+}
+
+bool cmCTestTestHistory::Compact() const
+{
+  std::vector<Run const*> runs;
+  for (auto const& r : this->Runs) {
+    for (Run const& run : r.second) {
+      runs.emplace_back(&run);
+    }
+  }
+  std::stable_sort(runs.begin(), runs.end(), [](Run const* l, Run const* r) {
+    return l->StartTime < r->StartTime;
+  });
+
+  cmGeneratedFileStream fout(this->File);
+  std::unique_ptr<Json::StreamWriter> const writer = NewLineWriter();
+  for (Run const* run : runs) {
+    WriteRun(fout, *writer, *run);
+  }
+  return fout.Close();
+}
+
+cm::optional<cmCTestTestHistory::Statistics> cmCTestTestHistory::GetStatistics(
+  std::string const& name, std::string const& config) const
+{
+  auto it = this->Runs.find(Key(name, config));
+  if (it == this->Runs.end() || it->second.empty()) {
+    return cm::nullopt;
+  }
+  std::deque<Run> const& runs = it->second;
+
+  Statistics stats;
+  stats.Runs = runs.size();
+  std::vector<double> passed;
+  std::vector<double> all;
+  std::size_t failures = 0;
+  for (Run const& run : runs) {
+    all.push_back(run.Duration);
+    if (run.Passed) {
+      passed.push_back(run.Duration);
+    } else {
+      ++failures;
+    }
+    stats.LastRun = std::max(stats.LastRun, run.StartTime);
+  }
+  std::vector<double>& durations = passed.empty() ? all : passed;
+  std::sort(durations.begin(), durations.end());
+  stats.Median = Percentile(durations, 0.5);
+  stats.Percentile90 = Percentile(durations, 0.9);
+  stats.Maximum = durations.back();
+  stats.FailureRate =
+    static_cast<double>(failures) / static_cast<double>(runs.size());
+  return stats;
+}
+
+bool cmCTestTestHistory::WriteJson(std::string const& file) const
+{
+  Json::Value root(Json::objectValue);
+  Json::Value& version = root["version"] = Json::objectValue;
+  version["major"] = 1;
+  version["minor"] = 0;
+  Json::Value& tests = root["tests"] = Json::arrayValue;
+  for (auto const& r : this->Runs) {
+    cm::optional<Statistics> stats =
+      this->GetStatistics(r.first.first, r.first.second);
+    if (!stats) {
+      continue;
+    }
+    Json::Value test(Json::objectValue);
+    test["name"] = r.first.first;
+    test["config"] = r.first.second;
+    test["runs"] = static_cast<Json::UInt64>(stats->Runs);
+    test["failureRate"] = stats->FailureRate;
+    test["lastRun"] = stats->LastRun;
+    Json::Value& duration = test["duration"] = Json::objectValue;
+    duration["p50"] = stats->Median;
+    duration["p90"] = stats->Percentile90;
+    duration["max"] = stats->Maximum;
+    tests.append(std::move(test));
+  }
+
+  cmGeneratedFileStream fout(file);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  std::unique_ptr<Json::StreamWriter> const writer(builder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+  return fout.Close();
+}
@@ -0,0 +1,78 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cm/optional>
+
+/** \class cmCTestTestHistory
+ * \brief Recorded runs of tests, by test name and configuration
+ *
+ * Each run is appended to a file as one line of JSON, so that recording
+ * the runs of a test session does not rewrite the history of others.
+ * Only the most recent runs of each test and configuration are kept;
+ * the file is compacted when it holds many more lines than that.
+ */
+class cmCTestTestHistory
+{
+public:
+  struct Run
+  {
+    std::string Name;
+    std::string Config;
+    // Start time in seconds since the epoch.
+    double StartTime = 0;
+    // Duration in seconds.
+    double Duration = 0;
+    bool Passed = false;
+  };
+
+  struct Statistics
+  {
+    std::size_t Runs = 0;
+    double Median = 0;
+    double Percentile90 = 0;
+    double Maximum = 0;
+    double FailureRate = 0;
+    double LastRun = 0;
+  };
+
+  // The number of most recent runs kept for each test and configuration.
+  static std::size_t const Window;
+
+  cmCTestTestHistory(std::string file);
+
+  /** Load the runs recorded in the file.  Malformed lines are ignored.  */
+  void Load();
+
+  /** Add runs and record them in the file.  */
+  bool Record(std::vector<Run> const& runs);
+
+  /**
+   * Get statistics of the recorded runs of a test.  The durations are
+   * taken from the runs that passed, if any.
+   */
+  cm::optional<Statistics> GetStatistics(std::string const& name,
+                                         std::string const& config) const;
+
+  /** Write the statistics of all tests to a JSON file.  */
+  bool WriteJson(std::string const& file) const;
+
+private:
+  using Key = std::pair<std::string, std::string>;
+
+  void Add(Run run);
+  bool Compact() const;
+
+  std::string File;
+  std::map<Key, std::deque<Run>> Runs;
+  std::size_t Lines = 0;
+};
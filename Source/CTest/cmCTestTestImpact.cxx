@@ -0,0 +1,182 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmCTestTestImpact.h"
+
+#include <algorithm>
+#include <ios>
+#include <utility>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+bool ReadStrings(Json::Value const& value, std::vector<std::string>& out)
+{
+  if (!value.isArray()) {
+    return false;
+  }
+  for (Json::Value const& v : value) {
+    if (!v.isString()) {
+      return false;
+    }
+    out.emplace_back(v.asString());
+  }
+  return true;
+}
+
+bool ReadIndices(Json::Value const& value, std::size_t size,
+                 std::vector<std::size_t>& out)
+{
+  if (!value.isArray()) {
+    return false;
+  }
+  for (Json::Value const& v : value) {
+    if (!v.isUInt() || v.asUInt() >= size) {
+      return false;
+    }
+    out.emplace_back(v.asUInt());
+  }
+  return true;
+}
+}
+
+std::string cmCTestTestImpact::FindIndex(std::string dir)
+{
+  for (;;) {
+    std::string file = cmStrCat(dir, "/CMakeFiles/TestImpact.json");
+    if (cmSystemTools::FileExists(file, true)) {
+      return file;
+    }
+    std::string parent = cmSystemTools::GetParentDirectory(dir);
+    if (parent.empty() || parent == dir) {
+      return std::string();
+    }
+    dir = std::move(parent);
+  }
+}
+
+bool cmCTestTestImpact::Load(std::string const& file, std::string& error)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  if (!fin || !Json::parseFromStream(builder, fin, &root, &errors) ||
+      !root.isObject()) {
+    error = cmStrCat("Could not read test impact index:\n  ", file);
+    return false;
+  }
+  Json::Value const& version = root["version"];
+  if (!version.isObject() || !version["major"].isInt() ||
+      version["major"].asInt() != 1) {
+    error = cmStrCat("Unsupported version of test impact index:\n  ", file);
+    return false;
+  }
+
+  Json::Value const& targets = root["targets"];
+  Json::Value const& tests = root["tests"];
+  bool ok = root["sourceDirectory"].isString() &&
+    ReadStrings(root["listFiles"], this->ListFiles) && targets.isArray() &&
+    tests.isArray();
+  if (ok) {
+    this->SourceDirectory = root["sourceDirectory"].asString();
+    this->Targets.resize(targets.size());
+    for (Json::ArrayIndex i = 0; ok && i < targets.size(); ++i) {
+      Json::Value const& t = targets[i];
+      ok = t.isObject() &&
+        ReadStrings(t["sources"], this->Targets[i].Sources) &&
+        ReadIndices(t["dependencies"], this->Targets.size(),
+                    this->Targets[i].Dependencies);
+    }
+  }
+  for (Json::ArrayIndex i = 0; ok && i < tests.size(); ++i) {
+    Json::Value const& t = tests[i];
+    Test test;
+    ok = t.isObject() && t["name"].isString() &&
+      ReadIndices(t["targets"], this->Targets.size(), test.Targets) &&
+      ReadStrings(t["files"], test.Files);
+    if (ok) {
+      test.Name = t["name"].asString();
+      this->Tests.emplace_back(std::move(test));
+    }
+  }
+  if (!ok) {
+    error = cmStrCat("Malformed test impact index:\n  ", file);
+  }
+  return ok;
+}
+
+void cmCTestTestImpact::Select(std::set<std::string> const& changedFiles)
+{
+  std::set<std::string> changed;
+  for (std::string const& file : changedFiles) {
+    changed.insert(
+      cmSystemTools::CollapseFullPath(file, this->SourceDirectory));
+  }
+  auto isChanged = [&changed](std::vector<std::string> const& files) {
+    return std::any_of(
+      files.begin(), files.end(),
+      [&changed](std::string const& f) { return changed.count(f) != 0; });
+  };
+
+  // A change to the project's CMake code, or to a file the index does
+  // not know, such as a header not listed among the sources of a target,
+  // may affect any test.
+  std::set<std::string> known(this->ListFiles.begin(), this->ListFiles.end());
+  for (Target const& target : this->Targets) {
+    known.insert(target.Sources.begin(), target.Sources.end());
+  }
+  for (Test const& test : this->Tests) {
+    known.insert(test.Files.begin(), test.Files.end());
+  }
+  this->AllAffected = isChanged(this->ListFiles) ||
+    std::any_of(
+      changed.begin(), changed.end(),
+      [&known](std::string const& f) { return known.count(f) == 0; });
+
+  // A target is affected if one of its sources changed or it depends on
+  // an affected target.  Walk the dependencies backward from the targets
+  // whose sources changed.
+  std::vector<std::vector<std::size_t>> dependents(this->Targets.size());
+  std::vector<bool> affected(this->Targets.size(), false);
+  std::vector<std::size_t> queue;
+  for (std::size_t i = 0; i < this->Targets.size(); ++i) {
+    for (std::size_t d : this->Targets[i].Dependencies) {
+      dependents[d].push_back(i);
+    }
+    if (isChanged(this->Targets[i].Sources)) {
+      affected[i] = true;
+      queue.push_back(i);
+    }
+  }
+  while (!queue.empty()) {
+    std::size_t const i = queue.back();
+    queue.pop_back();
+    for (std::size_t d : dependents[i]) {
+      if (!affected[d]) {
+        affected[d] = true;
+        queue.push_back(d);
+      }
+    }
+  }
+
+  for (Test const& test : this->Tests) {
+    this->KnownTests.insert(test.Name);
+    if (isChanged(test.Files) ||
+        std::any_of(test.Targets.begin(), test.Targets.end(),
+                    [&affected](std::size_t t) { return affected[t]; })) {
+      this->AffectedTests.insert(test.Name);
+    }
+  }
+}
+
+bool cmCTestTestImpact::IsAffected(std::string const& testName) const
+{
+  return this->AllAffected || this->KnownTests.count(testName) == 0 ||
+    this->AffectedTests.count(testName) != 0;
+}
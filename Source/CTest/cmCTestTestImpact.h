@@ -0,0 +1,63 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <vector>
+
+/** \class cmCTestTestImpact
+ * \brief Selection of the tests affected by changes to files
+ *
+ * CMake writes an index of the targets and files used by the tests of a
+ * build tree, with the sources of those targets and the targets on which
+ * they depend.  A test is affected by a change to a file it uses, to a
+ * source of a target it uses directly or through its dependencies, to
+ * the CMake code of the project, or to a file not in the index.  Tests
+ * not in the index may use any file and are always affected.
+ */
+class cmCTestTestImpact
+{
+public:
+  /**
+   * Find the index of the build tree containing a directory, or return
+   * an empty string if there is none.
+   */
+  static std::string FindIndex(std::string dir);
+
+  /** Load an index.  Returns false with an error if it cannot be read.  */
+  bool Load(std::string const& file, std::string& error);
+
+  /**
+   * Select the tests affected by changes to files.  Relative paths are
+   * relative to the top-level source directory of the build tree.
+   */
+  void Select(std::set<std::string> const& changedFiles);
+
+  bool IsAffected(std::string const& testName) const;
+
+private:
+  struct Target
+  {
+    std::vector<std::string> Sources;
+    std::vector<std::size_t> Dependencies;
+  };
+  struct Test
+  {
+    std::string Name;
+    std::vector<std::size_t> Targets;
+    std::vector<std::string> Files;
+  };
+
+  std::string SourceDirectory;
+  std::vector<std::string> ListFiles;
+  std::vector<Target> Targets;
+  std::vector<Test> Tests;
+
+  bool AllAffected = false;
+  std::set<std::string> KnownTests;
+  std::set<std::string> AffectedTests;
+};
@@ -3,8 +3,11 @@
 
 #include "cmCTestTypes.h"
 
+#include <limits>
 #include <string>
 
+#include "cmStringAlgorithms.h"
+
 namespace cmCTestTypes {
 
 bool SetTruncationMode(TruncationMode& mode, cm::string_view str)
@@ -21,4 +24,40 @@ bool SetTruncationMode(TruncationMode& mode, cm::string_view str)
   return true;
 }
 
+bool ParseMemorySize(cm::string_view str, unsigned long long& kib)
+{
+  unsigned long long unit = 1;
+  if (!str.empty()) {
+    switch (str.back()) {
+      case 'T':
+      case 't':
+        unit <<= 10;
+        CM_FALLTHROUGH;
+      case 'G':
+      case 'g':
+        unit <<= 10;
+        CM_FALLTHROUGH;
+      case 'M':
+      case 'm':
+        unit <<= 10;
+        CM_FALLTHROUGH;
+      case 'K':
+      case 'k':
+        unit <<= 10;
+        str.remove_suffix(1);
+        break;
+      default:
+        break;
+    }
+  }
+  unsigned long long value;
+  if (!cmStrToULongLong(std::string(str), &value) ||
+      value > std::numeric_limits<unsigned long long>::max() / unit) {
+    return false;
+  }
+  unsigned long long const bytes = value * unit;
+  kib = bytes / 1024 + (bytes % 1024 != 0 ? 1 : 0);
+  return true;
+}
+
 } // namespace cmCTestTypes
@@ -19,4 +19,8 @@ enum class TruncationMode
 
 bool SetTruncationMode(TruncationMode& mode, cm::string_view str);
 
+// Parse a memory size given in bytes, or in binary multiples with a
+// K, M, G, or T suffix, to KiB rounded up.
+bool ParseMemorySize(cm::string_view str, unsigned long long& kib);
+
 } // namespace cmCTestTypes
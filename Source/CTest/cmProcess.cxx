@@ -2,14 +2,19 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmProcess.h"
 
+#include <algorithm>
 #include <csignal>
 #include <iostream>
 #include <ratio>
+#include <set>
 #include <string>
 #include <utility>
 
+#include <cm/string_view>
 #include <cmext/algorithm>
 
+#include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
 #include "cmsys/Process.h"
 
 #include "cmCTest.h"
@@ -23,6 +28,31 @@
 
 #define CM_PROCESS_BUF_SIZE 65536
 
+namespace {
+// Read a memory size in KiB from /proc/<pid>/status, or 0 if not known.
+unsigned long long ReadProcStatusKiB(std::string const& pid,
+                                     cm::string_view field)
+{
+  cmsys::ifstream fin(cmStrCat("/proc/", pid, "/status").c_str());
+  std::string line;
+  while (std::getline(fin, line)) {
+    // Format: "VmHWM:    1234 kB"
+    if (cm::string_view(line).substr(0, field.size()) == field &&
+        cmHasLiteralSuffix(line, "kB")) {
+      unsigned long long kib;
+      if (cmStrToULongLong(
+            cmTrimWhitespace(cm::string_view(line).substr(
+              field.size(), line.size() - field.size() - 2)),
+            &kib)) {
+        return kib;
+      }
+      break;
+    }
+  }
+  return 0;
+}
+}
+
 cmProcess::cmProcess(std::unique_ptr<cmCTestRunTest> runner)
   : Runner(std::move(runner))
   , Conv(cmProcessOutput::UTF8, CM_PROCESS_BUF_SIZE)
@@ -165,11 +195,69 @@ bool cmProcess::StartProcess(uv_loop_t& loop, std::vector<size_t>* affinity)
   this->Timer = std::move(timer);
 
   this->StartTimer();
+  this->StartMemoryTimer(loop);
 
   this->ProcessState = cmProcess::State::Executing;
   return true;
 }
 
+void cmProcess::StartMemoryTimer(uv_loop_t& loop)
+{
+#if defined(__linux__)
+  // The kernel tracks the peak resident memory of each process, but it can
+  // be read only while the process exists.  Read it periodically.
+  if (this->MeasureMemory && this->MemoryTimer.init(loop, this) == 0) {
+    this->MemoryTimer.start(&cmProcess::OnMemoryTimerCB, 100, 100,
+                            cm::uv_update_time::no);
+  }
+#else
+  static_cast<void>(loop);
+#endif
+}
+
+void cmProcess::OnMemoryTimerCB(uv_timer_t* timer)
+{
+  auto* self = static_cast<cmProcess*>(timer->data);
+  self->SampleMemory();
+}
+
+void cmProcess::SampleMemory()
+{
+  // Sum the resident memory of the test process and of the processes it
+  // started, found through the children of each of their threads.
+  std::string const root = std::to_string(this->Process->pid);
+  std::vector<std::string> pids = { root };
+  std::set<std::string> seen = { root };
+  unsigned long long total = 0;
+  while (!pids.empty()) {
+    std::string const pid = std::move(pids.back());
+    pids.pop_back();
+    total += ReadProcStatusKiB(pid, "VmRSS:");
+    std::string const taskDir = cmStrCat("/proc/", pid, "/task");
+    cmsys::Directory tasks;
+    if (!tasks.Load(taskDir)) {
+      continue;
+    }
+    for (unsigned long i = 0; i < tasks.GetNumberOfFiles(); ++i) {
+      std::string const task = tasks.GetFileName(i);
+      if (task == "." || task == "..") {
+        continue;
+      }
+      cmsys::ifstream fin(cmStrCat(taskDir, '/', task, "/children").c_str());
+      std::string child;
+      while (fin >> child) {
+        if (seen.insert(child).second) {
+          pids.push_back(child);
+        }
+      }
+    }
+  }
+  // The peak of the test process alone may have been reached between two
+  // samples.
+  this->PeakMemory = std::max(
+    { this->PeakMemory, total, ReadProcStatusKiB(root, "VmHWM:") });
+}
+
 void cmProcess::StartTimer()
 {
   if (auto ctimeout = this->GetComputedTimeout()) {
@@ -362,6 +450,9 @@ void cmProcess::OnExit(int64_t exit_status, int term_signal)
 
   // Record exit information.
   this->ExitValue = exit_status;
+  if (this->MemoryTimer) {
+    uv_timer_stop(this->MemoryTimer);
+  }
   this->Signal = term_signal;
 
   this->ProcessHandleClosed = true;
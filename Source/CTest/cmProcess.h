@@ -40,6 +40,7 @@ public:
   void SetWorkingDirectory(std::string dir);
   void SetStopTimeout(cmDuration t) { this->StopTimeout = t; }
   void SetTimeout(cmDuration t) { this->Timeout = t; }
+  void SetMeasureMemory(bool measure) { this->MeasureMemory = measure; }
   void ChangeTimeout(cmDuration t);
   void ResetStartTime();
   // Return true if the process starts
@@ -75,6 +76,9 @@ public:
   void SetId(int id) { this->Id = id; }
   int64_t GetExitValue() const { return this->ExitValue; }
   cmDuration GetTotalTime() { return this->TotalTime; }
+  // Peak resident memory of the process and of the processes it started,
+  // in KiB, or 0 if not measured.
+  unsigned long long GetPeakMemory() const { return this->PeakMemory; }
   std::chrono::steady_clock::time_point GetStartTime()
   {
     return this->StartTime;
@@ -123,6 +127,7 @@ private:
   cm::uv_process_ptr Process;
   cm::uv_pipe_ptr PipeReader;
   cm::uv_timer_ptr Timer;
+  cm::uv_timer_ptr MemoryTimer;
   std::vector<char> Buf;
 
   std::unique_ptr<cmCTestRunTest> Runner;
@@ -133,6 +138,7 @@ private:
   static void OnExitCB(uv_process_t* process, int64_t exit_status,
                        int term_signal);
   static void OnTimeoutCB(uv_timer_t* timer);
+  static void OnMemoryTimerCB(uv_timer_t* timer);
   static void OnReadCB(uv_stream_t* stream, ssize_t nread,
                        uv_buf_t const* buf);
   static void OnAllocateCB(uv_handle_t* handle, size_t suggested_size,
@@ -144,6 +150,8 @@ private:
   void OnAllocate(size_t suggested_size, uv_buf_t* buf);
 
   void StartTimer();
+  void StartMemoryTimer(uv_loop_t& loop);
+  void SampleMemory();
   void Finish();
 
   class Buffer : public std::vector<char>
@@ -166,5 +174,7 @@ private:
   std::vector<char const*> Env;
   int Id;
   int64_t ExitValue;
+  bool MeasureMemory = false;
+  unsigned long long PeakMemory = 0;
   Termination TerminationStyle = Termination::Normal;
 };
@@ -2322,6 +2322,11 @@ int cmCTest::Run(std::vector<std::string> const& args)
         }
         return true;
       } },
+    CommandArgument{ "--test-output-spool", CommandArgument::Values::Zero,
+                     [this](std::string const&) -> bool {
+                       this->Impl->TestOptions.OutputSpool = true;
+                       return true;
+                     } },
     CommandArgument{ "--show-only", CommandArgument::Values::ZeroOrOne,
                      [this](std::string const& format) -> bool {
                        this->Impl->ShowOnly = true;
@@ -2450,6 +2455,11 @@ int cmCTest::Run(std::vector<std::string> const& args)
                        this->Impl->TestOptions.ExcludeTestListFile = file;
                        return true;
                      } },
+    CommandArgument{ "--affected-by", CommandArgument::Values::One,
+                     [this](std::string const& file) -> bool {
+                       this->Impl->TestOptions.AffectedByFile = file;
+                       return true;
+                     } },
     CommandArgument{ "--schedule-random", CommandArgument::Values::Zero,
                      [this](std::string const&) -> bool {
                        this->Impl->TestOptions.ScheduleRandom = true;
@@ -2469,6 +2479,51 @@ int cmCTest::Run(std::vector<std::string> const& args)
         }
         return true;
       } },
+    CommandArgument{ "--schedule-critical-path", CommandArgument::Values::Zero,
+                     [this](std::string const&) -> bool {
+                       this->Impl->TestOptions.ScheduleCriticalPath = true;
+                       return true;
+                     } },
+    CommandArgument{ "--test-history", CommandArgument::Values::Zero,
+                     [this](std::string const&) -> bool {
+                       this->Impl->TestOptions.TestHistory = true;
+                       return true;
+                     } },
+    CommandArgument{
+      "--shard-count", CommandArgument::Values::One,
+      [this](std::string const& count) -> bool {
+        unsigned long n;
+        if (!cmStrToULong(count, &n) || n == 0) {
+          cmSystemTools::Error(
+            cmStrCat("'--shard-count' given invalid value '", count, '\''));
+          return false;
+        }
+        this->Impl->TestOptions.ShardCount = n;
+        return true;
+      } },
+    CommandArgument{
+      "--shard-index", CommandArgument::Values::One,
+      [this](std::string const& index) -> bool {
+        unsigned long n;
+        if (!cmStrToULong(index, &n)) {
+          cmSystemTools::Error(
+            cmStrCat("'--shard-index' given invalid value '", index, '\''));
+          return false;
+        }
+        this->Impl->TestOptions.ShardIndex = n;
+        return true;
+      } },
+    CommandArgument{
+      "--test-memory-limit", CommandArgument::Values::One,
+      [this](std::string const& size) -> bool {
+        if (!cmCTestTypes::ParseMemorySize(
+              size, this->Impl->TestOptions.TestMemoryLimit)) {
+          cmSystemTools::Error(cmStrCat(
+            "'--test-memory-limit' given invalid value '", size, '\''));
+          return false;
+        }
+        return true;
+      } },
     CommandArgument{ "--rerun-failed", CommandArgument::Values::Zero,
                      [this](std::string const&) -> bool {
                        this->Impl->TestOptions.RerunFailed = true;
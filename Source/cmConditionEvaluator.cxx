@@ -26,6 +26,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmValue.h"
+#include "cmake.h"
 
 namespace {
 auto const keyAND = "AND"_s;
@@ -497,6 +498,7 @@ bool cmConditionEvaluator::HandleLevel1(cmArgumentList& newArgs, std::string&,
       auto result = false;
       if (looksLikeSpecialVariable(var, "ENV"_s, varNameLen)) {
         auto const env = args.next->GetValue().substr(4, varNameLen - 5);
+        this->Makefile.GetCMakeInstance()->RecordEnvironmentVariable(env);
         result = cmSystemTools::HasEnv(env);
       }
 
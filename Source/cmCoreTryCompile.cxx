@@ -190,10 +190,14 @@ auto const TryCompileBaseProjectArgParser =
   /* keep semicolon on own line */;
 
 auto const TryCompileProjectArgParser =
-  makeTryCompileParser(TryCompileBaseProjectArgParser);
+  makeTryCompileParser(TryCompileBaseProjectArgParser)
+    .Bind("BATCH"_s, &Arguments::Batch)
+  /* keep semicolon on own line */;
 
 auto const TryCompileSourcesArgParser =
-  makeTryCompileParser(TryCompileBaseNewSourcesArgParser);
+  makeTryCompileParser(TryCompileBaseNewSourcesArgParser)
+    .Bind("BATCH"_s, &Arguments::Batch)
+  /* keep semicolon on own line */;
 
 auto const TryCompileOldArgParser =
   makeTryCompileParser(TryCompileBaseSourcesArgParser)
@@ -311,8 +315,8 @@ Arguments cmCoreTryCompile::ParseArgs(
   return arguments;
 }
 
-cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
-  Arguments& arguments, cmStateEnums::TargetType targetType)
+bool cmCoreTryCompile::WriteTryCompileCode(Arguments& arguments,
+                                           cmStateEnums::TargetType targetType)
 {
   this->OutputFile.clear();
   // which signature were we called with ?
@@ -328,7 +332,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         arguments.SourceDirectoryOrFile->empty()) {
       this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                    "No <srcdir> specified.");
-      return cm::nullopt;
+      return false;
     }
     sourceDirectory = *arguments.SourceDirectoryOrFile;
     projectName = *arguments.ProjectName;
@@ -348,7 +352,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
   if (!arguments.BinaryDirectory || arguments.BinaryDirectory->empty()) {
     this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                  "No <bindir> specified.");
-    return cm::nullopt;
+    return false;
   }
   if (*arguments.BinaryDirectory == unique_binary_directory) {
     // leave empty until we're ready to create it, so we don't try to remove
@@ -361,7 +365,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         MessageType::FATAL_ERROR,
         cmStrCat("<bindir> is not an absolute path:\n '",
                  *arguments.BinaryDirectory, '\''));
-      return cm::nullopt;
+      return false;
     }
     this->BinaryDirectory = *arguments.BinaryDirectory;
     // compute the binary dir when TRY_COMPILE is called with a src file
@@ -393,7 +397,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
                        "IMPORTED LINK_LIBRARIES.  Got ",
                        tgt->GetName(), " of type ",
                        cmState::GetTargetTypeName(tgt->GetType()), '.'));
-            return cm::nullopt;
+            return false;
         }
         if (tgt->IsImported()) {
           targets.emplace_back(i);
@@ -405,28 +409,28 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
   if (arguments.CopyFileTo && arguments.CopyFileTo->empty()) {
     this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                  "COPY_FILE must be followed by a file path");
-    return cm::nullopt;
+    return false;
   }
 
   if (arguments.CopyFileError && arguments.CopyFileError->empty()) {
     this->Makefile->IssueMessage(
       MessageType::FATAL_ERROR,
       "COPY_FILE_ERROR must be followed by a variable name");
-    return cm::nullopt;
+    return false;
   }
 
   if (arguments.CopyFileError && !arguments.CopyFileTo) {
     this->Makefile->IssueMessage(
       MessageType::FATAL_ERROR,
       "COPY_FILE_ERROR may be used only with COPY_FILE");
-    return cm::nullopt;
+    return false;
   }
 
   if (arguments.Sources && arguments.Sources->empty()) {
     this->Makefile->IssueMessage(
       MessageType::FATAL_ERROR,
       "SOURCES must be followed by at least one source file");
-    return cm::nullopt;
+    return false;
   }
 
   if (this->SrcFileSignature) {
@@ -435,24 +439,24 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
       this->Makefile->IssueMessage(
         MessageType::FATAL_ERROR,
         "SOURCE_FROM_CONTENT requires exactly two arguments");
-      return cm::nullopt;
+      return false;
     }
     if (arguments.SourceFromVar && arguments.SourceFromVar->size() % 2) {
       this->Makefile->IssueMessage(
         MessageType::FATAL_ERROR,
         "SOURCE_FROM_VAR requires exactly two arguments");
-      return cm::nullopt;
+      return false;
     }
     if (arguments.SourceFromFile && arguments.SourceFromFile->size() % 2) {
       this->Makefile->IssueMessage(
         MessageType::FATAL_ERROR,
         "SOURCE_FROM_FILE requires exactly two arguments");
-      return cm::nullopt;
+      return false;
     }
     if (!arguments.SourceTypeError.empty()) {
       this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                    arguments.SourceTypeError);
-      return cm::nullopt;
+      return false;
     }
   } else {
     // only valid for srcfile signatures
@@ -461,19 +465,19 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         MessageType::FATAL_ERROR,
         cmStrCat(arguments.LangProps.begin()->first,
                  " allowed only in source file signature"));
-      return cm::nullopt;
+      return false;
     }
     if (!arguments.CompileDefs.empty()) {
       this->Makefile->IssueMessage(
         MessageType::FATAL_ERROR,
         "COMPILE_DEFINITIONS allowed only in source file signature");
-      return cm::nullopt;
+      return false;
     }
     if (arguments.CopyFileTo) {
       this->Makefile->IssueMessage(
         MessageType::FATAL_ERROR,
         "COPY_FILE allowed only in source file signature");
-      return cm::nullopt;
+      return false;
     }
   }
 
@@ -493,7 +497,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
     e << "Attempt at a recursive or nested TRY_COMPILE in directory\n"
       << "  " << this->BinaryDirectory << "\n";
     this->Makefile->IssueMessage(MessageType::FATAL_ERROR, e.str());
-    return cm::nullopt;
+    return false;
   }
 
   std::map<std::string, std::string> cmakeVariables;
@@ -520,7 +524,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         auto const& content = (*arguments.SourceFromContent)[i + 1].first;
         auto out = this->WriteSource(name, content, "SOURCE_FROM_CONTENT");
         if (out.empty()) {
-          return cm::nullopt;
+          return false;
         }
         sources.emplace_back(std::move(out),
                              (*arguments.SourceFromContent)[i + 0].second);
@@ -534,7 +538,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         auto const& content = this->Makefile->GetDefinition(var);
         auto out = this->WriteSource(name, content, "SOURCE_FROM_VAR");
         if (out.empty()) {
-          return cm::nullopt;
+          return false;
         }
         sources.emplace_back(std::move(out),
                              (*arguments.SourceFromVar)[i + 0].second);
@@ -550,7 +554,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
           auto const& msg =
             cmStrCat("SOURCE_FROM_FILE given invalid filename \"", dst, '"');
           this->Makefile->IssueMessage(MessageType::FATAL_ERROR, msg);
-          return cm::nullopt;
+          return false;
         }
 
         auto dstPath = cmStrCat(this->BinaryDirectory, '/', dst);
@@ -559,7 +563,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
           auto const& msg = cmStrCat("SOURCE_FROM_FILE failed to copy \"", src,
                                      "\": ", result.GetString());
           this->Makefile->IssueMessage(MessageType::FATAL_ERROR, msg);
-          return cm::nullopt;
+          return false;
         }
 
         sources.emplace_back(std::move(dstPath),
@@ -591,7 +595,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         err << cmJoin(langs, " ");
         err << "\nSee project() command to enable other languages.";
         this->Makefile->IssueMessage(MessageType::FATAL_ERROR, err.str());
-        return cm::nullopt;
+        return false;
       }
     }
 
@@ -616,7 +620,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         cmStrCat("Failed to open\n"
                  "  ",
                  outFileName, '\n', cmSystemTools::GetLastSystemError()));
-      return cm::nullopt;
+      return false;
     }
 
     cmValue def = this->Makefile->GetDefinition("CMAKE_MODULE_PATH");
@@ -851,7 +855,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
         this->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                      "could not write export file.");
         fclose(fout);
-        return cm::nullopt;
+        return false;
       }
       fprintf(fout, "\ninclude(\"${CMAKE_CURRENT_LIST_DIR}/%s\")\n",
               fname.c_str());
@@ -1246,18 +1250,133 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
     this->Makefile->IssueMessage(MessageType::LOG, msg);
   }
 
+  this->SourceDirectory = std::move(sourceDirectory);
+  this->ProjectName = std::move(projectName);
+  this->TargetName = std::move(targetName);
+  this->CMakeVariables = std::move(cmakeVariables);
+#ifndef CMAKE_BOOTSTRAP
+  this->LoadCachedResult(arguments);
+#endif
+  return true;
+}
+
+#ifndef CMAKE_BOOTSTRAP
+void cmCoreTryCompile::LoadCachedResult(Arguments const& arguments)
+{
+  this->ResultCacheFile.clear();
+  this->CachedResult = cm::nullopt;
+
+  // Only projects written entirely to the binary directory are cached,
+  // so that the key covers all of their sources.  Projects that copy
+  // their output or are kept for debugging must be built.
+  if (!this->SrcFileSignature || arguments.Sources || arguments.CopyFileTo ||
+      this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+    return;
+  }
+
+  std::vector<std::string> keyArgs = arguments.CMakeFlags;
+  if (this->ResultCacheRunKey) {
+    keyArgs.emplace_back("try_run");
+    keyArgs.insert(keyArgs.end(), this->ResultCacheRunKey->begin(),
+                   this->ResultCacheRunKey->end());
+  }
+  this->ResultCacheFile = cmTryCompileCache::GetFile(
+    *this->Makefile, this->BinaryDirectory, this->TargetName, keyArgs);
+  if (this->ResultCacheFile.empty()) {
+    return;
+  }
+  this->CachedResult = cmTryCompileCache::Load(
+    this->ResultCacheFile, this->BinaryDirectory, this->TargetName);
+  if (this->CachedResult && this->ResultCacheRunKey &&
+      this->CachedResult->CompileExitCode == 0 &&
+      !this->CachedResult->RunExitCode) {
+    this->CachedResult = cm::nullopt;
+  }
+}
+#endif
+
+bool cmCoreTryCompile::GetCachedBuild(int& res, std::string& output) const
+{
+#ifndef CMAKE_BOOTSTRAP
+  if (this->CachedResult) {
+    res = this->CachedResult->CompileExitCode;
+    output = this->CachedResult->CompileOutput;
+    return true;
+  }
+#else
+  static_cast<void>(res);
+  static_cast<void>(output);
+#endif
+  return false;
+}
+
+void cmCoreTryCompile::StoreCachedBuild(int res,
+                                        std::string const& output) const
+{
+#ifndef CMAKE_BOOTSTRAP
+  if (!this->ResultCacheFile.empty() && !this->ResultCacheRunKey) {
+    cmTryCompileCache::Entry entry;
+    entry.CompileExitCode = res;
+    entry.CompileOutput = output;
+    cmTryCompileCache::Store(this->ResultCacheFile, entry,
+                             this->BinaryDirectory, this->TargetName);
+  }
+#else
+  static_cast<void>(res);
+  static_cast<void>(output);
+#endif
+}
+
+cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
+  Arguments& arguments, cmStateEnums::TargetType targetType)
+{
+  if (!this->WriteTryCompileCode(arguments, targetType)) {
+    return cm::nullopt;
+  }
+
+  int res = 1;
+  std::string output;
+  if (this->GetCachedBuild(res, output)) {
+    return this->FinishTryCompileCode(arguments, res, std::move(output));
+  }
+
   bool erroroc = cmSystemTools::GetErrorOccurredFlag();
   cmSystemTools::ResetErrorOccurredFlag();
-  std::string output;
   // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL,
+  res = this->Makefile->TryCompile(
+    this->SourceDirectory, this->BinaryDirectory, this->ProjectName,
+    this->TargetName, this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL,
     &arguments.CMakeFlags, output);
   if (erroroc) {
     cmSystemTools::SetErrorOccurred();
   }
+  this->StoreCachedBuild(res, output);
+
+  return this->FinishTryCompileCode(arguments, res, std::move(output));
+}
 
+bool cmCoreTryCompile::GenerateTryCompileCode(Arguments& arguments)
+{
+  // A project whose build result is cached need not be generated.
+  int res = 1;
+  std::string output;
+  if (this->GetCachedBuild(res, output)) {
+    return true;
+  }
+
+  bool erroroc = cmSystemTools::GetErrorOccurredFlag();
+  cmSystemTools::ResetErrorOccurredFlag();
+  res = this->Makefile->GenerateTryCompile(
+    this->SourceDirectory, this->BinaryDirectory, &arguments.CMakeFlags);
+  if (erroroc) {
+    cmSystemTools::SetErrorOccurred();
+  }
+  return res == 0;
+}
+
+cm::optional<cmTryCompileResult> cmCoreTryCompile::FinishTryCompileCode(
+  Arguments& arguments, int res, std::string output)
+{
   // set the result var to the return value to indicate success or failure
   if (arguments.NoCache) {
     this->Makefile->AddDefinition(*arguments.CompileResultVariable,
@@ -1274,7 +1393,7 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
 
   if (this->SrcFileSignature) {
     std::string copyFileErrorMessage;
-    this->FindOutputFile(targetName);
+    this->FindOutputFile(this->TargetName);
 
     if ((res == 0) && arguments.CopyFileTo) {
       std::string const& copyFile = *arguments.CopyFileTo;
@@ -1332,8 +1451,8 @@ cm::optional<cmTryCompileResult> cmCoreTryCompile::TryCompileCode(
   if (arguments.LogDescription) {
     result.LogDescription = *arguments.LogDescription;
   }
-  result.CMakeVariables = std::move(cmakeVariables);
-  result.SourceDirectory = sourceDirectory;
+  result.CMakeVariables = this->CMakeVariables;
+  result.SourceDirectory = this->SourceDirectory;
   result.BinaryDirectory = this->BinaryDirectory;
   result.Variable = *arguments.CompileResultVariable;
   result.VariableCached = !arguments.NoCache;
@@ -1502,3 +1621,19 @@ void cmCoreTryCompile::WriteTryCompileEventFields(
   log.EndObject();
 #endif
 }
+
+void cmCoreTryCompile::WriteTryCompileEvent(
+  cmConfigureLog& log, cmMakefile const& mf,
+  cmTryCompileResult const& compileResult)
+{
+#ifndef CMAKE_BOOTSTRAP
+  // Keep in sync with cmFileAPIConfigureLog's DumpEventKindNames.
+  static std::vector<unsigned int> const LogVersionsWithTryCompileV1{ 1 };
+
+  if (log.IsAnyLogVersionEnabled(LogVersionsWithTryCompileV1)) {
+    log.BeginEvent("try_compile-v1", mf);
+    WriteTryCompileEventFields(log, compileResult);
+    log.EndEvent();
+  }
+#endif
+}
@@ -17,6 +17,10 @@
 #include "cmList.h"
 #include "cmStateTypes.h"
 
+#ifndef CMAKE_BOOTSTRAP
+#  include "cmTryCompileCache.h"
+#endif
+
 class cmConfigureLog;
 class cmMakefile;
 template <typename Iter>
@@ -100,6 +104,7 @@ public:
     cm::optional<ArgumentParser::NonEmpty<std::string>> LogDescription;
     bool NoCache = false;
     bool NoLog = false;
+    bool Batch = false;
 
     ArgumentParser::Continue SetSourceType(cm::string_view sourceType);
     SourceType SourceTypeContext = SourceType::Normal;
@@ -128,6 +133,29 @@ public:
   cm::optional<cmTryCompileResult> TryCompileCode(
     Arguments& arguments, cmStateEnums::TargetType targetType);
 
+  /**
+   * Write the project like TryCompileCode, but do not generate or build
+   * it.  Returns \c false if an error was reported.
+   */
+  bool WriteTryCompileCode(Arguments& arguments,
+                           cmStateEnums::TargetType targetType);
+
+  /**
+   * Generate the project written by WriteTryCompileCode.  Returns \c false
+   * if the project could not be generated, which counts as a failed build.
+   * Once the project has been built, pass the build result to
+   * FinishTryCompileCode.
+   */
+  bool GenerateTryCompileCode(Arguments& arguments);
+
+  /**
+   * Set the result variables of a project generated by
+   * GenerateTryCompileCode from the exit code and output of its build.
+   */
+  cm::optional<cmTryCompileResult> FinishTryCompileCode(Arguments& arguments,
+                                                        int res,
+                                                        std::string output);
+
   /**
    * Returns \c true if \p path resides within a CMake temporary directory,
    * otherwise returns \c false.
@@ -148,16 +176,50 @@ public:
    */
   void FindOutputFile(std::string const& targetName);
 
+  /**
+   * Returns \c true if the build result of the project generated by
+   * WriteTryCompileCode was found in the result cache, so the project
+   * need not be built, and sets \p res and \p output to it.
+   */
+  bool GetCachedBuild(int& res, std::string& output) const;
+
+  /**
+   * Store the build result of the project generated by
+   * WriteTryCompileCode in the result cache, if enabled.
+   */
+  void StoreCachedBuild(int res, std::string const& output) const;
+
   static void WriteTryCompileEventFields(
     cmConfigureLog& log, cmTryCompileResult const& compileResult);
 
+  static void WriteTryCompileEvent(cmConfigureLog& log, cmMakefile const& mf,
+                                   cmTryCompileResult const& compileResult);
+
   std::string BinaryDirectory;
+  std::string SourceDirectory;
+  std::string ProjectName;
+  std::string TargetName;
   std::string OutputFile;
   std::string FindErrorMessage;
   bool SrcFileSignature = false;
   cmMakefile* Makefile;
 
+#ifndef CMAKE_BOOTSTRAP
+  // Inputs of a try_run check to add to the result cache key.  While set,
+  // only results that include running the executable are used, and the
+  // caller stores them.
+  cm::optional<std::vector<std::string>> ResultCacheRunKey;
+  std::string ResultCacheFile;
+  cm::optional<cmTryCompileCache::Entry> CachedResult;
+#endif
+
 private:
+  std::map<std::string, std::string> CMakeVariables;
+
+#ifndef CMAKE_BOOTSTRAP
+  void LoadCachedResult(Arguments const& arguments);
+#endif
+
   std::string WriteSource(std::string const& name, std::string const& content,
                           char const* command) const;
 
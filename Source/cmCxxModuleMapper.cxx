@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
@@ -367,51 +368,74 @@ std::set<std::string> CxxModuleUsageSeed(
     }
   }
 
-  // While we have internal usages to manage.
-  while (!internal_usages.empty()) {
-    size_t starting_size = internal_usages.size();
-
-    // For each internal usage.
-    for (auto usage = internal_usages.begin(); usage != internal_usages.end();
-         /* see end of loop */) {
-      auto& this_usages = usages.Usage[usage->first];
-
-      for (auto use = usage->second.begin(); use != usage->second.end();
-           /* see end of loop */) {
-        // Check if this required module uses other internal modules; defer
-        // if so.
-        if (internal_usages.count(*use)) {
-          // Advance the iterator.
-          ++use;
+  // Resolve internal usages depth-first so that the transitive usages of a
+  // module are complete before they are added to those of its users.  This
+  // visits each usage once however deep the chain of imports is.  Modules
+  // in a cycle, or using one, are left unresolved.
+  enum class UsageState
+  {
+    Visiting,
+    Resolved,
+    Unresolved,
+  };
+  struct UsageFrame
+  {
+    std::map<std::string, std::set<std::string>>::const_iterator Usage;
+    std::set<std::string>::const_iterator Next;
+    bool Resolved;
+  };
+  std::map<std::string, UsageState> states;
+  std::vector<UsageFrame> stack;
+  auto addTransitiveUsages = [&usages](std::string const& user,
+                                       std::string const& use) {
+    auto transitive_usages = usages.Usage.find(use);
+    if (transitive_usages != usages.Usage.end()) {
+      usages.Usage[user].insert(transitive_usages->second.begin(),
+                                transitive_usages->second.end());
+    }
+  };
+  for (auto usage = internal_usages.cbegin(); usage != internal_usages.cend();
+       ++usage) {
+    if (!states.emplace(usage->first, UsageState::Visiting).second) {
+      continue;
+    }
+    stack.push_back({ usage, usage->second.begin(), true });
+    while (!stack.empty()) {
+      UsageFrame& frame = stack.back();
+      if (frame.Next != frame.Usage->second.end()) {
+        std::string const& use = *frame.Next++;
+        auto internal = internal_usages.find(use);
+        if (internal == internal_usages.end()) {
+          addTransitiveUsages(frame.Usage->first, use);
           continue;
         }
-
-        auto transitive_usages = usages.Usage.find(*use);
-        if (transitive_usages != usages.Usage.end()) {
-          this_usages.insert(transitive_usages->second.begin(),
-                             transitive_usages->second.end());
+        auto state = states.emplace(use, UsageState::Visiting);
+        if (state.second) {
+          // The frame reference is invalidated by the push.
+          stack.push_back({ internal, internal->second.begin(), true });
+        } else if (state.first->second == UsageState::Resolved) {
+          addTransitiveUsages(frame.Usage->first, use);
+        } else {
+          frame.Resolved = false;
         }
-
-        // Remove the entry and advance the iterator.
-        use = usage->second.erase(use);
+        continue;
       }
 
-      // Erase the entry if it doesn't have any remaining usages.
-      if (usage->second.empty()) {
-        usage = internal_usages.erase(usage);
-      } else {
-        ++usage;
+      std::string const& name = frame.Usage->first;
+      bool const resolved = frame.Resolved;
+      states[name] =
+        resolved ? UsageState::Resolved : UsageState::Unresolved;
+      if (!resolved) {
+        unresolved.insert(name);
       }
-    }
-
-    // Check that at least one usage was resolved.
-    if (starting_size == internal_usages.size()) {
-      // Nothing could be resolved this loop; we have a cycle, so record the
-      // cycle and exit.
-      for (auto const& usage : internal_usages) {
-        unresolved.insert(usage.first);
+      stack.pop_back();
+      if (!stack.empty()) {
+        if (resolved) {
+          addTransitiveUsages(stack.back().Usage->first, name);
+        } else {
+          stack.back().Resolved = false;
+        }
       }
-      break;
     }
   }
 
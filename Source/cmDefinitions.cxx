@@ -15,11 +15,8 @@ cmDefinitions::Def const& cmDefinitions::GetInternal(std::string const& key,
                                                      StackIter end, bool raise)
 {
   assert(begin != end);
-  {
-    auto it = begin->Map.find(cm::String::borrow(key));
-    if (it != begin->Map.end()) {
-      return it->second;
-    }
+  if (Def const* def = begin->Map.Find(cm::String::borrow(key))) {
+    return *def;
   }
   StackIter it = begin;
   ++it;
@@ -30,7 +27,7 @@ cmDefinitions::Def const& cmDefinitions::GetInternal(std::string const& key,
   if (!raise) {
     return def;
   }
-  return begin->Map.emplace(key, def).first->second;
+  return begin->Assign(key, def);
 }
 
 cmValue cmDefinitions::Get(std::string const& key, StackIter begin,
@@ -50,7 +47,7 @@ bool cmDefinitions::HasKey(std::string const& key, StackIter begin,
                            StackIter end)
 {
   for (StackIter it = begin; it != end; ++it) {
-    if (it->Map.find(cm::String::borrow(key)) != it->Map.end()) {
+    if (it->Map.Find(cm::String::borrow(key))) {
       return true;
     }
   }
@@ -59,21 +56,29 @@ bool cmDefinitions::HasKey(std::string const& key, StackIter begin,
 
 cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
 {
-  cmDefinitions closure;
-  std::unordered_set<cm::string_view> undefined;
+  std::vector<cmDefinitions const*> scopes;
   for (StackIter it = begin; it != end; ++it) {
-    // Consider local definitions.
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first.view()) == undefined.end()) {
-        if (mi.second.Value) {
-          closure.Map.insert(mi);
-        } else {
-          undefined.emplace(mi.first.view());
-        }
+    scopes.push_back(&*it);
+  }
+
+  // Share the outermost scope's definitions and apply the (usually few)
+  // definitions of the inner scopes over them.
+  cmDefinitions closure;
+  if (scopes.empty()) {
+    return closure;
+  }
+  closure.Map = scopes.back()->Map;
+  for (cm::String const& key : scopes.back()->UnsetKeys) {
+    closure.Map.Erase(key);
+  }
+  for (auto si = scopes.rbegin() + 1; si != scopes.rend(); ++si) {
+    (*si)->Map.ForEach([&closure](cm::String const& key, Def const& def) {
+      if (def.Value) {
+        closure.Map.Set(key, def);
+      } else {
+        closure.Map.Erase(key);
       }
-    }
+    });
   }
   return closure;
 }
@@ -86,12 +91,12 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
 
   for (StackIter it = begin; it != end; ++it) {
     defined.reserve(defined.size() + it->Map.size());
-    for (auto const& mi : it->Map) {
+    it->Map.ForEach([&defined, &bound](cm::String const& key, Def const& def) {
       // Use this key if it is not already set or unset.
-      if (bound.emplace(mi.first.view()).second && mi.second.Value) {
-        defined.push_back(*mi.first.str_if_stable());
+      if (bound.emplace(key.view()).second && def.Value) {
+        defined.push_back(*key.str_if_stable());
       }
-    }
+    });
   }
 
   return defined;
@@ -99,10 +104,22 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
 
 void cmDefinitions::Set(std::string const& key, cm::string_view value)
 {
-  this->Map[key] = Def(value);
+  this->Assign(key, Def(value));
 }
 
 void cmDefinitions::Unset(std::string const& key)
 {
-  this->Map[key] = Def();
+  this->Assign(key, Def());
+}
+
+cmDefinitions::Def const& cmDefinitions::Assign(cm::String key, Def def)
+{
+  if (def.Value) {
+    if (!this->UnsetKeys.empty()) {
+      this->UnsetKeys.erase(key);
+    }
+  } else {
+    this->UnsetKeys.insert(key);
+  }
+  return this->Map.Set(std::move(key), std::move(def));
 }
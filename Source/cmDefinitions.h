@@ -5,12 +5,13 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <string>
-#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <cm/string_view>
 
 #include "cmLinkedTree.h"
+#include "cmPersistentHashMap.h"
 #include "cmString.hxx"
 #include "cmValue.h"
 
@@ -19,7 +20,9 @@
  *
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * transitively and save results locally.  Closures share storage with
+ * the scopes they are made from, so they cost memory only for the
+ * definitions that differ afterward.
  */
 class cmDefinitions
 {
@@ -60,7 +63,12 @@ private:
   };
   static Def NoDef;
 
-  std::unordered_map<cm::String, Def> Map;
+  Def const& Assign(cm::String key, Def def);
+
+  cmPersistentHashMap<cm::String, Def> Map;
+
+  /** Keys of Map whose definitions mark them as unset.  */
+  std::unordered_set<cm::String> UnsetKeys;
 
   static Def const& GetInternal(std::string const& key, StackIter begin,
                                 StackIter end, bool raise);
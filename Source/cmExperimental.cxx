@@ -70,6 +70,24 @@ cmExperimental::FeatureData const LookupTable[] = {
     "It is meant only for experimentation and feedback to CMake developers.",
     {},
     cmExperimental::TryCompileCondition::Never },
+  // IncrementalGenerate
+  { "IncrementalGenerate",
+    "ba1c8f5e-0071-421f-ac92-b77df7a82f38",
+    "CMAKE_EXPERIMENTAL_INCREMENTAL_GENERATE",
+    "CMake's support for skipping the generation of unchanged directories "
+    "is experimental. It is meant only for experimentation and feedback to "
+    "CMake developers.",
+    {},
+    cmExperimental::TryCompileCondition::Never },
+  // ConfigureSnapshot
+  { "ConfigureSnapshot",
+    "2f0c4d6e-8b1a-4e37-9c5d-73a1e0b6f4c8",
+    "CMAKE_EXPERIMENTAL_CONFIGURE_SNAPSHOT",
+    "CMake's support for skipping the configuration of unchanged build trees "
+    "is experimental. It is meant only for experimentation and feedback to "
+    "CMake developers.",
+    {},
+    cmExperimental::TryCompileCondition::Never },
 };
 static_assert(sizeof(LookupTable) / sizeof(LookupTable[0]) ==
                 static_cast<size_t>(cmExperimental::Feature::Sentinel),
@@ -23,6 +23,8 @@ public:
     ExportBuildDatabase,
     GenerateSbom,
     Rust,
+    IncrementalGenerate,
+    ConfigureSnapshot,
 
     Sentinel,
   };
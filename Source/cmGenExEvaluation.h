@@ -39,6 +39,9 @@ struct Evaluation final
   bool HadContextSensitiveCondition = false;
   bool HadHeadSensitiveCondition = false;
   bool HadLinkLanguageSensitiveCondition = false;
+  // Whether the result depends on nothing but the configuration and
+  // language of the context, so it may be reused for other targets.
+  bool ContextIndependent = true;
   bool EvaluateForBuildsystem;
 };
 
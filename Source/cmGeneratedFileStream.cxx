@@ -3,17 +3,28 @@
 #include "cmGeneratedFileStream.h"
 
 #include <cstdio>
+#include <functional>
 #include <locale>
+#include <utility>
 
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
 #if !defined(CMAKE_BOOTSTRAP)
+#  include <mutex>
+
 #  include <cm3p/zlib.h>
 
 #  include "cm_codecvt.hxx"
 #endif
 
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+std::mutex CloseCallbackMutex;
+std::function<void(std::string const&)> CloseCallback;
+}
+#endif
+
 cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
 {
 #ifndef CMAKE_BOOTSTRAP
@@ -100,6 +111,15 @@ void cmGeneratedFileStream::SetCopyIfDifferent(bool copy_if_different)
   this->CopyIfDifferent = copy_if_different;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+void cmGeneratedFileStream::SetCloseCallback(
+  std::function<void(std::string const&)> f)
+{
+  std::lock_guard<std::mutex> lock(CloseCallbackMutex);
+  CloseCallback = std::move(f);
+}
+#endif
+
 void cmGeneratedFileStream::SetCompression(bool compression)
 {
   this->Compress = compression;
@@ -159,6 +179,15 @@ bool cmGeneratedFileStreamBase::Close()
     resname += ".gz";
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  if (!this->Name.empty() && this->Okay) {
+    std::lock_guard<std::mutex> lock(CloseCallbackMutex);
+    if (CloseCallback) {
+      CloseCallback(resname);
+    }
+  }
+#endif
+
   // Only consider replacing the destination file if no error
   // occurred.
   if (!this->Name.empty() && this->Okay &&
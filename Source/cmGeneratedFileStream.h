@@ -4,6 +4,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <functional>
 #include <string>
 
 #include "cmsys/FStream.hxx"
@@ -135,6 +136,15 @@ public:
    */
   void SetCompressionExtraExtension(bool ext);
 
+#if !defined(CMAKE_BOOTSTRAP)
+  /**
+   * Set a function called with the name of the destination file of every
+   * stream that is closed successfully, or an empty function to stop.
+   * This is used to record the files written by a run of CMake.
+   */
+  static void SetCloseCallback(std::function<void(std::string const&)> f);
+#endif
+
   /**
    * Set name of the file that will hold the actual output. This method allows
    * the output file to be changed during the use of cmGeneratedFileStream.
@@ -43,8 +43,10 @@ std::unique_ptr<cmCompiledGeneratorExpression> cmGeneratorExpression::Parse(
   std::string input) const
 {
   return std::unique_ptr<cmCompiledGeneratorExpression>(
-    new cmCompiledGeneratorExpression(this->CMakeInstance, this->Backtrace,
-                                      std::move(input)));
+    new cmCompiledGeneratorExpression(
+      this->Backtrace,
+      this->CMakeInstance.GetGeneratorExpressionInterner()->Intern(
+        std::move(input))));
 }
 
 std::string cmGeneratorExpression::Evaluate(
@@ -60,8 +62,10 @@ std::string cmGeneratorExpression::Evaluate(
 #endif
 
     cm::GenEx::Context context(lg, config, language);
-    cmCompiledGeneratorExpression cge(*lg->GetCMakeInstance(),
-                                      cmListFileBacktrace(), std::move(input));
+    cmCompiledGeneratorExpression cge(
+      cmListFileBacktrace(),
+      lg->GetCMakeInstance()->GetGeneratorExpressionInterner()->Intern(
+        std::move(input)));
     return cge.Evaluate(context, dagChecker, headTarget, currentTarget);
   }
   return input;
@@ -85,13 +89,35 @@ std::string const& cmCompiledGeneratorExpression::Evaluate(
                              currentTarget ? currentTarget : headTarget,
                              this->EvaluateForBuildsystem, this->Backtrace);
 
-  if (!this->NeedsEvaluation) {
-    return this->Input;
+  cmGeneratorExpressionInterner::Entry const& parsed = *this->Parsed;
+  if (!parsed.NeedsEvaluation) {
+    return parsed.Input;
+  }
+
+  // $<CONFIG:...> may match the mapped configurations of an imported
+  // target, so only evaluations on behalf of other targets are memoized.
+  bool const memoize =
+    !eval.CurrentTarget || !eval.CurrentTarget->IsImported();
+  auto const memoKey = std::make_pair(context.Config, context.Language);
+  if (memoize) {
+    auto const memo = parsed.Results.find(memoKey);
+    if (memo != parsed.Results.end()) {
+      this->Output = memo->second.Output;
+      this->MaxLanguageStandard.clear();
+      this->HadContextSensitiveCondition =
+        memo->second.HadContextSensitiveCondition;
+      this->HadHeadSensitiveCondition = false;
+      this->HadLinkLanguageSensitiveCondition = false;
+      this->SourceSensitiveTargets.clear();
+      this->DependTargets.clear();
+      this->AllTargetsSeen.clear();
+      return this->Output;
+    }
   }
 
   this->Output.clear();
 
-  for (auto const& it : this->Evaluators) {
+  for (auto const& it : parsed.Evaluators) {
     this->Output += it->Evaluate(&eval, dagChecker);
 
     this->SeenTargetProperties.insert(eval.SeenTargetProperties.cbegin(),
@@ -114,27 +140,68 @@ std::string const& cmCompiledGeneratorExpression::Evaluate(
 
   this->DependTargets = eval.DependTargets;
   this->AllTargetsSeen = eval.AllTargets;
+
+  if (memoize && eval.ContextIndependent && !eval.HadError) {
+    parsed.Results.emplace(
+      memoKey,
+      cmGeneratorExpressionInterner::Entry::Result{
+        this->Output, this->HadContextSensitiveCondition });
+  }
   return this->Output;
 }
 
 cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
-  cmake& cmakeInstance, cmListFileBacktrace backtrace, std::string input)
+  cmListFileBacktrace backtrace,
+  std::shared_ptr<cmGeneratorExpressionInterner::Entry const> parsed)
   : Backtrace(std::move(backtrace))
-  , Input(std::move(input))
+  , Parsed(std::move(parsed))
+{
+}
+
+cmGeneratorExpressionInterner::Entry::Entry(std::string input)
+  : Input(std::move(input))
+{
+}
+
+cmGeneratorExpressionInterner::Entry::~Entry() = default;
+
+cmGeneratorExpressionInterner::cmGeneratorExpressionInterner(
+  cmake& cmakeInstance)
+  : CMakeInstance(cmakeInstance)
+{
+}
+
+std::shared_ptr<cmGeneratorExpressionInterner::Entry const>
+cmGeneratorExpressionInterner::Intern(std::string input)
 {
+  // Plain strings cannot contain an expression; do not keep them around.
+  if (cmGeneratorExpression::Find(input) == cm::string_view::npos) {
+    return std::make_shared<Entry const>(std::move(input));
+  }
+
+  auto it = this->Entries.find(input);
+  if (it != this->Entries.end()) {
+    return it->second;
+  }
+
 #ifndef CMAKE_BOOTSTRAP
   auto profilingRAII =
-    cmakeInstance.CreateProfilingEntry("genex_compile", this->Input);
+    this->CMakeInstance.CreateProfilingEntry("genex_compile", input);
 #endif
 
+  auto entry = std::make_shared<Entry>(input);
+
   cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(entry->Input);
+  entry->NeedsEvaluation = l.GetSawGeneratorExpression();
 
-  if (this->NeedsEvaluation) {
+  if (entry->NeedsEvaluation) {
     cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
+    p.Parse(entry->Evaluators);
   }
+
+  return this->Entries.emplace(std::move(input), std::move(entry))
+    .first->second;
 }
 
 std::string cmGeneratorExpression::StripEmptyListElements(
@@ -8,6 +8,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -108,6 +109,48 @@ private:
   cmListFileBacktrace Backtrace;
 };
 
+/** \class cmGeneratorExpressionInterner
+ * \brief Share parsed generator expressions among equal input strings.
+ *
+ * The same expression text is typically parsed once per target that
+ * inherits it from a directory property.  The interner keeps one parse
+ * per distinct input for the lifetime of the cmake instance, along with
+ * the results of evaluations that depended only on the configuration
+ * and language of the evaluation context.
+ */
+class cmGeneratorExpressionInterner
+{
+public:
+  struct Entry
+  {
+    Entry(std::string input);
+    ~Entry();
+
+    Entry(Entry const&) = delete;
+    Entry& operator=(Entry const&) = delete;
+
+    struct Result
+    {
+      std::string Output;
+      bool HadContextSensitiveCondition;
+    };
+
+    // The evaluators point into Input, so both live here together.
+    std::string const Input;
+    std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
+    bool NeedsEvaluation = false;
+    mutable std::map<std::pair<std::string, std::string>, Result> Results;
+  };
+
+  cmGeneratorExpressionInterner(cmake& cmakeInstance);
+
+  std::shared_ptr<Entry const> Intern(std::string input);
+
+private:
+  cmake& CMakeInstance;
+  std::unordered_map<std::string, std::shared_ptr<Entry const>> Entries;
+};
+
 class cmCompiledGeneratorExpression
 {
 public:
@@ -143,7 +186,7 @@ public:
     return this->AllTargetsSeen;
   }
 
-  std::string const& GetInput() const { return this->Input; }
+  std::string const& GetInput() const { return this->Parsed->Input; }
 
   cmListFileBacktrace GetBacktrace() const { return this->Backtrace; }
   bool GetHadContextSensitiveCondition() const
@@ -174,16 +217,14 @@ public:
                               std::map<std::string, std::string>& mapping);
 
 private:
-  cmCompiledGeneratorExpression(cmake& cmakeInstance,
-                                cmListFileBacktrace backtrace,
-                                std::string input);
+  cmCompiledGeneratorExpression(
+    cmListFileBacktrace backtrace,
+    std::shared_ptr<cmGeneratorExpressionInterner::Entry const> parsed);
 
   friend class cmGeneratorExpression;
 
   cmListFileBacktrace Backtrace;
-  std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
-  std::string const Input;
-  bool NeedsEvaluation;
+  std::shared_ptr<cmGeneratorExpressionInterner::Entry const> Parsed;
   bool EvaluateForBuildsystem = false;
   bool Quiet = false;
 
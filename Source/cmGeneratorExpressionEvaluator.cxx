@@ -90,6 +90,10 @@ std::string GeneratorExpressionContent::Evaluate(
     return std::string();
   }
 
+  if (!node->IsContextIndependent()) {
+    eval->ContextIndependent = false;
+  }
+
   if (!node->GeneratesContent()) {
     if (node->NumExpectedParameters() == 1 &&
         node->AcceptsArbitraryContentParameter()) {
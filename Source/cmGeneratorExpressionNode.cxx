@@ -112,6 +112,8 @@ static const struct ZeroNode : public cmGeneratorExpressionNode
 {
   ZeroNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool GeneratesContent() const override { return false; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -130,6 +132,8 @@ static const struct OneNode : public cmGeneratorExpressionNode
 {
   OneNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -158,6 +162,8 @@ struct BooleanOpNode : public cmGeneratorExpressionNode
   {
   }
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return OneOrMoreParameters; }
 
   bool ShouldEvaluateNextParameter(std::vector<std::string> const& parameters,
@@ -199,6 +205,8 @@ static const struct NotNode : public cmGeneratorExpressionNode
 {
   NotNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   std::string Evaluate(
     std::vector<std::string> const& parameters, cm::GenEx::Evaluation* eval,
     GeneratorExpressionContent const* content,
@@ -218,6 +226,8 @@ static const struct BoolNode : public cmGeneratorExpressionNode
 {
   BoolNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -234,6 +244,8 @@ static const struct IfNode : public cmGeneratorExpressionNode
 {
   IfNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   bool ShouldEvaluateNextParameter(std::vector<std::string> const& parameters,
@@ -262,6 +274,8 @@ static const struct StrEqualNode : public cmGeneratorExpressionNode
 {
   StrEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -280,6 +294,8 @@ static const struct StrLessNode : public cmGeneratorExpressionNode
 {
   StrLessNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -298,6 +314,8 @@ static const struct StrLessEqualNode : public cmGeneratorExpressionNode
 {
   StrLessEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -316,6 +334,8 @@ static const struct StrGreaterNode : public cmGeneratorExpressionNode
 {
   StrGreaterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -334,6 +354,8 @@ static const struct StrGreaterEqualNode : public cmGeneratorExpressionNode
 {
   StrGreaterEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -353,6 +375,8 @@ static const struct EqualNode : public cmGeneratorExpressionNode
 {
   EqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -450,6 +474,8 @@ static const struct FilterNode : public cmGeneratorExpressionNode
 {
   FilterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(
@@ -488,6 +514,8 @@ static const struct RemoveDuplicatesNode : public cmGeneratorExpressionNode
 {
   RemoveDuplicatesNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -683,6 +711,8 @@ static const struct LowerCaseNode : public cmGeneratorExpressionNode
 {
   LowerCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -699,6 +729,8 @@ static const struct UpperCaseNode : public cmGeneratorExpressionNode
 {
   UpperCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -861,6 +893,8 @@ static const struct PathNode : public cmGeneratorExpressionNode
 {
   PathNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return TwoOrMoreParameters; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -1278,6 +1312,8 @@ static const struct PathEqualNode : public cmGeneratorExpressionNode
 {
   PathEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -2453,6 +2489,8 @@ static const struct MakeCIdentifierNode : public cmGeneratorExpressionNode
 {
   MakeCIdentifierNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -2470,6 +2508,8 @@ struct CharacterNode : public cmGeneratorExpressionNode
 {
   CharacterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -2720,6 +2760,8 @@ struct VersionNode : public cmGeneratorExpressionNode
 {
   VersionNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -2786,6 +2828,8 @@ static const struct ConfigurationNode : public cmGeneratorExpressionNode
 {
   ConfigurationNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -2802,6 +2846,8 @@ static const struct ConfigurationTestNode : public cmGeneratorExpressionNode
 {
   ConfigurationTestNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -2833,6 +2879,7 @@ static const struct ConfigurationTestNode : public cmGeneratorExpressionNode
           << "  " << content->GetOriginalExpression() << "\n"
           << "The config name of \"" << param << "\" is invalid";
         /* clang-format on */
+        eval->ContextIndependent = false;
         eval->Context.LG->GetCMakeInstance()->IssueMessage(
           MessageType::WARNING, e.str(), eval->Backtrace);
       }
@@ -2969,6 +3016,8 @@ static const struct JoinNode : public cmGeneratorExpressionNode
 {
   JoinNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -35,6 +35,10 @@ struct cmGeneratorExpressionNode
 
   virtual bool AcceptsArbitraryContentParameter() const { return false; }
 
+  // Whether Evaluate reads nothing but its parameters and the
+  // configuration and language of the evaluation context.
+  virtual bool IsContextIndependent() const { return false; }
+
   virtual int NumExpectedParameters() const { return 1; }
 
   virtual bool ShouldEvaluateNextParameter(std::vector<std::string> const&,
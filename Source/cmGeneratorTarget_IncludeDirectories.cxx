@@ -16,6 +16,10 @@
 #include <cm/optional>
 #include <cmext/algorithm>
 
+#ifndef CMAKE_BOOTSTRAP
+#  include <cm3p/json/value.h>
+#endif
+
 #include "cmEvaluatedTargetProperty.h"
 #include "cmGenExContext.h"
 #include "cmGeneratorExpressionDAGChecker.h"
@@ -221,6 +225,19 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
       return it->second;
     }
   }
+#ifndef CMAKE_BOOTSTRAP
+  auto profilingRAII = this->GetLocalGenerator()
+                         ->GetCMakeInstance()
+                         ->CreateProfilingEntry(
+                           "target", "INCLUDE_DIRECTORIES",
+                           [this, &config, &lang]() {
+                             Json::Value args = Json::objectValue;
+                             args["target"] = this->GetName();
+                             args["config"] = config;
+                             args["language"] = lang;
+                             return args;
+                           });
+#endif
   std::vector<BT<std::string>> includes;
   std::unordered_set<std::string> uniqueIncludes;
 
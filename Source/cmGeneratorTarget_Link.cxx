@@ -22,6 +22,10 @@
 #include <cmext/algorithm>
 #include <cmext/string_view>
 
+#ifndef CMAKE_BOOTSTRAP
+#  include <cm3p/json/value.h>
+#endif
+
 #include "cmAlgorithms.h"
 #include "cmComputeLinkInformation.h"
 #include "cmDiagnostics.h"
@@ -138,6 +142,17 @@ cmGeneratorTarget::LinkClosure const* cmGeneratorTarget::GetLinkClosure(
   std::string key(cmSystemTools::UpperCase(config));
   auto i = this->LinkClosureMap.find(key);
   if (i == this->LinkClosureMap.end()) {
+#ifndef CMAKE_BOOTSTRAP
+    auto profilingRAII = this->GetLocalGenerator()
+                           ->GetCMakeInstance()
+                           ->CreateProfilingEntry(
+                             "target", "LINK_CLOSURE", [this, &config]() {
+                               Json::Value args = Json::objectValue;
+                               args["target"] = this->GetName();
+                               args["config"] = config;
+                               return args;
+                             });
+#endif
     LinkClosure lc;
     this->ComputeLinkClosure(config, lc);
     LinkClosureMapType::value_type entry(key, lc);
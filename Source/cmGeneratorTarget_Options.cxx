@@ -17,6 +17,10 @@
 #include <cmext/algorithm>
 #include <cmext/string_view>
 
+#ifndef CMAKE_BOOTSTRAP
+#  include <cm3p/json/value.h>
+#endif
+
 #include "cmEvaluatedTargetProperty.h"
 #include "cmGenExContext.h"
 #include "cmGeneratorExpressionDAGChecker.h"
@@ -273,6 +277,19 @@ std::vector<BT<std::string>> cmGeneratorTarget::GetCompileOptions(
       return it->second;
     }
   }
+#ifndef CMAKE_BOOTSTRAP
+  auto profilingRAII = this->GetLocalGenerator()
+                         ->GetCMakeInstance()
+                         ->CreateProfilingEntry(
+                           "target", "COMPILE_OPTIONS",
+                           [this, &config, &language]() {
+                             Json::Value args = Json::objectValue;
+                             args["target"] = this->GetName();
+                             args["config"] = config;
+                             args["language"] = language;
+                             return args;
+                           });
+#endif
   std::vector<BT<std::string>> result;
   std::unordered_set<std::string> uniqueOptions;
 
@@ -63,6 +63,8 @@
 #include "cmStringAlgorithms.h"
 #include "cmSyntheticTargetCache.h"
 #include "cmSystemTools.h"
+#include "cmTest.h"
+#include "cmTestGenerator.h"
 #include "cmValue.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
@@ -74,6 +76,7 @@
 #  include <cm3p/json/writer.h>
 
 #  include "cmQtAutoGenGlobalInitializer.h"
+#  include "cmWorkerPool.h"
 #endif
 
 std::string const kCMAKE_PLATFORM_INFO_INITIALIZED =
@@ -1478,6 +1481,11 @@ bool cmGlobalGenerator::UnsupportedVariableIsDefined(std::string const& name,
 
 bool cmGlobalGenerator::Compute()
 {
+#ifndef CMAKE_BOOTSTRAP
+  auto profilingRAII =
+    this->GetCMakeInstance()->CreateProfilingEntry("project", "compute");
+#endif
+
   // Make sure unsupported variables are not used.
   if (this->UnsupportedVariableIsDefined("CMAKE_DEFAULT_BUILD_TYPE",
                                          this->SupportsDefaultBuildType())) {
@@ -1673,8 +1681,14 @@ bool cmGlobalGenerator::Compute()
 
   // Trace the dependencies, after that no custom commands should be added
   // because their dependencies might not be handled correctly
-  for (auto const& localGen : this->LocalGenerators) {
-    localGen->TraceDependencies();
+  {
+#ifndef CMAKE_BOOTSTRAP
+    auto traceProfilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+      "compute", "trace_dependencies");
+#endif
+    for (auto const& localGen : this->LocalGenerators) {
+      localGen->TraceDependencies();
+    }
   }
 
   // Make sure that all (non-imported) targets have source files added!
@@ -1743,6 +1757,9 @@ void cmGlobalGenerator::Generate()
         0.9f * (static_cast<float>(i) + 1.0f) /
           static_cast<float>(this->LocalGenerators.size()));
   }
+#if !defined(CMAKE_BOOTSTRAP)
+  this->WriteTestImpactIndex();
+#endif
   this->SetCurrentMakefile(nullptr);
 
   if (!this->GenerateCPackPropertiesFile()) {
@@ -1820,10 +1837,151 @@ void cmGlobalGenerator::WriteInstallJson() const
              "/CMakeFiles/InstallScripts.json"),
     index);
 }
+
+void cmGlobalGenerator::WriteTestImpactIndex()
+{
+  std::string const file =
+    cmStrCat(this->CMakeInstance->GetHomeOutputDirectory(),
+             "/CMakeFiles/TestImpact.json");
+  if (!this->GlobalSettingIsOn("CMAKE_EXPORT_TEST_IMPACT")) {
+    cmSystemTools::RemoveFile(file);
+    return;
+  }
+
+  // Collect the targets and files used by each test.
+  Json::Value tests = Json::arrayValue;
+  std::vector<cmGeneratorTarget const*> targets;
+  std::map<cmGeneratorTarget const*, Json::ArrayIndex> targetIndex;
+  auto addTarget = [&](cmGeneratorTarget const* gt) -> Json::ArrayIndex {
+    auto i = targetIndex.emplace(gt, targetIndex.size());
+    if (i.second) {
+      targets.push_back(gt);
+    }
+    return i.first->second;
+  };
+  for (auto const& lg : this->LocalGenerators) {
+    cmMakefile const* mf = lg->GetMakefile();
+    if (!mf->IsOn("CMAKE_TESTING_ENABLED")) {
+      continue;
+    }
+    for (auto const& tester : mf->GetTestGenerators()) {
+      std::set<cmGeneratorTarget const*> testTargets;
+      std::set<std::string> testFiles;
+      if (!tester->GetTest() ||
+          !tester->GetImpactInputs(testTargets, testFiles)) {
+        continue;
+      }
+      Json::Value test = Json::objectValue;
+      test["name"] = tester->GetTest()->GetName();
+      test["directory"] = lg->GetCurrentBinaryDirectory();
+      Json::Value& jTargets = test["targets"] = Json::arrayValue;
+      for (cmGeneratorTarget const* gt : testTargets) {
+        if (!gt->IsImported()) {
+          jTargets.append(addTarget(gt));
+        }
+      }
+      Json::Value& jFiles = test["files"] = Json::arrayValue;
+      for (std::string const& f : testFiles) {
+        jFiles.append(f);
+      }
+      tests.append(std::move(test));
+    }
+  }
+  if (tests.empty()) {
+    cmSystemTools::RemoveFile(file);
+    return;
+  }
+
+  // List the other targets too so that ctest knows their sources.  A
+  // changed file that is not in the index may affect any test.
+  for (auto const& lg : this->LocalGenerators) {
+    for (auto const& gt : lg->GetGeneratorTargets()) {
+      if (gt->IsInBuildSystem()) {
+        addTarget(gt.get());
+      }
+    }
+  }
+
+  // Describe the targets and the targets on which they depend.  The list
+  // grows as dependencies are added.
+  Json::Value jTargets = Json::arrayValue;
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    cmGeneratorTarget const* gt = targets[i];
+    Json::Value target = Json::objectValue;
+    target["name"] = gt->GetName();
+
+    std::set<std::string> sources;
+    for (std::string const& config :
+         gt->Makefile->GetGeneratorConfigs(cmMakefile::IncludeEmptyConfig)) {
+      std::vector<cmSourceFile*> files;
+      gt->GetSourceFiles(files, config);
+      for (cmSourceFile const* sf : files) {
+        sources.insert(sf->GetFullPath());
+        // A generated source changes with the files it is generated from.
+        if (cmCustomCommand const* cc = sf->GetCustomCommand()) {
+          for (std::string const& depend : cc->GetDepends()) {
+            if (cmSystemTools::FileIsFullPath(depend)) {
+              sources.insert(depend);
+            }
+          }
+        }
+      }
+    }
+    Json::Value& jSources = target["sources"] = Json::arrayValue;
+    for (std::string const& source : sources) {
+      jSources.append(source);
+    }
+
+    Json::Value& jDepends = target["dependencies"] = Json::arrayValue;
+    for (cmTargetDepend const& dep : this->GetTargetDirectDepends(gt)) {
+      cmGeneratorTarget const* dt = dep;
+      if (!dt->IsImported()) {
+        jDepends.append(addTarget(dt));
+      }
+    }
+    jTargets.append(std::move(target));
+  }
+
+  // A change to the project's CMake code may change any test.  The
+  // modules of CMake itself change only with CMake.
+  std::string const modules =
+    cmStrCat(cmSystemTools::GetCMakeRoot(), "/Modules");
+  std::set<std::string> listFiles;
+  for (auto const& lg : this->LocalGenerators) {
+    for (std::string const& f : lg->GetMakefile()->GetListFiles()) {
+      if (!cmSystemTools::IsSubDirectory(f, modules)) {
+        listFiles.insert(f);
+      }
+    }
+  }
+
+  Json::Value root = Json::objectValue;
+  Json::Value& version = root["version"] = Json::objectValue;
+  version["major"] = 1;
+  version["minor"] = 0;
+  root["sourceDirectory"] = this->CMakeInstance->GetHomeDirectory();
+  Json::Value& jListFiles = root["listFiles"] = Json::arrayValue;
+  for (std::string const& f : listFiles) {
+    jListFiles.append(f);
+  }
+  root["targets"] = std::move(jTargets);
+  root["tests"] = std::move(tests);
+
+  cmGeneratedFileStream fout(file);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> const writer(builder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+}
 #endif
 
 bool cmGlobalGenerator::ComputeTargetDepends()
 {
+#ifndef CMAKE_BOOTSTRAP
+  auto profilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+    "compute", "target_depends");
+#endif
   cmComputeTargetDepends ctd(this);
   if (!ctd.Compute()) {
     return false;
@@ -2327,6 +2485,137 @@ int cmGlobalGenerator::TryCompile(int jobs, std::string const& bindir,
   return ret;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+class TryCompileBuildJob : public cmWorkerPool::JobT
+{
+public:
+  TryCompileBuildJob(
+    cmGlobalGenerator::TryCompileBuild& build,
+    std::vector<cmGlobalGenerator::GeneratedMakeCommand> makeCommand,
+    bool isWatcomWMake, cmDuration timeout)
+    : Build(build)
+    , MakeCommand(std::move(makeCommand))
+    , IsWatcomWMake(isWatcomWMake)
+    , Timeout(timeout)
+  {
+  }
+
+private:
+  // Record the output the way cmGlobalGenerator::Build does.
+  void Process() override
+  {
+    std::string& output = this->Build.Output;
+    output = cmStrCat("Change Dir: '", this->Build.BinaryDirectory,
+                      "'\n\nRun Build Command(s): ");
+    std::string buildOutput;
+    int retVal = 0;
+    for (auto command = this->MakeCommand.begin();
+         command != this->MakeCommand.end() && retVal == 0; ++command) {
+      std::string commandStr = command->QuotedPrintable();
+      if ((command + 1) != this->MakeCommand.end()) {
+        commandStr += " && ";
+      }
+      output = cmStrCat(output, commandStr, '\n');
+
+      cmWorkerPool::ProcessResultT result;
+      this->RunProcess(result, command->PrimaryCommand,
+                       this->Build.BinaryDirectory, this->Timeout);
+      output += result.StdOut;
+      // A tool that exits with an error code ran.  Any other error, such
+      // as a timeout, means the tool could not run to completion.
+      if (result.ExitStatus == 0 && !result.ErrorMessage.empty()) {
+        output = cmStrCat(
+          output, "\nGenerator: build tool execution failed, command was: ",
+          commandStr, '\n');
+        this->Build.Result = 1;
+        return;
+      }
+      if (this->IsWatcomWMake) {
+        buildOutput += result.StdOut;
+      }
+      retVal = static_cast<int>(result.ExitStatus);
+    }
+    output += '\n';
+
+    // The OpenWatcom tools do not return an error code when a link
+    // library is not found!
+    if (this->IsWatcomWMake && retVal == 0 &&
+        buildOutput.find("W1008: cannot open") != std::string::npos) {
+      retVal = 1;
+    }
+    this->Build.Result = retVal;
+  }
+
+  cmGlobalGenerator::TryCompileBuild& Build;
+  std::vector<cmGlobalGenerator::GeneratedMakeCommand> MakeCommand;
+  bool IsWatcomWMake;
+  cmDuration Timeout;
+};
+
+class TryCompileBatchEndJob : public cmWorkerPool::JobFenceT
+{
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+#endif
+
+void cmGlobalGenerator::TryCompileBatch(unsigned int jobs,
+                                        std::vector<TryCompileBuild>& builds,
+                                        cmMakefile* mf)
+{
+  // See cmMakefile::TryCompile.
+  cm::optional<cmSystemTools::ScopedEnv> maybeNinjaStatus;
+  if (this->IsNinja()) {
+    maybeNinjaStatus.emplace("NINJA_STATUS=");
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  if (jobs > 1 && builds.size() > 1) {
+    std::string config =
+      mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+    if (config.empty()) {
+      config = this->GetDefaultBuildConfig();
+    }
+    bool const isWatcomWMake =
+      this->CMakeInstance->GetState()->UseWatcomWMake();
+
+    // The generator is not thread-safe, so compute the build commands
+    // before starting any build.
+    cmWorkerPool pool;
+    pool.SetThreadCount(static_cast<unsigned int>(
+      std::min<std::size_t>(jobs, builds.size())));
+    for (TryCompileBuild& build : builds) {
+      std::vector<std::string> targets;
+      if (!build.TargetName.empty()) {
+        targets = { build.TargetName };
+      }
+      cmBuildOptions buildOptions(false, build.Fast,
+                                  PackageResolveMode::Disable);
+      pool.EmplaceJob<TryCompileBuildJob>(
+        build,
+        this->GenerateBuildCommand("", build.ProjectName,
+                                   build.BinaryDirectory, targets, config,
+                                   cmake::NO_BUILD_PARALLEL_LEVEL, true,
+                                   buildOptions, {}, BuildTryCompile::Yes),
+        isWatcomWMake, this->TryCompileTimeout);
+    }
+    pool.EmplaceJob<TryCompileBatchEndJob>();
+    pool.Process();
+    return;
+  }
+#else
+  static_cast<void>(jobs);
+#endif
+
+  for (TryCompileBuild& build : builds) {
+    build.Result =
+      this->TryCompile(cmake::NO_BUILD_PARALLEL_LEVEL, build.BinaryDirectory,
+                       build.ProjectName, build.TargetName, build.Fast,
+                       build.Output, mf);
+  }
+}
+
 std::vector<cmGlobalGenerator::GeneratedMakeCommand>
 cmGlobalGenerator::GenerateBuildCommand(
   std::string const& /*unused*/, std::string const& /*unused*/,
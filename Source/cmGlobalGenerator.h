@@ -253,6 +253,25 @@ public:
                  std::string const& projectName, std::string const& targetName,
                  bool fast, std::string& output, cmMakefile* mf);
 
+  struct TryCompileBuild
+  {
+    std::string BinaryDirectory;
+    std::string ProjectName;
+    std::string TargetName;
+    bool Fast = false;
+
+    int Result = 1;
+    std::string Output;
+  };
+
+  /**
+   * Build several generated try_compile projects, running up to jobs
+   * builds at a time.  Each build gets the result and output TryCompile
+   * would give it.
+   */
+  void TryCompileBatch(unsigned int jobs,
+                       std::vector<TryCompileBuild>& builds, cmMakefile* mf);
+
   /**
    * Build a file given the following information. This is a more direct call
    * that is used by both CTest and TryCompile. If target name is NULL or
@@ -751,6 +770,7 @@ protected:
   void WriteJsonContent(std::string const& fname,
                         Json::Value const& value) const;
   void WriteInstallJson() const;
+  void WriteTestImpactIndex();
 #endif
 
   virtual bool CheckALLOW_DUPLICATE_CUSTOM_TARGETS() const;
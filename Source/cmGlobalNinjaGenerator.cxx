@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <functional>
 #include <iterator>
+#include <set>
 #include <sstream>
 #include <utility>
 
@@ -621,6 +622,8 @@ void cmGlobalNinjaGenerator::Generate()
     return;
   }
   this->InitOutputPathPrefix();
+  this->SplitBuildFile = !this->IsMultiConfig() &&
+    this->GlobalSettingIsOn("CMAKE_NINJA_SPLIT_BUILD_FILE");
   if (!this->OpenBuildFileStreams()) {
     return;
   }
@@ -1089,6 +1092,42 @@ bool cmGlobalNinjaGenerator::OpenBuildFileStreams()
   return true;
 }
 
+bool cmGlobalNinjaGenerator::OpenDirectoryFileStream(
+  cmLocalGenerator const* lg)
+{
+  if (!this->SplitBuildFile) {
+    return true;
+  }
+
+  std::string const name = lg->MaybeRelativeToTopBinDir(
+    cmStrCat(lg->GetCurrentBinaryDirectory(), "/CMakeFiles/directory.ninja"));
+  if (!this->OpenFileStream(this->DirectoryFileStream, name)) {
+    return false;
+  }
+  // Keep the time stamps of files whose content did not change.
+  this->DirectoryFileStream->SetCopyIfDifferent(true);
+  *this->DirectoryFileStream
+    << "# This file contains the build statements of the directory\n"
+    << "# " << lg->GetCurrentBinaryDirectory() << "\n"
+    << "# It is included by the main '" << NINJA_BUILD_FILE << "'.\n\n";
+
+  *this->BuildFileStream << "subninja "
+                         << this->EncodePath(this->NinjaOutputPath(name))
+                         << "\n\n";
+  return true;
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryFileStream()
+{
+  if (!this->DirectoryFileStream) {
+    return;
+  }
+  if (cmSystemTools::GetErrorOccurredFlag()) {
+    this->DirectoryFileStream->setstate(std::ios::failbit);
+  }
+  this->DirectoryFileStream.reset();
+}
+
 bool cmGlobalNinjaGenerator::OpenFileStream(
   std::unique_ptr<cmGeneratedFileStream>& stream, std::string const& name)
 {
@@ -2582,6 +2621,84 @@ cm::optional<cmSourceInfo> cmcmd_cmake_ninja_depends_fortran(
 }
 }
 
+namespace {
+cm::static_string_view LookupMethodName(LookupMethod method)
+{
+  switch (method) {
+    case LookupMethod::ByName:
+      return "by-name"_s;
+    case LookupMethod::IncludeAngle:
+      return "include-angle"_s;
+    case LookupMethod::IncludeQuote:
+      return "include-quote"_s;
+  }
+  assert(false && "unsupported lookup method");
+  return ""_s;
+}
+
+CxxModuleReference ReadModuleReference(Json::Value const& reference)
+{
+  CxxModuleReference module_reference;
+  Json::Value const& reference_path = reference["path"];
+  if (reference_path.isString()) {
+    module_reference.Path = reference_path.asString();
+  }
+  Json::Value const& reference_method = reference["lookup-method"];
+  if (reference_method.isString()) {
+    std::string method = reference_method.asString();
+    if (method == "by-name") {
+      module_reference.Method = LookupMethod::ByName;
+    } else if (method == "include-angle") {
+      module_reference.Method = LookupMethod::IncludeAngle;
+    } else if (method == "include-quote") {
+      module_reference.Method = LookupMethod::IncludeQuote;
+    }
+  }
+  return module_reference;
+}
+
+// The usages of a target hold the transitive imports of each of its
+// modules, and those of the targets it links to, so they grow with the
+// square of the depth of the import graph.  Write them out directly
+// rather than building a JSON value of them first.
+void WriteModuleInfo(std::ostream& os, Json::Value const& modules,
+                     CxxModuleUsage const& usages)
+{
+  auto quoted = [](std::string const& str) -> std::string {
+    return Json::valueToQuotedString(str.c_str());
+  };
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> const writer(builder.newStreamWriter());
+  os << "{\n\t\"modules\" : ";
+  writer->write(modules, &os);
+
+  os << ",\n\t\"references\" : {";
+  char const* sep = "\n";
+  for (auto const& r : usages.Reference) {
+    os << sep << "\t\t" << quoted(r.first) << " : { \"lookup-method\" : \""
+       << LookupMethodName(r.second.Method)
+       << "\", \"path\" : " << quoted(r.second.Path) << " }";
+    sep = ",\n";
+  }
+
+  os << "\n\t},\n\t\"usages\" : {";
+  sep = "\n";
+  for (auto const& u : usages.Usage) {
+    os << sep << "\t\t" << quoted(u.first) << " : [";
+    char const* item_sep = "";
+    for (std::string const& v : u.second) {
+      os << item_sep << quoted(v);
+      item_sep = ", ";
+    }
+    os << ']';
+    sep = ",\n";
+  }
+  os << "\n\t}\n}\n";
+}
+}
+
 bool cmGlobalNinjaGenerator::WriteDyndepFile(
   std::string const& dir_top_src, std::string const& dir_top_bld,
   std::string const& dir_cur_src, std::string const& dir_cur_bld,
@@ -2663,23 +2780,7 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
         for (auto i = target_modules_references.begin();
              i != target_modules_references.end(); ++i) {
           if (i->isObject()) {
-            Json::Value const& reference_path = (*i)["path"];
-            CxxModuleReference module_reference;
-            if (reference_path.isString()) {
-              module_reference.Path = reference_path.asString();
-            }
-            Json::Value const& reference_method = (*i)["lookup-method"];
-            if (reference_method.isString()) {
-              std::string reference = reference_method.asString();
-              if (reference == "by-name") {
-                module_reference.Method = LookupMethod::ByName;
-              } else if (reference == "include-angle") {
-                module_reference.Method = LookupMethod::IncludeAngle;
-              } else if (reference == "include-quote") {
-                module_reference.Method = LookupMethod::IncludeQuote;
-              }
-            }
-            usages.Reference[i.key().asString()] = module_reference;
+            usages.Reference[i.key().asString()] = ReadModuleReference(*i);
           }
         }
       }
@@ -2881,38 +2982,6 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
     }
   }
 
-  Json::Value target_module_info = Json::objectValue;
-  target_module_info["modules"] = target_modules;
-
-  auto& target_usages = target_module_info["usages"] = Json::objectValue;
-  for (auto const& u : usages.Usage) {
-    auto& mod_usage = target_usages[u.first] = Json::arrayValue;
-    for (auto const& v : u.second) {
-      mod_usage.append(v);
-    }
-  }
-
-  auto name_for_method = [](LookupMethod method) -> cm::static_string_view {
-    switch (method) {
-      case LookupMethod::ByName:
-        return "by-name"_s;
-      case LookupMethod::IncludeAngle:
-        return "include-angle"_s;
-      case LookupMethod::IncludeQuote:
-        return "include-quote"_s;
-    }
-    assert(false && "unsupported lookup method");
-    return ""_s;
-  };
-
-  auto& target_references = target_module_info["references"] =
-    Json::objectValue;
-  for (auto const& r : usages.Reference) {
-    auto& mod_ref = target_references[r.first] = Json::objectValue;
-    mod_ref["path"] = r.second.Path;
-    mod_ref["lookup-method"] = std::string(name_for_method(r.second.Method));
-  }
-
   // Store the map of modules provided by this target in a file for
   // use by dependents that reference this target in linked-target-dirs.
   std::string const target_mods_file = cmStrCat(
@@ -2941,30 +3010,43 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
       continue;
     }
 
-    auto forward_info = [](Json::Value& target, Json::Value const& source) {
-      if (!source.isObject()) {
-        return;
-      }
-
-      for (auto i = source.begin(); i != source.end(); ++i) {
+    // Forward info from forwarding targets into our collation.
+    Json::Value const& forward_modules = fmft["modules"];
+    if (forward_modules.isObject()) {
+      for (auto i = forward_modules.begin(); i != forward_modules.end(); ++i) {
         std::string const key = i.key().asString();
-        if (target.isMember(key)) {
-          continue;
+        if (!target_modules.isMember(key)) {
+          target_modules[key] = *i;
         }
-        target[key] = *i;
       }
-    };
-
-    // Forward info from forwarding targets into our collation.
-    Json::Value& tmi_target_modules = target_module_info["modules"];
-    forward_info(tmi_target_modules, fmft["modules"]);
-    forward_info(target_references, fmft["references"]);
-    forward_info(target_usages, fmft["usages"]);
+    }
+    Json::Value const& forward_references = fmft["references"];
+    if (forward_references.isObject()) {
+      for (auto i = forward_references.begin(); i != forward_references.end();
+           ++i) {
+        if (i->isObject()) {
+          usages.Reference.emplace(i.key().asString(),
+                                   ReadModuleReference(*i));
+        }
+      }
+    }
+    Json::Value const& forward_usages = fmft["usages"];
+    if (forward_usages.isObject()) {
+      for (auto i = forward_usages.begin(); i != forward_usages.end(); ++i) {
+        auto usage = usages.Usage.emplace(i.key().asString(),
+                                          std::set<std::string>());
+        if (usage.second && i->isArray()) {
+          for (auto const& j : *i) {
+            usage.first->second.insert(j.asString());
+          }
+        }
+      }
+    }
   }
 
   cmGeneratedFileStream tmf(target_mods_file);
   tmf.SetCopyIfDifferent(true);
-  tmf << target_module_info;
+  WriteModuleInfo(tmf, target_modules, usages);
 
   cmDyndepMetadataCallbacks cb;
   cb.ModuleFile =
@@ -239,25 +239,30 @@ public:
   virtual cmGeneratedFileStream* GetImplFileStream(
     std::string const& /*config*/) const
   {
-    return this->BuildFileStream.get();
+    return this->GetBuildFileStream();
   }
 
   virtual cmGeneratedFileStream* GetConfigFileStream(
     std::string const& /*config*/) const
   {
-    return this->BuildFileStream.get();
+    return this->GetBuildFileStream();
   }
 
   virtual cmGeneratedFileStream* GetDefaultFileStream() const
   {
-    return this->BuildFileStream.get();
+    return this->GetBuildFileStream();
   }
 
   virtual cmGeneratedFileStream* GetCommonFileStream() const
   {
-    return this->BuildFileStream.get();
+    return this->GetBuildFileStream();
   }
 
+  /// Write the build statements of a directory to its own file, included
+  /// by the main build file, if CMAKE_NINJA_SPLIT_BUILD_FILE is enabled.
+  bool OpenDirectoryFileStream(cmLocalGenerator const* lg);
+  void CloseDirectoryFileStream();
+
   cmGeneratedFileStream* GetRulesFileStream() const
   {
     return this->RulesFileStream.get();
@@ -545,9 +550,19 @@ private:
   std::string CMakeCmd() const;
   std::string NinjaCmd() const;
 
+  cmGeneratedFileStream* GetBuildFileStream() const
+  {
+    return this->DirectoryFileStream ? this->DirectoryFileStream.get()
+                                     : this->BuildFileStream.get();
+  }
+
   /// The file containing the build statement. (the relationship of the
   /// compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> BuildFileStream;
+  /// The file containing the build statements of the directory being
+  /// generated, if they are split from the main build file.
+  std::unique_ptr<cmGeneratedFileStream> DirectoryFileStream;
+  bool SplitBuildFile = false;
   /// The file containing the rule statements. (The action attached to each
   /// edge of the compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> RulesFileStream;
@@ -11,6 +11,7 @@
 #include <cmext/algorithm>
 #include <cmext/memory>
 
+#include "cmFileTime.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
@@ -18,6 +19,7 @@
 #include "cmLocalUnixMakefileGenerator3.h"
 #include "cmMakefile.h"
 #include "cmMakefileTargetGenerator.h"
+#include "cmMakefileUpToDateIndex.h"
 #include "cmOutputConverter.h"
 #include "cmState.h"
 #include "cmStateTypes.h"
@@ -109,6 +111,14 @@ void cmGlobalUnixMakefileGenerator3::Generate()
   this->ClangTidyExportFixesDirs.clear();
   this->ClangTidyExportFixesFiles.clear();
 
+  // The cache file was just written, so a time stamp without a fraction
+  // of a second is a sign of a file system recording whole seconds only.
+  cmFileTime cacheTime;
+  this->CoarseFileTimes =
+    cacheTime.Load(cmStrCat(this->GetCMakeInstance()->GetHomeOutputDirectory(),
+                            "/CMakeCache.txt")) &&
+    cacheTime.GetTime() % cmFileTime::UtPerS == 0;
+
   // first do superclass method
   this->cmGlobalGenerator::Generate();
 
@@ -139,6 +149,7 @@ void cmGlobalUnixMakefileGenerator3::Generate()
   // write the main makefile
   this->WriteMainMakefile2();
   this->WriteMainCMakefile();
+  this->WriteUpToDateIndex();
 
   if (this->CommandDatabase) {
     *this->CommandDatabase << "\n]";
@@ -343,6 +354,61 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
                                         this->LocalGenerators);
 }
 
+void cmGlobalUnixMakefileGenerator3::WriteUpToDateIndex()
+{
+  std::string const& binDir = this->LocalGenerators[0]->GetBinaryDirectory();
+  if (!this->GlobalSettingIsOn("CMAKE_MAKEFILE_UP_TO_DATE_CHECK")) {
+    cmMakefileUpToDateIndex::RemoveIndex(binDir);
+    return;
+  }
+
+  // Find the targets of the "all" rules of the top directory and the
+  // subdirectories it builds, and every target they depend on.
+  std::map<std::string, DirectoryTarget> const dirTargets =
+    this->ComputeDirectoryTargets();
+  std::vector<cmGeneratorTarget const*> queue;
+  std::vector<std::string> dirs{
+    this->LocalGenerators[0]->GetCurrentBinaryDirectory()
+  };
+  while (!dirs.empty()) {
+    auto const it = dirTargets.find(dirs.back());
+    dirs.pop_back();
+    if (it == dirTargets.end()) {
+      continue;
+    }
+    for (DirectoryTarget::Target const& t : it->second.Targets) {
+      if (t.ExcludedFromAllInConfigs.empty()) {
+        queue.emplace_back(t.GT);
+      }
+    }
+    for (DirectoryTarget::Dir const& d : it->second.Children) {
+      if (!d.ExcludeFromAll) {
+        dirs.emplace_back(d.Path);
+      }
+    }
+  }
+  std::set<cmGeneratorTarget const*> targets;
+  std::vector<std::string> indexes;
+  while (!queue.empty()) {
+    cmGeneratorTarget const* gt = queue.back();
+    queue.pop_back();
+    if (!targets.insert(gt).second) {
+      continue;
+    }
+    auto const* lg = static_cast<cmLocalUnixMakefileGenerator3 const*>(
+      gt->GetLocalGenerator());
+    indexes.emplace_back(
+      cmStrCat(lg->GetRelativeTargetDirectory(gt), "/build.index"));
+    for (cmTargetDepend const& dep : this->GetTargetDirectDepends(gt)) {
+      if (dep->IsInBuildSystem()) {
+        queue.emplace_back(dep);
+      }
+    }
+  }
+  std::sort(indexes.begin(), indexes.end());
+  cmMakefileUpToDateIndex::WriteIndex(binDir, indexes);
+}
+
 void cmGlobalUnixMakefileGenerator3::WriteMainCMakefileLanguageRules(
   cmGeneratedFileStream& cmakefileStream,
   std::vector<std::unique_ptr<cmLocalGenerator>>& lGenerators)
@@ -869,6 +935,15 @@ void cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   tp.VariableFile = tg->GetProgressFileNameFull();
 }
 
+void cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
+  cmGeneratorTarget const* target, unsigned long numberOfActions)
+{
+  TargetProgress& tp = this->ProgressMap[target];
+  tp.NumberOfActions = numberOfActions;
+  tp.VariableFile =
+    cmStrCat(target->GetSupportDirectory(), "/progress.make");
+}
+
 void cmGlobalUnixMakefileGenerator3::TargetProgress::WriteProgressVariables(
   unsigned long total, unsigned long& current)
 {
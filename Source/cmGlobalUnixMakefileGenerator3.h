@@ -152,6 +152,9 @@ public:
     return this->ToolSupportsLongLineDependencies;
   }
 
+  // File system of the build tree records time stamps in whole seconds
+  bool HasCoarseFileTimes() const { return this->CoarseFileTimes; }
+
   /** Get the command to use for a target that has no rule.  This is
       used for multiple output dependencies and for cmake_force.  */
   std::string GetEmptyRuleHackCommand() { return this->EmptyRuleHackCommand; }
@@ -177,6 +180,8 @@ public:
 
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
+  void RecordTargetProgress(cmGeneratorTarget const* target,
+                            unsigned long numberOfActions);
 
   void AddCXXCompileCommand(std::string const& sourceFile,
                             std::string const& workingDirectory,
@@ -206,6 +211,7 @@ public:
 protected:
   void WriteMainMakefile2();
   void WriteMainCMakefile();
+  void WriteUpToDateIndex();
 
   void WriteConvenienceRules2(std::ostream& ruleFileStream,
                               cmLocalUnixMakefileGenerator3& rootLG,
@@ -260,6 +266,10 @@ protected:
   // we add SupportsLongLineDependencies to predicate.
   bool ToolSupportsLongLineDependencies = true;
 
+  // Make cannot order files written within the same second if the file
+  // system of the build tree does not record finer time stamps.
+  bool CoarseFileTimes = false;
+
   // Some make programs (Borland) do not keep a rule if there are no
   // dependencies or commands.  This is a problem for creating rules
   // that might not do anything but might have other dependencies
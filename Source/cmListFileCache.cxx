@@ -3,6 +3,9 @@
 #define cmListFileCache_cxx
 #include "cmListFileCache.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <istream>
 #include <memory>
 #include <ostream>
 #include <utility>
@@ -13,11 +16,17 @@
 
 #include <cm/string_view>
 
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
 #include "cmDiagnostics.h"
 #include "cmList.h"
 #include "cmListFileLexer.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmake.h"
@@ -57,6 +66,10 @@ public:
   bool ParseFile();
   bool ParseString(cm::string_view str);
 
+  // Whether the result depends only on the file content, i.e. parsing
+  // did not issue any diagnostic that a cached result would suppress.
+  bool IsCacheable() const { return this->Cacheable; }
+
 private:
   bool Parse();
   bool ParseFunction(cm::string_view name, long line);
@@ -83,6 +96,7 @@ private:
   long FunctionLine;
   long FunctionLineEnd;
   std::vector<cmListFileArgument> FunctionArguments;
+  bool Cacheable = true;
 };
 
 cmListFileParser::cmListFileParser(cmListFile* lf, cmListFileBacktrace lfbt,
@@ -320,6 +334,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
   }
   bool isError = (this->Separation == SeparationError ||
                   delim == cmListFileArgument::Bracket);
+  this->Cacheable = false;
   cmListFileContext lfc;
   lfc.FilePath = this->FileName;
   lfc.Line = token->line;
@@ -446,8 +461,38 @@ bool cmListFile::ParseFile(std::string const& filename, cmMakefile const* mf,
     return false;
   }
 
+  cmListFileCache* cache =
+    mf ? mf->GetCMakeInstance()->GetListFileCache() : nullptr;
+  std::string key;
+  if (cache) {
+    key = cmListFileCache::ComputeKey(filename);
+    if (!key.empty()) {
+      std::vector<cmListFileFunction> const* functions = cache->Find(key);
+#if !defined(CMAKE_BOOTSTRAP)
+      cmake* cm = mf->GetCMakeInstance();
+      if (cm->IsProfilingEnabled()) {
+        Json::Value args(Json::objectValue);
+        args["hits"] = static_cast<Json::UInt64>(cache->GetHits());
+        args["misses"] = static_cast<Json::UInt64>(cache->GetMisses());
+        cm->GetProfilingOutput().CounterEntry("script", "listfile_cache",
+                                              std::move(args));
+      }
+#endif
+      if (functions) {
+        this->Functions = *functions;
+        return true;
+      }
+    }
+  }
+
   cmListFileParser parser(this, lfbt, mf, filename);
-  return parser.ParseFile();
+  if (!parser.ParseFile()) {
+    return false;
+  }
+  if (!key.empty() && parser.IsCacheable()) {
+    cache->Insert(std::move(key), this->Functions);
+  }
+  return true;
 }
 
 bool cmListFile::ParseString(cm::string_view str,
@@ -459,6 +504,200 @@ bool cmListFile::ParseString(cm::string_view str,
   return parser.ParseString(str);
 }
 
+namespace {
+
+// Version of the persisted cache format.  Increment on any change.
+std::uint32_t const ListFileCacheVersion = 1;
+char const ListFileCacheMagic[8] = { 'C', 'M', 'L', 'F', 'C', 'A', 'C', 'H' };
+
+void WriteUInt(std::ostream& os, std::uint64_t value)
+{
+  unsigned char buf[8];
+  for (unsigned char& byte : buf) {
+    byte = static_cast<unsigned char>(value & 0xFF);
+    value >>= 8;
+  }
+  os.write(reinterpret_cast<char const*>(buf), sizeof(buf));
+}
+
+void WriteString(std::ostream& os, std::string const& str)
+{
+  WriteUInt(os, str.size());
+  os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+bool ReadUInt(std::istream& is, std::uint64_t& value)
+{
+  unsigned char buf[8];
+  if (!is.read(reinterpret_cast<char*>(buf), sizeof(buf))) {
+    return false;
+  }
+  value = 0;
+  for (int i = 7; i >= 0; --i) {
+    value = (value << 8) | buf[i];
+  }
+  return true;
+}
+
+bool ReadString(std::istream& is, std::string& str)
+{
+  std::uint64_t size;
+  // Reject sizes that cannot be valid to avoid huge allocations when
+  // reading a corrupt file.
+  if (!ReadUInt(is, size) || size > (std::uint64_t(1) << 32)) {
+    return false;
+  }
+  str.resize(static_cast<std::size_t>(size));
+  return size == 0 ||
+    static_cast<bool>(is.read(&str[0], static_cast<std::streamsize>(size)));
+}
+
+bool ReadFunction(std::istream& is, std::vector<cmListFileFunction>& out)
+{
+  std::string name;
+  std::uint64_t line;
+  std::uint64_t lineEnd;
+  std::uint64_t numArgs;
+  if (!ReadString(is, name) || !ReadUInt(is, line) ||
+      !ReadUInt(is, lineEnd) || !ReadUInt(is, numArgs)) {
+    return false;
+  }
+  std::vector<cmListFileArgument> args;
+  for (std::uint64_t i = 0; i < numArgs; ++i) {
+    cmListFileArgument arg;
+    std::uint64_t delim;
+    std::uint64_t argLine;
+    if (!ReadString(is, arg.Value) || !ReadUInt(is, delim) ||
+        delim > cmListFileArgument::Bracket || !ReadUInt(is, argLine)) {
+      return false;
+    }
+    arg.Delim = static_cast<cmListFileArgument::Delimiter>(delim);
+    arg.Line = static_cast<long>(argLine);
+    args.emplace_back(std::move(arg));
+  }
+  out.emplace_back(std::move(name), static_cast<long>(line),
+                   static_cast<long>(lineEnd), std::move(args));
+  return true;
+}
+
+} // anonymous namespace
+
+std::string cmListFileCache::ComputeKey(std::string const& path)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  return hasher.HashFile(path);
+}
+
+std::vector<cmListFileFunction> const* cmListFileCache::Find(
+  std::string const& key)
+{
+  auto i = this->Entries.find(key);
+  if (i == this->Entries.end()) {
+    ++this->Misses;
+    return nullptr;
+  }
+  ++this->Hits;
+  i->second.Used = true;
+  return &i->second.Functions;
+}
+
+void cmListFileCache::Insert(std::string key,
+                             std::vector<cmListFileFunction> functions)
+{
+  Entry& entry = this->Entries[std::move(key)];
+  entry.Functions = std::move(functions);
+  entry.Used = true;
+}
+
+bool cmListFileCache::Load(std::string const& path)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+
+  char magic[sizeof(ListFileCacheMagic)];
+  std::uint64_t version;
+  std::uint64_t numEntries;
+  if (!fin.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), ListFileCacheMagic) ||
+      !ReadUInt(fin, version) || version != ListFileCacheVersion ||
+      !ReadUInt(fin, numEntries)) {
+    return false;
+  }
+
+  std::unordered_map<std::string, Entry> entries;
+  for (std::uint64_t e = 0; e < numEntries; ++e) {
+    std::string key;
+    std::uint64_t numFunctions;
+    if (!ReadString(fin, key) || !ReadUInt(fin, numFunctions)) {
+      return false;
+    }
+    Entry entry;
+    for (std::uint64_t f = 0; f < numFunctions; ++f) {
+      if (!ReadFunction(fin, entry.Functions)) {
+        return false;
+      }
+    }
+    entries.emplace(std::move(key), std::move(entry));
+  }
+
+  // Entries parsed by this run take precedence over loaded ones.
+  entries.insert(this->Entries.begin(), this->Entries.end());
+  this->Entries = std::move(entries);
+  return true;
+}
+
+bool cmListFileCache::Save(std::string const& path) const
+{
+  // Write to a temporary file and rename it into place so that an
+  // interrupted run never leaves a truncated cache behind.
+  std::string const tmpPath = cmStrCat(path, ".tmp");
+  {
+    cmsys::ofstream fout(tmpPath.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!fout) {
+      return false;
+    }
+    fout.write(ListFileCacheMagic, sizeof(ListFileCacheMagic));
+    WriteUInt(fout, ListFileCacheVersion);
+
+    // Drop entries not used by this run so that the file does not
+    // accumulate content of list files that no longer exist.
+    std::uint64_t numEntries = 0;
+    for (auto const& entry : this->Entries) {
+      if (entry.second.Used) {
+        ++numEntries;
+      }
+    }
+    WriteUInt(fout, numEntries);
+    for (auto const& entry : this->Entries) {
+      if (!entry.second.Used) {
+        continue;
+      }
+      WriteString(fout, entry.first);
+      WriteUInt(fout, entry.second.Functions.size());
+      for (cmListFileFunction const& func : entry.second.Functions) {
+        WriteString(fout, func.OriginalName());
+        WriteUInt(fout, static_cast<std::uint64_t>(func.Line()));
+        WriteUInt(fout, static_cast<std::uint64_t>(func.LineEnd()));
+        WriteUInt(fout, func.Arguments().size());
+        for (cmListFileArgument const& arg : func.Arguments()) {
+          WriteString(fout, arg.Value);
+          WriteUInt(fout, static_cast<std::uint64_t>(arg.Delim));
+          WriteUInt(fout, static_cast<std::uint64_t>(arg.Line));
+        }
+      }
+    }
+    if (!fout.flush()) {
+      fout.close();
+      cmSystemTools::RemoveFile(tmpPath);
+      return false;
+    }
+  }
+  return cmSystemTools::RenameFile(tmpPath, path);
+}
+
 #include "cmConstStack.tcc"
 template class cmConstStack<cmListFileContext, cmListFileBacktrace>;
 
@@ -4,10 +4,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -18,13 +20,6 @@
 #include "cmList.h"
 #include "cmSystemTools.h"
 
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
 class cmMakefile;
 
 struct cmListFileArgument
@@ -278,3 +273,50 @@ struct cmListFile
 
   std::vector<cmListFileFunction> Functions;
 };
+
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a class used to cache the contents of parsed
+ * cmake list files.  Entries are keyed by a hash of the file content
+ * so that the same module included from many directories is lexed only
+ * once, and so that a file that changes on disk is never served stale.
+ * The cache may be persisted to a compact binary file and loaded again
+ * by a later run in the same build tree.
+ */
+class cmListFileCache
+{
+public:
+  /** Compute the key under which the content of a file is cached.
+      Returns an empty string if the file cannot be read.  */
+  static std::string ComputeKey(std::string const& path);
+
+  /** Look up functions previously parsed from content with the given key.
+      Returns nullptr if the content has not been parsed before.  */
+  std::vector<cmListFileFunction> const* Find(std::string const& key);
+
+  /** Store the functions parsed from content with the given key.  */
+  void Insert(std::string key, std::vector<cmListFileFunction> functions);
+
+  /** Load entries persisted by a previous run.  Returns false and leaves
+      the cache unchanged if the file is missing, corrupt, or written by
+      an incompatible version.  */
+  bool Load(std::string const& path);
+
+  /** Persist the entries used since construction or the last Load.  */
+  bool Save(std::string const& path) const;
+
+  std::size_t GetHits() const { return this->Hits; }
+  std::size_t GetMisses() const { return this->Misses; }
+
+private:
+  struct Entry
+  {
+    std::vector<cmListFileFunction> Functions;
+    bool Used = false;
+  };
+
+  std::unordered_map<std::string, Entry> Entries;
+  std::size_t Hits = 0;
+  std::size_t Misses = 0;
+};
@@ -5,11 +5,13 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <initializer_list>
 #include <iterator>
 #include <queue>
+#include <set>
 #include <sstream>
 #include <unordered_set>
 #include <utility>
@@ -64,6 +66,11 @@
 #include "cmValue.h"
 #include "cmake.h"
 
+#ifndef CMAKE_BOOTSTRAP
+#  include <cm3p/json/value.h>
+#  include <cm3p/json/writer.h>
+#endif
+
 #if defined(__HAIKU__)
 #  include <FindDirectory.h>
 #  include <StorageDefs.h>
@@ -333,6 +340,60 @@ void cmLocalGenerator::TraceDependencies() const
 }
 
 #ifndef CMAKE_BOOTSTRAP
+bool cmLocalGenerator::GenerateTestManifest(std::string const& file)
+{
+  // Included test files may add tests with script code.
+  if (this->Makefile->GetProperty("TEST_INCLUDE_FILE") ||
+      this->Makefile->GetProperty("TEST_INCLUDE_FILES")) {
+    cmSystemTools::RemoveFile(file);
+    return false;
+  }
+
+  Json::Value root = Json::objectValue;
+  Json::Value& version = root["version"] = Json::objectValue;
+  version["major"] = 1;
+  version["minor"] = 0;
+
+  std::string const& resourceSpecFile =
+    this->Makefile->GetSafeDefinition("CTEST_RESOURCE_SPEC_FILE");
+  if (!resourceSpecFile.empty()) {
+    root["resourceSpecFile"] = resourceSpecFile;
+  }
+
+  Json::Value& tests = root["tests"] = Json::arrayValue;
+  for (auto const& tester : this->Makefile->GetTestGenerators()) {
+    if (!tester->GenerateManifest(tests)) {
+      cmSystemTools::RemoveFile(file);
+      return false;
+    }
+  }
+
+  Json::Value& subdirs = root["subdirectories"] = Json::arrayValue;
+  for (cmStateSnapshot const& i :
+       this->Makefile->GetStateSnapshot().GetChildren()) {
+    subdirs.append(
+      this->MaybeRelativeToCurBinDir(i.GetDirectory().GetCurrentBinary()));
+  }
+
+  cmList labels;
+  labels.append(this->Makefile->GetProperty("LABELS"));
+  labels.append(this->Makefile->GetDefinition("CMAKE_DIRECTORY_LABELS"));
+  if (!labels.empty()) {
+    Json::Value& jLabels = root["labels"] = Json::arrayValue;
+    for (std::string const& label : labels) {
+      jLabels.append(label);
+    }
+  }
+
+  cmGeneratedFileStream fout(file);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> const writer(builder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+  return true;
+}
+
 void cmLocalGenerator::ResolveSourceGroupGenex()
 {
   this->Makefile->ResolveSourceGroupGenex(this);
@@ -355,6 +416,14 @@ void cmLocalGenerator::GenerateTestFiles()
              "/CTestTestfile.cmake");
   this->GlobalGenerator->AddTestFile(file);
 
+  // Generate the code of each test first, so the header can tell whether
+  // the tests are also described by a manifest.
+  std::ostringstream tests;
+  for (auto const& tester : this->Makefile->GetTestGenerators()) {
+    tester->Compute(this);
+    tester->Generate(tests, config, configurationTypes);
+  }
+
   cmGeneratedFileStream fout(file);
 
   fout << "# CMake generated Testfile for \n"
@@ -369,6 +438,13 @@ void cmLocalGenerator::GenerateTestFiles()
           "required for \n"
           "# testing this directory and lists subdirectories to "
           "be tested as well.\n";
+#ifndef CMAKE_BOOTSTRAP
+  if (this->GenerateTestManifest(
+        cmStrCat(this->StateSnapshot.GetDirectory().GetCurrentBinary(),
+                 "/CTestTestfile.json"))) {
+    fout << "# Test manifest: CTestTestfile.json\n";
+  }
+#endif
 
   std::string resourceSpecFile =
     this->Makefile->GetSafeDefinition("CTEST_RESOURCE_SPEC_FILE");
@@ -389,11 +465,7 @@ void cmLocalGenerator::GenerateTestFiles()
     }
   }
 
-  // Ask each test generator to write its code.
-  for (auto const& tester : this->Makefile->GetTestGenerators()) {
-    tester->Compute(this);
-    tester->Generate(fout, config, configurationTypes);
-  }
+  fout << tests.str();
   using vec_t = std::vector<cmStateSnapshot>;
   vec_t const& children = this->Makefile->GetStateSnapshot().GetChildren();
   for (cmStateSnapshot const& i : children) {
@@ -3069,6 +3141,12 @@ bool cmLocalGenerator::IsSplitSwiftBuild() const
 
 namespace {
 
+bool PathEqOrSubDir(std::string const& a, std::string const& b)
+{
+  return (cmSystemTools::ComparePath(a, b) ||
+          cmSystemTools::IsSubDirectory(a, b));
+}
+
 inline void RegisterUnitySources(cmGeneratorTarget* target, cmSourceFile* sf,
                                  std::string const& filename)
 {
@@ -3111,6 +3189,21 @@ cmLocalGenerator::UnitySource cmLocalGenerator::WriteUnitySource(
   return UnitySource(std::move(filename), perConfig);
 }
 
+std::string cmLocalGenerator::GetUnitySourceHashKey(
+  std::string const& sf_full_path) const
+{
+  auto const path = cmSystemTools::GetFilenamePath(sf_full_path);
+  if (PathEqOrSubDir(path, this->GetBinaryDirectory())) {
+    return "BLD_" +
+      cmSystemTools::RelativePath(this->GetBinaryDirectory(), sf_full_path);
+  }
+  if (PathEqOrSubDir(path, this->GetSourceDirectory())) {
+    return "SRC_" +
+      cmSystemTools::RelativePath(this->GetSourceDirectory(), sf_full_path);
+  }
+  return "ABS_" + sf_full_path;
+}
+
 void cmLocalGenerator::WriteUnitySourceInclude(
   std::ostream& unity_file, cm::optional<std::string> const& cond,
   std::string const& sf_full_path, cmValue beforeInclude, cmValue afterInclude,
@@ -3121,26 +3214,18 @@ void cmLocalGenerator::WriteUnitySourceInclude(
     unity_file << "#if " << *cond << "\n";
   }
 
-  std::string pathToHash;
   std::string relocatableIncludePath;
-  auto PathEqOrSubDir = [](std::string const& a, std::string const& b) {
-    return (cmSystemTools::ComparePath(a, b) ||
-            cmSystemTools::IsSubDirectory(a, b));
-  };
   auto const path = cmSystemTools::GetFilenamePath(sf_full_path);
   if (PathEqOrSubDir(path, this->GetBinaryDirectory())) {
     relocatableIncludePath =
       cmSystemTools::RelativePath(unityFileDirectory, sf_full_path);
-    pathToHash = "BLD_" +
-      cmSystemTools::RelativePath(this->GetBinaryDirectory(), sf_full_path);
   } else if (PathEqOrSubDir(path, this->GetSourceDirectory())) {
     relocatableIncludePath =
       cmSystemTools::RelativePath(this->GetSourceDirectory(), sf_full_path);
-    pathToHash = "SRC_" + relocatableIncludePath;
   } else {
     relocatableIncludePath = sf_full_path;
-    pathToHash = "ABS_" + sf_full_path;
   }
+  std::string const pathToHash = this->GetUnitySourceHashKey(sf_full_path);
 
   if (cmNonempty(uniqueIdName)) {
     cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
@@ -3229,6 +3314,129 @@ cmLocalGenerator::AddUnityFilesModeAuto(
   return unity_files;
 }
 
+std::vector<cmLocalGenerator::UnitySource>
+cmLocalGenerator::AddUnityFilesModeBalanced(
+  cmGeneratorTarget* target, std::string const& lang,
+  std::vector<std::string> const& configs,
+  std::vector<UnityBatchedSource> const& filtered_sources,
+  cmValue beforeInclude, cmValue afterInclude,
+  std::string const& filename_base, UnityPathMode pathMode, size_t batchSize)
+{
+  if (filtered_sources.empty()) {
+    return {};
+  }
+  if (batchSize == 0) {
+    batchSize = filtered_sources.size();
+  }
+  size_t const batchCount =
+    (filtered_sources.size() + batchSize - 1) / batchSize;
+
+  // The cost of a source is given by the user, or is the size of the file.
+  // A source that does not exist yet costs as much as an average one.
+  std::vector<double> costs;
+  costs.reserve(filtered_sources.size());
+  double knownTotal = 0;
+  size_t knownCount = 0;
+  for (UnityBatchedSource const& ubs : filtered_sources) {
+    double cost = -1;
+    if (cmValue value = ubs.Source->GetProperty("UNITY_BUILD_COST")) {
+      unsigned long long userCost = 0;
+      if (!cmStrToULongLong(*value, &userCost)) {
+        this->IssueMessage(
+          MessageType::FATAL_ERROR,
+          cmStrCat("Invalid UNITY_BUILD_COST value of ", *value,
+                   " assigned to source ", ubs.Source->ResolveFullPath(),
+                   ". The value must be a non-negative integer."));
+        return {};
+      }
+      cost = static_cast<double>(userCost);
+    } else {
+      std::string const& path = ubs.Source->ResolveFullPath();
+      if (cmSystemTools::FileExists(path, true)) {
+        cost = static_cast<double>(cmSystemTools::FileLength(path));
+      }
+    }
+    if (cost >= 0) {
+      knownTotal += cost;
+      ++knownCount;
+    }
+    costs.emplace_back(cost);
+  }
+  double const averageCost = knownCount ? knownTotal / knownCount : 1;
+  double total = 0;
+  for (double& cost : costs) {
+    if (cost < 0) {
+      cost = averageCost;
+    }
+    total += cost;
+  }
+  if (total <= 0) {
+    std::fill(costs.begin(), costs.end(), 1);
+    total = static_cast<double>(costs.size());
+  }
+
+  // Keep the sources in order and decide after each source whether to
+  // end the unity source file there.  The decision depends only on the
+  // source, its cost, the batch cost and the cost of the file so far, so
+  // that a change to one source moves at most the boundaries up to the
+  // next one it does not affect.  Once a file costs half the batch cost,
+  // a source ends it with a probability of twice its share of the batch
+  // cost, drawn from a hash of its path.  A file always ends before it
+  // would cost more than twice the batch cost, and a source that costs
+  // the batch cost or more is compiled alone.  The batch cost is rounded
+  // to a power of two so that it stays the same while the total cost
+  // changes a little.  The files are named after their first source so
+  // that the other files keep their names.
+  double const budget =
+    std::exp2(std::round(std::log2(total / static_cast<double>(batchCount))));
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  std::vector<std::string> hashes;
+  hashes.reserve(filtered_sources.size());
+  for (UnityBatchedSource const& ubs : filtered_sources) {
+    hashes.emplace_back(hasher.HashString(
+      this->GetUnitySourceHashKey(ubs.Source->ResolveFullPath())));
+  }
+
+  char const* filename_prefix = unity_file_prefix(target);
+  std::vector<UnitySource> unity_files;
+  auto begin = filtered_sources.begin();
+  std::string name = hashes.front().substr(0, 8);
+  std::set<std::string> names = { name };
+  double fileCost = 0;
+  for (size_t i = 0; batchCount > 1 && i + 1 < hashes.size(); ++i) {
+    fileCost += costs[i];
+    bool end = costs[i] >= budget || costs[i + 1] >= budget ||
+      fileCost + costs[i + 1] > 2 * budget;
+    if (!end && fileCost >= budget / 2) {
+      double const draw =
+        static_cast<double>(
+          std::strtoul(hashes[i].substr(8, 8).c_str(), nullptr, 16)) /
+        4294967296.0;
+      end = draw < 2 * costs[i] / budget;
+    }
+    std::string nextName = hashes[i + 1].substr(0, 8);
+    if (!end || !names.insert(nextName).second) {
+      continue;
+    }
+    fileCost = 0;
+    auto const next = filtered_sources.begin() + i + 1;
+    std::string filename = cmStrCat(filename_base, filename_prefix, name,
+                                    unity_file_extension(lang));
+    unity_files.emplace_back(this->WriteUnitySource(
+      target, configs, cmMakeRange(begin, next), beforeInclude, afterInclude,
+      std::move(filename), filename_base, pathMode));
+    begin = next;
+    name = std::move(nextName);
+  }
+  std::string filename = cmStrCat(filename_base, filename_prefix, name,
+                                  unity_file_extension(lang));
+  unity_files.emplace_back(this->WriteUnitySource(
+    target, configs, cmMakeRange(begin, filtered_sources.end()),
+    beforeInclude, afterInclude, std::move(filename), filename_base,
+    pathMode));
+  return unity_files;
+}
+
 std::vector<cmLocalGenerator::UnitySource>
 cmLocalGenerator::AddUnityFilesModeGroup(
   cmGeneratorTarget* target, std::string const& lang,
@@ -3349,11 +3557,15 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       unity_files = AddUnityFilesModeGroup(
         target, lang, configs, filtered_sources, beforeInclude, afterInclude,
         filename_base, pathMode);
+    } else if (unityMode && *unityMode == "BALANCED") {
+      unity_files = AddUnityFilesModeBalanced(
+        target, lang, configs, filtered_sources, beforeInclude, afterInclude,
+        filename_base, pathMode, unityBatchSize);
     } else {
       // unity mode is set to an unsupported value
       std::string e("Invalid UNITY_BUILD_MODE value of " + *unityMode +
                     " assigned to target " + target->GetName() +
-                    ". Acceptable values are BATCH and GROUP.");
+                    ". Acceptable values are BATCH, GROUP and BALANCED.");
       this->IssueMessage(MessageType::FATAL_ERROR, e);
     }
 
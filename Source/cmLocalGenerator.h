@@ -679,6 +679,15 @@ protected:
 #endif
 
 private:
+#ifndef CMAKE_BOOTSTRAP
+  /**
+   * Write the manifest of the tests generated in this directory, or
+   * remove it if they cannot be described without script code.  Returns
+   * true if the manifest was written.
+   */
+  bool GenerateTestManifest(std::string const& file);
+#endif
+
   /**
    * See LinearGetSourceFileWithOutput for background information
    */
@@ -757,6 +766,8 @@ private:
     cmRange<std::vector<UnityBatchedSource>::const_iterator> sources,
     cmValue beforeInclude, cmValue afterInclude, std::string filename,
     std::string const& unityFileDirectory, UnityPathMode pathMode) const;
+  /** Name of a source in the hashes written to unity files */
+  std::string GetUnitySourceHashKey(std::string const& sf_full_path) const;
   void WriteUnitySourceInclude(std::ostream& unity_file,
                                cm::optional<std::string> const& cond,
                                std::string const& sf_full_path,
@@ -770,6 +781,13 @@ private:
     cmValue beforeInclude, cmValue afterInclude,
     std::string const& filename_base, UnityPathMode pathMode,
     size_t batchSize);
+  std::vector<UnitySource> AddUnityFilesModeBalanced(
+    cmGeneratorTarget* target, std::string const& lang,
+    std::vector<std::string> const& configs,
+    std::vector<UnityBatchedSource> const& filtered_sources,
+    cmValue beforeInclude, cmValue afterInclude,
+    std::string const& filename_base, UnityPathMode pathMode,
+    size_t batchSize);
   std::vector<UnitySource> AddUnityFilesModeGroup(
     cmGeneratorTarget* target, std::string const& lang,
     std::vector<std::string> const& configs,
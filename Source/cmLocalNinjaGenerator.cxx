@@ -102,12 +102,20 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  if (!this->GetGlobalNinjaGenerator()->OpenDirectoryFileStream(this)) {
+    return;
+  }
+
   for (auto const& target : this->GetGeneratorTargets()) {
     if (!target->IsInBuildSystem()) {
       continue;
     }
     auto tg = cmNinjaTargetGenerator::New(target.get());
     if (tg) {
+#ifndef CMAKE_BOOTSTRAP
+      auto profilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+        "generate", target->GetName());
+#endif
       if (target->Target->IsPerConfig()) {
         for (auto const& config : this->GetConfigNames()) {
           tg->Generate(config);
@@ -162,6 +170,8 @@ void cmLocalNinjaGenerator::Generate()
     this->WriteCustomCommandBuildStatements(config);
     this->AdditionalCleanFiles(config);
   }
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryFileStream();
 }
 
 std::string cmLocalNinjaGenerator::GetObjectOutputRoot(
@@ -19,9 +19,12 @@
 #include "cmsys/FStream.hxx"
 
 #include "cmCMakePath.h"
-#include "cmCustomCommand.h" // IWYU pragma: keep
+#include "cmCryptoHash.h"
+#include "cmCustomCommand.h"
 #include "cmCustomCommandGenerator.h"
+#include "cmCustomCommandLines.h"
 #include "cmDependsCompiler.h"
+#include "cmExperimental.h"
 #include "cmFileTimeCache.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorExpression.h"
@@ -35,11 +38,14 @@
 #include "cmMakefile.h"
 #include "cmMakefileTargetGenerator.h"
 #include "cmOutputConverter.h"
+#include "cmPolicies.h"
+#include "cmPropertyMap.h"
 #include "cmRange.h"
 #include "cmRulePlaceholderExpander.h"
 #include "cmScriptGenerator.h"
 #include "cmSourceFile.h"
 #include "cmState.h"
+#include "cmStateDirectory.h"
 #include "cmStateSnapshot.h"
 #include "cmStateTypes.h"
 #include "cmStdIoStream.h"
@@ -170,9 +176,24 @@ void cmLocalUnixMakefileGenerator3::Generate()
   this->SkipAssemblySourceRules =
     this->Makefile->IsOn("CMAKE_SKIP_ASSEMBLY_SOURCE_RULES");
 
+  // Skip the directory if its inputs did not change since the last run.
+  std::string const fingerprintFile = cmStrCat(
+    this->GetCurrentBinaryDirectory(), "/CMakeFiles/IncrementalGenerate.txt");
+  std::string fingerprint;
+  if (this->UseIncrementalGenerate()) {
+    fingerprint = this->ComputeGenerateFingerprint();
+    if (this->ReuseGeneratedFiles(fingerprintFile, fingerprint)) {
+      return;
+    }
+  }
+  cmSystemTools::RemoveFile(fingerprintFile);
+
   // Generate the rule files for each target.
   cmGlobalUnixMakefileGenerator3* gg =
     static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  bool const writeIndex =
+    gg->GlobalSettingIsOn("CMAKE_MAKEFILE_UP_TO_DATE_CHECK");
+  std::vector<std::pair<std::string, unsigned long>> progress;
   for (cmGeneratorTarget* gt :
        this->GlobalGenerator->GetLocalGeneratorTargetsInOrder(this)) {
     if (!gt->IsInBuildSystem()) {
@@ -190,8 +211,25 @@ void cmLocalUnixMakefileGenerator3::Generate()
     std::unique_ptr<cmMakefileTargetGenerator> tg(
       cmMakefileTargetGenerator::New(gt));
     if (tg) {
+#ifndef CMAKE_BOOTSTRAP
+      auto profilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+        "generate", gt->GetName());
+#endif
+      cmMakefileUpToDateIndex::RuleMap rules;
+      if (writeIndex) {
+        this->IndexedRules = &rules;
+      }
       tg->WriteRuleFiles();
+      this->IndexedRules = nullptr;
+      if (writeIndex) {
+        std::string const dir = this->GetRelativeTargetDirectory(gt);
+        cmMakefileUpToDateIndex::WriteTargetIndex(
+          cmStrCat(gt->GetSupportDirectory(), "/build.index"), rules,
+          { cmStrCat(dir, "/depend"), cmStrCat(dir, "/build") },
+          cmStrCat(dir, "/compiler_depend.internal"));
+      }
       gg->RecordTargetProgress(tg.get());
+      progress.emplace_back(gt->GetName(), tg->GetNumberOfProgressActions());
     }
   }
 
@@ -200,6 +238,336 @@ void cmLocalUnixMakefileGenerator3::Generate()
 
   // Write the cmake file with information for this directory.
   this->WriteDirectoryInformationFile();
+
+  // Record what the files were generated from, along with the progress
+  // information that must be replayed when they are reused.
+  if (!fingerprint.empty() && !cmSystemTools::GetErrorOccurredFlag()) {
+    cmGeneratedFileStream fout(fingerprintFile);
+    fout << "# Fingerprint of the inputs of this directory's build files.\n"
+         << fingerprint << '\n';
+    for (auto const& p : progress) {
+      fout << p.second << ' ' << p.first << '\n';
+    }
+  }
+}
+
+bool cmLocalUnixMakefileGenerator3::UseIncrementalGenerate() const
+{
+  if (!cmExperimental::HasSupportEnabled(
+        *this->Makefile, cmExperimental::Feature::IncrementalGenerate)) {
+    return false;
+  }
+
+  // The top-level Makefile has convenience rules for all targets.
+  if (this->IsRootMakefile()) {
+    return false;
+  }
+
+  // Targets contributing to project-wide files must be generated each time.
+  for (auto const& gt : this->GetGeneratorTargets()) {
+    if (gt->GetPropertyAsBool("EXPORT_COMPILE_COMMANDS") ||
+        gt->GetPropertyAsBool("EXPORT_BUILD_DATABASE")) {
+      return false;
+    }
+    for (std::string const& prop : gt->Target->GetProperties().GetKeys()) {
+      if (cmHasLiteralSuffix(prop, "_CLANG_TIDY_EXPORT_FIXES_DIR")) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+namespace {
+// Find the names of the targets referenced by $<TARGET_...:name...>
+// generator expressions.  Returns false if a name is itself computed by a
+// generator expression, so the referenced target cannot be known.
+bool FindReferencedTargets(cm::string_view value,
+                           std::set<std::string>& names)
+{
+  static cm::string_view const prefix = "$<TARGET_"_s;
+  for (auto pos = value.find(prefix); pos != cm::string_view::npos;
+       pos = value.find(prefix, pos + 1)) {
+    auto const colon = value.find_first_of(":>", pos + prefix.size());
+    if (colon == cm::string_view::npos || value[colon] != ':') {
+      continue;
+    }
+    auto const end = value.find_first_of(",>$", colon + 1);
+    if (end == cm::string_view::npos || value[end] == '$') {
+      return false;
+    }
+    names.emplace(value.substr(colon + 1, end - colon - 1));
+  }
+  return true;
+}
+}
+
+std::string cmLocalUnixMakefileGenerator3::ComputeGenerateFingerprint()
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view value) {
+    hasher.Append(value);
+    hasher.Append(cm::string_view("", 1));
+  };
+  using Visitor = std::function<void(cm::string_view)>;
+  auto visitProperties = [](cmPropertyMap const& properties,
+                            Visitor const& visit) {
+    for (auto const& prop : properties.GetList()) {
+      visit(prop.first);
+      visit(prop.second);
+    }
+  };
+  auto visitCommand = [](cmCustomCommand const& cc, Visitor const& visit) {
+    visit(cmJoin(cc.GetOutputs(), ";"));
+    visit(cmJoin(cc.GetByproducts(), ";"));
+    visit(cmJoin(cc.GetDepends(), ";"));
+    if (cc.HasMainDependency()) {
+      visit(cc.GetMainDependency());
+    }
+    visit(cc.GetWorkingDirectory());
+    for (cmCustomCommandLine const& line : cc.GetCommandLines()) {
+      visit(cmJoin(line, "\x1f"));
+    }
+    visit(cc.GetComment() ? cc.GetComment() : "\x1f");
+    for (auto const& dep : cc.GetImplicitDepends()) {
+      visit(dep.first);
+      visit(dep.second);
+    }
+    visit(cc.GetDepfile());
+    visit(cc.GetJobPool());
+    visit(cc.GetTarget());
+    visit(cc.GetRole());
+    char const flags[] = {
+      cc.GetStdPipesUTF8() ? '1' : '0',
+      cc.GetEscapeOldStyle() ? '1' : '0',
+      cc.GetEscapeAllowMakeVars() ? '1' : '0',
+      cc.GetUsesTerminal() ? '1' : '0',
+      cc.GetCommandExpandLists() ? '1' : '0',
+      cc.GetDependsExplicitOnly() ? '1' : '0',
+      cc.GetJobserverAware() ? '1' : '0',
+      cc.GetCodegen() ? '1' : '0',
+    };
+    visit(cm::string_view(flags, sizeof(flags)));
+#define APPEND_CC_POLICY(P)                                                   \
+  visit(std::to_string(static_cast<int>(cc.Get##P##Status())));
+    CM_FOR_EACH_CUSTOM_COMMAND_POLICY(APPEND_CC_POLICY)
+#undef APPEND_CC_POLICY
+  };
+
+  append(cmVersion::GetCMakeVersion());
+  append(this->GlobalGenerator->GetName());
+  append(this->GetCurrentBinaryDirectory());
+
+  // Everything visible in this directory.
+  cmState* state = this->GetState();
+  for (std::string const& key : this->Makefile->GetDefinitions()) {
+    append(key);
+    append(this->Makefile->GetSafeDefinition(key));
+  }
+  for (std::string const& key : state->GetCacheEntryKeys()) {
+    append(key);
+    append(*state->GetCacheEntryValue(key));
+  }
+  visitProperties(state->GetGlobalProperties(), append);
+  cmStateDirectory const directory = this->StateSnapshot.GetDirectory();
+  for (std::string const& key : directory.GetPropertyKeys()) {
+    append(key);
+    append(*directory.GetProperty(key));
+  }
+  for (int id = 0; id < cmPolicies::CMPCOUNT; ++id) {
+    cmPolicies::PolicyStatus const status =
+      this->Makefile->GetPolicyStatus(static_cast<cmPolicies::PolicyID>(id));
+    append(std::to_string(static_cast<int>(status)));
+  }
+
+  // Properties stored outside of the generic property map.
+  static cm::string_view const specialProps[] = {
+    "COMPILE_DEFINITIONS"_s,
+    "COMPILE_FEATURES"_s,
+    "COMPILE_OPTIONS"_s,
+    "C_STANDARD"_s,
+    "CXX_STANDARD"_s,
+    "CUDA_STANDARD"_s,
+    "HIP_STANDARD"_s,
+    "OBJC_STANDARD"_s,
+    "OBJCXX_STANDARD"_s,
+    "IMPORTED_CXX_MODULES_COMPILE_DEFINITIONS"_s,
+    "IMPORTED_CXX_MODULES_COMPILE_FEATURES"_s,
+    "IMPORTED_CXX_MODULES_COMPILE_OPTIONS"_s,
+    "IMPORTED_CXX_MODULES_INCLUDE_DIRECTORIES"_s,
+    "IMPORTED_CXX_MODULES_LINK_LIBRARIES"_s,
+    "INCLUDE_DIRECTORIES"_s,
+    "INTERFACE_LINK_LIBRARIES"_s,
+    "INTERFACE_LINK_LIBRARIES_DIRECT"_s,
+    "INTERFACE_LINK_LIBRARIES_DIRECT_EXCLUDE"_s,
+    "LINK_DIRECTORIES"_s,
+    "LINK_LIBRARIES"_s,
+    "LINK_OPTIONS"_s,
+    "MANUALLY_ADDED_DEPENDENCIES"_s,
+    "PRECOMPILE_HEADERS"_s,
+    "SOURCES"_s,
+  };
+
+  // Visit every value of a target that its build files depend on.
+  std::string const& config = this->GetConfigName();
+  auto visitTarget = [&](cmGeneratorTarget const* gt, Visitor const& visit) {
+    visit(gt->GetName());
+    visit(std::to_string(static_cast<int>(gt->GetType())));
+    visit(gt->GetLocalGenerator()->GetCurrentBinaryDirectory());
+    visitProperties(gt->Target->GetProperties(), visit);
+    for (cm::string_view prop : specialProps) {
+      if (cmValue value = gt->Target->GetProperty(std::string(prop))) {
+        visit(prop);
+        visit(*value);
+      }
+    }
+#define APPEND_TARGET_POLICY(P)                                               \
+  visit(std::to_string(static_cast<int>(gt->GetPolicyStatus##P())));
+    CM_FOR_EACH_TARGET_POLICY(APPEND_TARGET_POLICY)
+#undef APPEND_TARGET_POLICY
+
+    if (!gt->IsInBuildSystem()) {
+      return;
+    }
+    for (BT<cmSourceFile*> const& sf : gt->GetSourceFiles(config)) {
+      visit(sf.Value->GetFullPath());
+      visitProperties(sf.Value->GetProperties(), visit);
+      // Source properties stored outside of the generic property map.
+      for (auto const* entries : { &sf.Value->GetCompileOptions(),
+                                   &sf.Value->GetCompileDefinitions(),
+                                   &sf.Value->GetIncludeDirectories() }) {
+        visit("\x1f"_s);
+        for (BT<std::string> const& entry : *entries) {
+          visit(entry.Value);
+        }
+      }
+      if (cmCustomCommand const* cc = sf.Value->GetCustomCommand()) {
+        visitCommand(*cc, visit);
+      }
+    }
+    for (auto const* commands :
+         { &gt->GetPreBuildCommands(), &gt->GetPreLinkCommands(),
+           &gt->GetPostBuildCommands() }) {
+      visit("\x1f"_s);
+      for (cmCustomCommand const& cc : *commands) {
+        visitCommand(cc, visit);
+      }
+    }
+  };
+
+  // The targets of this directory, every target they depend on, and every
+  // target named by generator expressions in their values.
+  std::set<cmGeneratorTarget const*, cmGeneratorTarget::StrictTargetComparison>
+    targets;
+  std::set<std::string> referenced;
+  bool knowsReferences = true;
+  std::vector<cmGeneratorTarget const*> pending;
+  for (auto const& gt : this->GetGeneratorTargets()) {
+    targets.insert(gt.get());
+    pending.push_back(gt.get());
+  }
+  while (!pending.empty()) {
+    cmGeneratorTarget const* gt = pending.back();
+    pending.pop_back();
+    std::vector<cmGeneratorTarget const*> deps;
+    if (gt->IsInBuildSystem()) {
+      for (cmTargetDepend const& dep :
+           this->GlobalGenerator->GetTargetDirectDepends(gt)) {
+        deps.push_back(dep);
+      }
+    }
+    if (!gt->IsImported() &&
+        gt->GetType() <= cmStateEnums::OBJECT_LIBRARY) {
+      cm::append(deps,
+                 gt->GetLinkImplementationClosure(
+                   config, cmGeneratorTarget::UseTo::Compile));
+      cm::append(deps,
+                 gt->GetLinkImplementationClosure(
+                   config, cmGeneratorTarget::UseTo::Link));
+    }
+    std::set<std::string> names;
+    visitTarget(gt, [&](cm::string_view value) {
+      knowsReferences = FindReferencedTargets(value, names) && knowsReferences;
+    });
+    for (std::string const& name : names) {
+      if (cmGeneratorTarget const* ref =
+            this->GlobalGenerator->FindGeneratorTarget(name)) {
+        deps.push_back(ref);
+      }
+      referenced.insert(name);
+    }
+    for (cmGeneratorTarget const* dep : deps) {
+      if (targets.insert(dep).second) {
+        pending.push_back(dep);
+      }
+    }
+  }
+
+  // Generator expressions may name targets that cannot be known here.
+  if (!knowsReferences) {
+    return std::string();
+  }
+
+  for (cmGeneratorTarget const* gt : targets) {
+    visitTarget(gt, append);
+  }
+  // Whether a referenced name is a target may change where it is defined.
+  for (std::string const& name : referenced) {
+    append(name);
+    append(this->GlobalGenerator->FindGeneratorTarget(name) ? "1"_s : "0"_s);
+  }
+
+  return hasher.FinalizeHex();
+}
+
+bool cmLocalUnixMakefileGenerator3::ReuseGeneratedFiles(
+  std::string const& fingerprintFile, std::string const& fingerprint)
+{
+  cmsys::ifstream fin(fingerprintFile.c_str());
+  std::string line;
+  if (!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+      !cmSystemTools::GetLineFromStream(fin, line) || line != fingerprint) {
+    return false;
+  }
+
+  std::map<std::string, unsigned long> progress;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    std::string::size_type const pos = line.find(' ');
+    unsigned long actions = 0;
+    if (pos == std::string::npos ||
+        !cmStrToULong(line.substr(0, pos), &actions)) {
+      return false;
+    }
+    progress[line.substr(pos + 1)] = actions;
+  }
+
+  // The files generated last time must still be there.
+  std::string const binDir = this->GetCurrentBinaryDirectory();
+  if (!cmSystemTools::FileExists(cmStrCat(binDir, "/Makefile")) ||
+      !cmSystemTools::FileExists(
+        cmStrCat(binDir, "/CMakeFiles/CMakeDirectoryInformation.cmake"))) {
+    return false;
+  }
+  std::vector<std::pair<cmGeneratorTarget const*, unsigned long>> reused;
+  for (auto const& gt : this->GetGeneratorTargets()) {
+    auto const it = progress.find(gt->GetName());
+    if (it == progress.end()) {
+      continue;
+    }
+    if (!cmSystemTools::FileExists(
+          cmStrCat(gt->GetSupportDirectory(), "/build.make"))) {
+      return false;
+    }
+    reused.emplace_back(gt.get(), it->second);
+  }
+
+  cmGlobalUnixMakefileGenerator3* gg =
+    static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  for (auto const& r : reused) {
+    gg->RecordTargetProgress(r.first, r.second);
+  }
+  return true;
 }
 
 std::string cmLocalUnixMakefileGenerator3::GetObjectOutputRoot(
@@ -596,6 +964,16 @@ void cmLocalUnixMakefileGenerator3::WriteMakeRule(
     os << "# " << replace.substr(lpos) << "\n";
   }
 
+  if (this->IndexedRules) {
+    cmMakefileUpToDateIndex::Rule& rule =
+      (*this->IndexedRules)[this->MaybeRelativeToTopBinDir(target)];
+    for (std::string const& depend : depends) {
+      rule.Depends.emplace_back(this->MaybeRelativeToTopBinDir(depend));
+    }
+    rule.Symbolic = rule.Symbolic || symbolic;
+    rule.HasCommands = rule.HasCommands || !commands.empty();
+  }
+
   // Construct the left hand side of the rule.
   std::string tgt =
     this->ConvertToMakefilePath(this->MaybeRelativeToTopBinDir(target));
@@ -14,6 +14,7 @@
 #include "cmDepends.h"
 #include "cmGeneratorOptions.h"
 #include "cmLocalCommonGenerator.h"
+#include "cmMakefileUpToDateIndex.h"
 #include "cmStateTypes.h"
 
 class cmCustomCommand;
@@ -261,6 +262,9 @@ private:
 
   ImplicitDependTargetMap ImplicitDepends;
 
+  // The rules written while generating a target, if it is indexed.
+  cmMakefileUpToDateIndex::RuleMap* IndexedRules = nullptr;
+
   std::string HomeRelativeOutputPath;
 
   struct LocalObjectEntry
@@ -301,6 +305,12 @@ private:
   bool SkipPreprocessedSourceRules;
   bool SkipAssemblySourceRules;
 
+  // Support for CMAKE_EXPERIMENTAL_INCREMENTAL_GENERATE.
+  bool UseIncrementalGenerate() const;
+  std::string ComputeGenerateFingerprint();
+  bool ReuseGeneratedFiles(std::string const& fingerprintFile,
+                           std::string const& fingerprint);
+
   std::set<cmSourceFile const*>& GetCommandsVisited(
     cmGeneratorTarget const* target)
   {
@@ -119,6 +119,10 @@ void cmLocalVisualStudio7Generator::Generate()
       gtVisited.insert(depVisited.begin(), depVisited.end());
     }
 
+#ifndef CMAKE_BOOTSTRAP
+    auto profilingRAII = this->GetCMakeInstance()->CreateProfilingEntry(
+      "generate", gt->GetName());
+#endif
     this->GenerateTarget(gt);
   }
 
@@ -60,6 +60,7 @@
 #include "cmTargetLinkLibraryType.h"
 #include "cmTest.h"
 #include "cmTestGenerator.h" // IWYU pragma: keep
+#include "cmTryCompileBatch.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
@@ -1719,6 +1720,13 @@ void cmMakefile::Configure()
   this->Defer = cm::make_unique<DeferCommands>();
   this->RunListFile(listFile, currentStart, this->Defer.get());
   this->Defer.reset();
+
+  // Build any try_compile(BATCH) projects the directory did not collect.
+  if (this->TryCompileBatch && !this->TryCompileBatch->empty() &&
+      !cmSystemTools::GetFatalErrorOccurred()) {
+    this->TryCompileBatch->Collect(cmTryCompileBatch::DefaultJobs());
+  }
+  this->TryCompileBatch.reset();
   if (cmSystemTools::GetFatalErrorOccurred()) {
     scope.Quiet();
   }
@@ -2653,6 +2661,7 @@ MessageType cmMakefile::ExpandVariablesInStringImpl(
               }
               break;
             case ENVIRONMENT:
+              this->GetCMakeInstance()->RecordEnvironmentVariable(lookup);
               if (cmSystemTools::GetEnv(lookup, svalue)) {
                 value = cmValue(svalue);
               }
@@ -3249,6 +3258,32 @@ int cmMakefile::TryCompile(std::string const& srcdir,
                            std::string& output)
 {
   this->IsSourceFileTryCompile = fast;
+
+  // unset the NINJA_STATUS environment variable while running try compile.
+  // since we parse the output, we need to ensure there aren't any unexpected
+  // characters that will cause issues, such as ANSI color escape codes.
+  cm::optional<cmSystemTools::ScopedEnv> maybeNinjaStatus;
+  if (this->GetGlobalGenerator()->IsNinja()) {
+    maybeNinjaStatus.emplace("NINJA_STATUS=");
+  }
+
+  if (this->GenerateTryCompile(srcdir, bindir, cmakeArgs) != 0) {
+    this->IsSourceFileTryCompile = false;
+    return 1;
+  }
+
+  // finally call the generator to actually build the resulting project
+  int ret = this->GetGlobalGenerator()->TryCompile(
+    jobs, bindir, projectName, targetName, fast, output, this);
+
+  this->IsSourceFileTryCompile = false;
+  return ret;
+}
+
+int cmMakefile::GenerateTryCompile(std::string const& srcdir,
+                                   std::string const& bindir,
+                                   std::vector<std::string> const* cmakeArgs)
+{
   // does the binary directory exist ? If not create it...
   if (!cmSystemTools::FileIsDirectory(bindir)) {
     cmSystemTools::MakeDirectory(bindir);
@@ -3260,18 +3295,9 @@ int cmMakefile::TryCompile(std::string const& srcdir,
   if (workdir.Failed()) {
     this->IssueMessage(MessageType::FATAL_ERROR, workdir.GetError());
     cmSystemTools::SetFatalErrorOccurred();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
-  // unset the NINJA_STATUS environment variable while running try compile.
-  // since we parse the output, we need to ensure there aren't any unexpected
-  // characters that will cause issues, such as ANSI color escape codes.
-  cm::optional<cmSystemTools::ScopedEnv> maybeNinjaStatus;
-  if (this->GetGlobalGenerator()->IsNinja()) {
-    maybeNinjaStatus.emplace("NINJA_STATUS=");
-  }
-
   // make sure the same generator is used
   // use this program as the cmake to be run, it should not
   // be run that way but the cmake object requires a valid path
@@ -3283,7 +3309,6 @@ int cmMakefile::TryCompile(std::string const& srcdir,
                          this->GetGlobalGenerator()->GetName() +
                          "' could not be created.");
     cmSystemTools::SetFatalErrorOccurred();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
   gg->RecursionDepth = this->RecursionDepth;
@@ -3359,7 +3384,6 @@ int cmMakefile::TryCompile(std::string const& srcdir,
     this->IssueMessage(MessageType::FATAL_ERROR,
                        "Failed to configure test project build system.");
     cmSystemTools::SetFatalErrorOccurred();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
@@ -3367,16 +3391,10 @@ int cmMakefile::TryCompile(std::string const& srcdir,
     this->IssueMessage(MessageType::FATAL_ERROR,
                        "Failed to generate test project build system.");
     cmSystemTools::SetFatalErrorOccurred();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
-  // finally call the generator to actually build the resulting project
-  int ret = this->GetGlobalGenerator()->TryCompile(
-    jobs, bindir, projectName, targetName, fast, output, this);
-
-  this->IsSourceFileTryCompile = false;
-  return ret;
+  return 0;
 }
 
 bool cmMakefile::GetIsSourceFileTryCompile() const
@@ -3384,6 +3402,14 @@ bool cmMakefile::GetIsSourceFileTryCompile() const
   return this->IsSourceFileTryCompile;
 }
 
+cmTryCompileBatch& cmMakefile::GetTryCompileBatch()
+{
+  if (!this->TryCompileBatch) {
+    this->TryCompileBatch = cm::make_unique<cmTryCompileBatch>(this);
+  }
+  return *this->TryCompileBatch;
+}
+
 cmake* cmMakefile::GetCMakeInstance() const
 {
   return this->GlobalGenerator->GetCMakeInstance();
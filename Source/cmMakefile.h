@@ -62,6 +62,7 @@ class cmSourceFile;
 class cmState;
 class cmTest;
 class cmTestGenerator;
+class cmTryCompileBatch;
 class cmVariableWatch;
 class cmake;
 
@@ -152,8 +153,21 @@ public:
                  std::vector<std::string> const* cmakeArgs,
                  std::string& output);
 
+  /**
+   * Configure and generate a try_compile project without building it.
+   * Returns 0 on success.
+   */
+  int GenerateTryCompile(std::string const& srcdir, std::string const& bindir,
+                         std::vector<std::string> const* cmakeArgs);
+
   bool GetIsSourceFileTryCompile() const;
 
+  /**
+   * Get the queue of try_compile(BATCH) calls made in this directory
+   * that have not been collected yet.
+   */
+  cmTryCompileBatch& GetTryCompileBatch();
+
   /**
    * Help enforce global target name uniqueness.
    */
@@ -1238,6 +1252,8 @@ private:
   std::unique_ptr<DeferCommands> Defer;
   bool DeferRunning = false;
 
+  std::unique_ptr<cmTryCompileBatch> TryCompileBatch;
+
   void DoGenerate(cmLocalGenerator& lg);
 
   void RunListFile(cmListFile const& listFile,
@@ -1605,9 +1605,56 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     this->DriveCustomCommands(depends);
   }
 
-  // Write the rule.
+  // CMake must scan the sources itself, or check multiple output pairs,
+  // every time the dependencies are checked.  It must also check the
+  // compiler dependencies itself if make cannot tell whether a dependency
+  // file written in the same second as compiler_depend.internal is newer.
+  if (!this->MultipleOutputPairs.empty() ||
+      this->GlobalGenerator->HasCoarseFileTimes() ||
+      this->GeneratorTarget->HaveFortranSources(this->GetConfigName()) ||
+      !this->LocalGenerator
+         ->GetImplicitDepends(this->GeneratorTarget,
+                              cmDependencyScannerKind::CMake)
+         .empty()) {
+    this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, nullptr,
+                                        depTarget, depends, commands, true);
+    return;
+  }
+
+  // Otherwise CMake only consolidates the dependency files generated by
+  // the compiler into compiler_depend.internal, and does so only if one
+  // of them is newer.  Let make compare their time stamps so that CMake
+  // does not run at all when they have not changed.
+  std::vector<std::string> depFiles;
+  for (auto const& compilerLang : this->LocalGenerator->GetImplicitDepends(
+         this->GeneratorTarget, cmDependencyScannerKind::Compiler)) {
+    for (auto const& compilerPair : compilerLang.second) {
+      if (compilerLang.first == "CUSTOM"_s || compilerLang.first == "LINK"_s) {
+        cm::append(depFiles, compilerPair.second);
+      } else if (!compilerPair.second.empty()) {
+        depFiles.emplace_back(cmStrCat(compilerPair.first, ".d"));
+      }
+    }
+  }
+  if (!depFiles.empty()) {
+    std::string const internalDepFile =
+      cmStrCat(this->TargetBuildDirectoryFull, "/compiler_depend.internal");
+    this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, nullptr,
+                                        internalDepFile, depFiles, commands,
+                                        false);
+    // A dependency file does not exist until its source is compiled.
+    std::vector<std::string> no_depends;
+    std::vector<std::string> no_commands;
+    for (std::string const& depFile : depFiles) {
+      this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, nullptr,
+                                          depFile, no_depends, no_commands,
+                                          false);
+    }
+    depends.emplace_back(internalDepFile);
+  }
+  std::vector<std::string> no_commands;
   this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, nullptr,
-                                      depTarget, depends, commands, true);
+                                      depTarget, depends, no_commands, true);
 }
 
 void cmMakefileTargetGenerator::DriveCustomCommands(
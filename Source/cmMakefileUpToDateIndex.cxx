@@ -0,0 +1,194 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmMakefileUpToDateIndex.h"
+
+#include <set>
+#include <utility>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmFileTime.h"
+#include "cmFileTimeCache.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+std::string IndexFile(std::string const& binaryDir)
+{
+  return cmStrCat(binaryDir, "/CMakeFiles/Makefile.index");
+}
+
+bool CheckTargetIndex(std::string const& binaryDir, std::string const& index,
+                      cmFileTimeCache& ftc, std::string& reason)
+{
+  // Make runs in the top of the build tree.  The compiler dependencies
+  // may name a file by its full path where the index names it relative to
+  // the top of the build tree, so compare full paths.
+  auto fullPath = [&binaryDir](std::string const& path) -> std::string {
+    return cmSystemTools::CollapseFullPath(path, binaryDir);
+  };
+
+  cmsys::ifstream fin(fullPath(index).c_str());
+  if (!fin) {
+    reason = cmStrCat(index, " is missing");
+    return false;
+  }
+  std::map<std::string, std::vector<std::string>> rules;
+  std::vector<std::string> compilerDependFiles;
+  std::vector<std::string>* depends = nullptr;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    if (line.front() == '@') {
+      compilerDependFiles.emplace_back(line.substr(1));
+    } else if (line.front() != ' ') {
+      depends = &rules[fullPath(line)];
+    } else if (depends) {
+      depends->emplace_back(fullPath(line.substr(1)));
+    }
+  }
+
+  // Add the dependencies generated by the compiler, as make does when it
+  // includes compiler_depend.make.
+  for (std::string const& file : compilerDependFiles) {
+    cmsys::ifstream dfin(fullPath(file).c_str());
+    depends = nullptr;
+    while (dfin && cmSystemTools::GetLineFromStream(dfin, line)) {
+      if (line.empty() || line.front() == '#') {
+        continue;
+      }
+      if (line.front() != ' ') {
+        auto const it = rules.find(fullPath(line));
+        if (it == rules.end()) {
+          // Make would consider dependencies we do not know about.
+          reason = cmStrCat(line, " has no indexed rule");
+          return false;
+        }
+        depends = &it->second;
+      } else if (depends) {
+        depends->emplace_back(fullPath(line.substr(1)));
+      }
+    }
+  }
+
+  cmFileTime outputTime;
+  cmFileTime dependTime;
+  for (auto const& rule : rules) {
+    if (!ftc.Load(rule.first, outputTime)) {
+      reason = cmStrCat(rule.first, " is missing");
+      return false;
+    }
+    for (std::string const& depend : rule.second) {
+      if (!ftc.Load(depend, dependTime)) {
+        reason = cmStrCat(depend, " is missing");
+        return false;
+      }
+      if (dependTime.Newer(outputTime)) {
+        reason = cmStrCat(depend, " is newer than ", rule.first);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+bool cmMakefileUpToDateIndex::WriteTargetIndex(
+  std::string const& file, RuleMap const& rules,
+  std::vector<std::string> const& roots, std::string const& compilerDependFile)
+{
+  // Find the rules make considers when it makes the roots.
+  std::set<std::string> reached;
+  std::vector<std::string> queue(roots.rbegin(), roots.rend());
+  std::vector<RuleMap::value_type const*> fileRules;
+  while (!queue.empty()) {
+    std::string name = std::move(queue.back());
+    queue.pop_back();
+    if (!reached.insert(name).second) {
+      continue;
+    }
+    auto const it = rules.find(name);
+    if (it == rules.end()) {
+      // A file without a rule must exist already.
+      continue;
+    }
+    Rule const& rule = it->second;
+    if (rule.Symbolic && rule.HasCommands) {
+      cmSystemTools::RemoveFile(file);
+      return false;
+    }
+    for (std::string const& depend : rule.Depends) {
+      if (!rule.Symbolic) {
+        // A file that depends on a symbolic rule is always out of date.
+        auto const d = rules.find(depend);
+        if (d != rules.end() && d->second.Symbolic) {
+          cmSystemTools::RemoveFile(file);
+          return false;
+        }
+      }
+      queue.emplace_back(depend);
+    }
+    if (!rule.Symbolic) {
+      fileRules.emplace_back(&*it);
+    }
+  }
+
+  cmGeneratedFileStream fout(file);
+  fout.SetCopyIfDifferent(true);
+  fout << "# CMAKE generated file: DO NOT EDIT!\n"
+          "# Rules checked by \"cmake --build\" before running make.\n\n"
+       << '@' << compilerDependFile << '\n';
+  for (RuleMap::value_type const* rule : fileRules) {
+    fout << rule->first << '\n';
+    for (std::string const& depend : rule->second.Depends) {
+      fout << ' ' << depend << '\n';
+    }
+  }
+  return true;
+}
+
+void cmMakefileUpToDateIndex::WriteIndex(
+  std::string const& binaryDir, std::vector<std::string> const& targetIndexes)
+{
+  cmGeneratedFileStream fout(IndexFile(binaryDir));
+  fout.SetCopyIfDifferent(true);
+  fout << "# CMAKE generated file: DO NOT EDIT!\n"
+          "# Indexes of the targets built by \"all\".\n\n";
+  for (std::string const& index : targetIndexes) {
+    fout << index << '\n';
+  }
+}
+
+void cmMakefileUpToDateIndex::RemoveIndex(std::string const& binaryDir)
+{
+  cmSystemTools::RemoveFile(IndexFile(binaryDir));
+}
+
+bool cmMakefileUpToDateIndex::HasIndex(std::string const& binaryDir)
+{
+  return cmSystemTools::FileExists(IndexFile(binaryDir), true);
+}
+
+bool cmMakefileUpToDateIndex::IsUpToDate(std::string const& binaryDir,
+                                         cmFileTimeCache& ftc,
+                                         std::string& reason)
+{
+  cmsys::ifstream fin(IndexFile(binaryDir).c_str());
+  if (!fin) {
+    reason = "CMakeFiles/Makefile.index is missing";
+    return false;
+  }
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    if (!CheckTargetIndex(binaryDir, line, ftc, reason)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <string>
+#include <vector>
+
+class cmFileTimeCache;
+
+/** \class cmMakefileUpToDateIndex
+ * \brief Index of the Makefile rules that "cmake --build" checks itself
+ *
+ * The rules that make considers when building a target are written to a
+ * build.index file next to its build.make: each file produced by a rule
+ * followed by the files it depends on.  CMakeFiles/Makefile.index lists
+ * the indexes of the targets built by the "all" target.  Before running
+ * make, "cmake --build" compares the time stamps of these files, and
+ * does not run make if no rule would run.
+ *
+ * A target for which make would always run a command, such as a custom
+ * target or one whose dependencies CMake scans itself, has no index.
+ * A build including it is never considered up to date.
+ */
+class cmMakefileUpToDateIndex
+{
+public:
+  struct Rule
+  {
+    std::vector<std::string> Depends;
+    bool Symbolic = false;
+    bool HasCommands = false;
+  };
+  using RuleMap = std::map<std::string, Rule>;
+
+  /**
+   * Write the index of the rules reached from the symbolic rules
+   * \p roots.  The dependencies recorded in \p compilerDependFile are
+   * added to the rules when they are checked.  If make would always run
+   * a command, remove the index instead and return false.
+   */
+  static bool WriteTargetIndex(std::string const& file, RuleMap const& rules,
+                               std::vector<std::string> const& roots,
+                               std::string const& compilerDependFile);
+
+  /** Write the list of indexes of the targets built by "all".  */
+  static void WriteIndex(std::string const& binaryDir,
+                         std::vector<std::string> const& targetIndexes);
+
+  /** Remove the list of indexes so the build is always checked by make.  */
+  static void RemoveIndex(std::string const& binaryDir);
+
+  /** Return whether an index of the build tree exists.  */
+  static bool HasIndex(std::string const& binaryDir);
+
+  /**
+   * Check whether make would run no rule of the indexed targets.  If it
+   * would, \p reason tells which file is out of date.
+   */
+  static bool IsUpToDate(std::string const& binaryDir, cmFileTimeCache& ftc,
+                         std::string& reason);
+};
@@ -0,0 +1,242 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+  @brief A hash map whose copies share structure
+
+  This is a hash array mapped trie.  Copying a map is O(1) and shares
+  all of its nodes with the original.  Modifying a map copies only the
+  nodes on the path to the modified entry, and only if they are still
+  shared with another map, so a copy costs memory proportional to the
+  number of entries changed after it was made.
+
+  This class is not intended to be wholly generic like a standard library
+  container.  Mostly it exists to facilitate structural sharing of variable
+  scopes in cmDefinitions.  Nodes are modified in place when not shared,
+  so separate maps sharing nodes may not be modified concurrently.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class cmPersistentHashMap
+{
+public:
+  using value_type = std::pair<Key, T>;
+
+  std::size_t size() const { return this->Size; }
+  bool empty() const { return this->Size == 0; }
+
+  /** Return the value of a key, or nullptr if it is not in the map.  */
+  T const* Find(Key const& key) const
+  {
+    std::size_t const hash = Hash{}(key);
+    Node const* node = this->Root.get();
+    for (unsigned depth = 0; node; ++depth) {
+      if (depth == MaxDepth) {
+        for (value_type const& entry : node->Entries) {
+          if (KeyEqual{}(entry.first, key)) {
+            return &entry.second;
+          }
+        }
+        return nullptr;
+      }
+      std::uint32_t const bit = Bit(hash, depth);
+      if (node->EntryMap & bit) {
+        value_type const& entry = node->Entries[Index(node->EntryMap, bit)];
+        return KeyEqual{}(entry.first, key) ? &entry.second : nullptr;
+      }
+      if (!(node->ChildMap & bit)) {
+        return nullptr;
+      }
+      node = node->Children[Index(node->ChildMap, bit)].get();
+    }
+    return nullptr;
+  }
+
+  /** Set the value of a key and return a reference to the stored value.  */
+  T const& Set(Key key, T value)
+  {
+    std::size_t const hash = Hash{}(key);
+    return Assign(this->Root, 0, hash, std::move(key), std::move(value),
+                  this->Size);
+  }
+
+  /** Remove a key.  Return whether it was in the map.  */
+  bool Erase(Key const& key)
+  {
+    // Avoid copying shared nodes if there is nothing to remove.
+    if (!this->Find(key)) {
+      return false;
+    }
+    Remove(this->Root, 0, Hash{}(key), key);
+    --this->Size;
+    return true;
+  }
+
+  /** Call f(key, value) for each entry, in an unspecified order.  */
+  template <typename F>
+  void ForEach(F&& f) const
+  {
+    if (this->Root) {
+      Visit(*this->Root, f);
+    }
+  }
+
+private:
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+
+  // Each node has a slot for every value of one 5-bit fragment of the hash.
+  // A slot holds either an entry or a child node for the next fragment.
+  // Once the hash is exhausted, a node holds colliding entries in a list.
+  struct Node
+  {
+    std::uint32_t EntryMap = 0;
+    std::uint32_t ChildMap = 0;
+    std::vector<value_type> Entries;
+    std::vector<NodePtr> Children;
+  };
+
+  static unsigned const BitsPerLevel = 5;
+  static unsigned const MaxDepth =
+    (sizeof(std::size_t) * 8 + BitsPerLevel - 1) / BitsPerLevel;
+
+  static std::uint32_t Bit(std::size_t hash, unsigned depth)
+  {
+    return std::uint32_t(1)
+      << ((hash >> (depth * BitsPerLevel)) & ((1u << BitsPerLevel) - 1));
+  }
+
+  static std::size_t Index(std::uint32_t map, std::uint32_t bit)
+  {
+    std::uint32_t v = map & (bit - 1);
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+  }
+
+  // Make the node in a slot safe to modify by copying it if it is shared.
+  static Node& Writable(NodePtr& slot)
+  {
+    if (!slot) {
+      slot = std::make_shared<Node>();
+    } else if (slot.use_count() != 1) {
+      slot = std::make_shared<Node>(*slot);
+    }
+    return *slot;
+  }
+
+  static T const& Assign(NodePtr& slot, unsigned depth, std::size_t hash,
+                         Key&& key, T&& value, std::size_t& size)
+  {
+    Node& node = Writable(slot);
+    if (depth == MaxDepth) {
+      for (value_type& entry : node.Entries) {
+        if (KeyEqual{}(entry.first, key)) {
+          entry.second = std::move(value);
+          return entry.second;
+        }
+      }
+      node.Entries.emplace_back(std::move(key), std::move(value));
+      ++size;
+      return node.Entries.back().second;
+    }
+
+    std::uint32_t const bit = Bit(hash, depth);
+    if (node.ChildMap & bit) {
+      return Assign(node.Children[Index(node.ChildMap, bit)], depth + 1, hash,
+                    std::move(key), std::move(value), size);
+    }
+
+    if (node.EntryMap & bit) {
+      auto const ei = node.Entries.begin() + Index(node.EntryMap, bit);
+      if (KeyEqual{}(ei->first, key)) {
+        ei->second = std::move(value);
+        return ei->second;
+      }
+      // Move the existing entry down to a new child shared with the key.
+      value_type existing = std::move(*ei);
+      node.Entries.erase(ei);
+      node.EntryMap &= ~bit;
+      NodePtr child;
+      std::size_t childSize = 0;
+      std::size_t const existingHash = Hash{}(existing.first);
+      Assign(child, depth + 1, existingHash, std::move(existing.first),
+             std::move(existing.second), childSize);
+      T const& result = Assign(child, depth + 1, hash, std::move(key),
+                               std::move(value), size);
+      node.Children.insert(node.Children.begin() + Index(node.ChildMap, bit),
+                           std::move(child));
+      node.ChildMap |= bit;
+      return result;
+    }
+
+    auto const ei = node.Entries.insert(
+      node.Entries.begin() + Index(node.EntryMap, bit),
+      value_type(std::move(key), std::move(value)));
+    node.EntryMap |= bit;
+    ++size;
+    return ei->second;
+  }
+
+  // Remove a key known to be in the subtree.  Return whether the node in
+  // the slot is now empty.
+  static bool Remove(NodePtr& slot, unsigned depth, std::size_t hash,
+                     Key const& key)
+  {
+    Node& node = Writable(slot);
+    if (depth == MaxDepth) {
+      for (auto ei = node.Entries.begin(); ei != node.Entries.end(); ++ei) {
+        if (KeyEqual{}(ei->first, key)) {
+          node.Entries.erase(ei);
+          break;
+        }
+      }
+      return node.Entries.empty();
+    }
+
+    std::uint32_t const bit = Bit(hash, depth);
+    if (node.EntryMap & bit) {
+      node.Entries.erase(node.Entries.begin() + Index(node.EntryMap, bit));
+      node.EntryMap &= ~bit;
+    } else {
+      auto const ci = node.Children.begin() + Index(node.ChildMap, bit);
+      if (Remove(*ci, depth + 1, hash, key)) {
+        node.Children.erase(ci);
+        node.ChildMap &= ~bit;
+      } else if ((*ci)->Children.empty() && (*ci)->Entries.size() == 1) {
+        // Pull a lone remaining entry back up into this node.
+        value_type entry = std::move((*ci)->Entries.front());
+        node.Children.erase(ci);
+        node.ChildMap &= ~bit;
+        node.Entries.insert(node.Entries.begin() + Index(node.EntryMap, bit),
+                            std::move(entry));
+        node.EntryMap |= bit;
+      }
+    }
+    return node.Entries.empty() && node.Children.empty();
+  }
+
+  template <typename F>
+  static void Visit(Node const& node, F& f)
+  {
+    for (value_type const& entry : node.Entries) {
+      f(entry.first, entry.second);
+    }
+    for (NodePtr const& child : node.Children) {
+      Visit(*child, f);
+    }
+  }
+
+  NodePtr Root;
+  std::size_t Size = 0;
+};
@@ -20,6 +20,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmValue.h"
+#include "cmake.h"
 
 namespace {
 void setENV(std::string const& var, cm::string_view val)
@@ -51,6 +52,9 @@ bool cmSetCommand(std::vector<std::string> const& args,
     // what is the variable name
     auto const& varName = variable.substr(4, variable.size() - 5);
 
+    status.GetMakefile().GetCMakeInstance()->RecordEnvironmentVariable(
+      varName);
+
     // what is the current value if any
     std::string currValue;
     bool const currValueSet = cmSystemTools::GetEnv(varName, currValue);
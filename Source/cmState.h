@@ -198,6 +198,10 @@ public:
                             bool asString = false);
   cmValue GetGlobalProperty(std::string const& prop);
   bool GetGlobalPropertyAsBool(std::string const& prop);
+  cmPropertyMap const& GetGlobalProperties() const
+  {
+    return this->GlobalProperties;
+  }
 
   std::string const& GetSourceDirectory() const;
   void SetSourceDirectory(std::string const& sourceDirectory);
@@ -9,6 +9,10 @@
 #include <utility>
 #include <vector>
 
+#ifndef CMAKE_BOOTSTRAP
+#  include <cm3p/json/value.h>
+#endif
+
 #include "cmDiagnostics.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
@@ -63,6 +67,20 @@ std::string TestName(cmTest* test)
   return name;
 }
 
+std::string BacktraceTriples(cmListFileBacktrace bt)
+{
+  std::string triples;
+  while (!bt.Empty()) {
+    auto const& entry = bt.Top();
+    if (!triples.empty()) {
+      triples += ';';
+    }
+    triples += cmStrCat(entry.FilePath, ';', entry.Line, ';', entry.Name);
+    bt = bt.Pop();
+  }
+  return triples;
+}
+
 } // End: anonymous namespace
 
 cmTestGenerator::cmTestGenerator(
@@ -92,6 +110,15 @@ cmTest* cmTestGenerator::GetTest() const
   return this->Test;
 }
 
+void cmTestGenerator::GenerateScript(std::ostream& os)
+{
+  this->ManifestVariants.clear();
+  this->ManifestNotAvailable = false;
+  this->ImpactTargets.clear();
+  this->ImpactFiles.clear();
+  this->cmScriptGenerator::GenerateScript(os);
+}
+
 void cmTestGenerator::GenerateScriptActions(std::ostream& os, Indent indent)
 {
   if (this->ActionsPerConfig) {
@@ -106,12 +133,10 @@ void cmTestGenerator::GenerateScriptActions(std::ostream& os, Indent indent)
   }
 }
 
-void cmTestGenerator::GenerateCommand(std::ostream& os,
-                                      std::vector<std::string> const& command,
-                                      std::string const& config, bool expand,
-                                      cmGeneratorExpression& ge,
-                                      cmPolicies::PolicyStatus cmp0158,
-                                      cmPolicies::PolicyStatus cmp0178)
+std::vector<std::string> cmTestGenerator::EvaluateCommand(
+  std::vector<std::string> const& command, std::string const& config,
+  bool expand, cmGeneratorExpression& ge, cmPolicies::PolicyStatus cmp0158,
+  cmPolicies::PolicyStatus cmp0178)
 {
   // Evaluate command line arguments
   cmList argv{
@@ -125,11 +150,15 @@ void cmTestGenerator::GenerateCommand(std::ostream& os,
     argv.emplace_back();
   }
 
+  std::vector<std::string> result;
+
   // Check whether the command executable is a target whose name is to
   // be translated.
   std::string exe = argv[0];
   cmGeneratorTarget* target = this->LG->FindGeneratorTargetToUse(exe);
   if (target && target->GetType() == cmStateEnums::EXECUTABLE) {
+    this->ImpactTargets.insert(target);
+
     // Use the target file on disk.
     exe = target->GetFullPath(config);
 
@@ -160,10 +189,10 @@ void cmTestGenerator::GenerateCommand(std::ostream& os,
         }
         std::string launcherExe(launcherWithArgs[0]);
         cmSystemTools::ConvertToUnixSlashes(launcherExe);
-        os << cmScriptGenerator::Quote(launcherExe) << " ";
+        result.emplace_back(std::move(launcherExe));
         for (std::string const& arg :
              cmMakeRange(launcherWithArgs).advance(1)) {
-          os << cmScriptGenerator::Quote(arg) << " ";
+          result.emplace_back(arg);
         }
       }
     };
@@ -181,11 +210,26 @@ void cmTestGenerator::GenerateCommand(std::ostream& os,
     cmSystemTools::ConvertToUnixSlashes(exe);
   }
 
-  // Generate the command line with full escapes.
-  os << cmScriptGenerator::Quote(exe);
-
+  result.emplace_back(std::move(exe));
   for (auto const& arg : cmMakeRange(argv).advance(1)) {
-    os << " " << cmScriptGenerator::Quote(arg);
+    result.emplace_back(arg);
+  }
+  return result;
+}
+
+void cmTestGenerator::GenerateCommand(std::ostream& os,
+                                      std::vector<std::string> const& command,
+                                      std::string const& config, bool expand,
+                                      cmGeneratorExpression& ge,
+                                      cmPolicies::PolicyStatus cmp0158,
+                                      cmPolicies::PolicyStatus cmp0178)
+{
+  // Generate the command line with full escapes.
+  char const* sep = "";
+  for (std::string const& arg :
+       this->EvaluateCommand(command, config, expand, ge, cmp0158, cmp0178)) {
+    os << sep << cmScriptGenerator::Quote(arg);
+    sep = " ";
   }
 }
 
@@ -199,28 +243,62 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
   cmGeneratorExpression ge(*this->Test->GetMakefile()->GetCMakeInstance(),
                            this->Test->GetBacktrace());
 
+  ManifestVariant variant;
+  if (this->ConfigurationTypes->empty()) {
+    variant.Configurations = this->Configurations;
+  } else {
+    variant.Configurations.push_back(config);
+  }
+  variant.Command = this->EvaluateCommand(
+    this->Test->GetCommand(), config, this->Test->GetCommandExpandLists(), ge,
+    this->GetTest()->GetCMP0158(), this->Test->GetCMP0178());
+
   auto const test_name = TestName(this->Test);
-  os << indent << "add_test(" << test_name << ' ';
-  this->GenerateCommand(
-    os, this->Test->GetCommand(), config, this->Test->GetCommandExpandLists(),
-    ge, this->GetTest()->GetCMP0158(), this->Test->GetCMP0178());
+  os << indent << "add_test(" << test_name;
+  for (std::string const& arg : variant.Command) {
+    os << ' ' << cmScriptGenerator::Quote(arg);
+  }
   os << ")\n";
 
   // Output properties for the test.
   os << indent << "set_tests_properties(" << test_name << " PROPERTIES ";
   for (auto const& i : this->Test->GetProperties().GetList()) {
+    auto cge = ge.Parse(i.second);
+    variant.Properties.emplace_back(i.first, cge->Evaluate(this->LG, config));
+    this->AddImpactTargets(*cge);
     os << " " << i.first << " "
-       << cmScriptGenerator::Quote(
-            ge.Parse(i.second)->Evaluate(this->LG, config));
+       << cmScriptGenerator::Quote(variant.Properties.back().second);
   }
   os << ' ';
   this->GenerateBacktrace(os, this->Test->GetBacktrace());
   os << ")\n";
+
+  // Record the files the test uses.  Required files are found relative
+  // to the directory of the test file.
+  std::string const& binaryDir = this->LG->GetCurrentBinaryDirectory();
+  std::string const& sourceDir = this->LG->GetSourceDirectory();
+  for (auto const& p : variant.Properties) {
+    if (p.first == "REQUIRED_FILES") {
+      for (std::string const& file : cmList{ p.second }) {
+        this->ImpactFiles.insert(
+          cmSystemTools::CollapseFullPath(file, binaryDir));
+      }
+    }
+  }
+  for (std::string const& arg : variant.Command) {
+    if (cmSystemTools::FileIsFullPath(arg) &&
+        cmSystemTools::IsSubDirectory(arg, sourceDir)) {
+      this->ImpactFiles.insert(cmSystemTools::CollapseFullPath(arg));
+    }
+  }
+
+  this->ManifestVariants.emplace_back(std::move(variant));
 }
 
 void cmTestGenerator::GenerateScriptNoConfig(std::ostream& os, Indent indent)
 {
   os << indent << "add_test(" << TestName(this->Test) << " NOT_AVAILABLE)\n";
+  this->ManifestNotAvailable = true;
 }
 
 bool cmTestGenerator::NeedsScriptNoConfig() const
@@ -278,31 +356,99 @@ void cmTestGenerator::GenerateBacktrace(std::ostream& os,
     return;
   }
 
-  os << "_BACKTRACE_TRIPLES \"";
+  os << "_BACKTRACE_TRIPLES \"" << BacktraceTriples(std::move(bt)) << '"';
+}
 
-  bool prependTripleSeparator = false;
-  while (!bt.Empty()) {
-    auto const& entry = bt.Top();
-    if (prependTripleSeparator) {
-      os << ";";
-    }
-    os << entry.FilePath << ";" << entry.Line << ";" << entry.Name;
-    bt = bt.Pop();
-    prependTripleSeparator = true;
+#ifndef CMAKE_BOOTSTRAP
+bool cmTestGenerator::GenerateManifest(Json::Value& tests) const
+{
+  // Old-style tests are re-parsed by ctest with variable references.
+  if (!this->Test || !this->ActionsPerConfig) {
+    return false;
+  }
+  // Without CMP0110, ctest re-parses the test name, so it may not be the
+  // name given.
+  if (this->Test->GetMakefile()->GetPolicyStatus(cmPolicies::CMP0110) !=
+        cmPolicies::NEW &&
+      this->Test->GetName().find_first_of("$[] #;\t\n\"\\()") !=
+        std::string::npos) {
+    return false;
+  }
+  if (this->ManifestVariants.empty() && !this->ManifestNotAvailable) {
+    return true;
   }
 
-  os << '"';
+  Json::Value test = Json::objectValue;
+  test["name"] = this->Test->GetName();
+  Json::Value& variants = test["variants"] = Json::arrayValue;
+  std::string const triples = BacktraceTriples(this->Test->GetBacktrace());
+  for (ManifestVariant const& v : this->ManifestVariants) {
+    Json::Value variant = Json::objectValue;
+    if (!v.Configurations.empty()) {
+      Json::Value& configs = variant["configurations"] = Json::arrayValue;
+      for (std::string const& config : v.Configurations) {
+        configs.append(config);
+      }
+    }
+    Json::Value& command = variant["command"] = Json::arrayValue;
+    for (std::string const& arg : v.Command) {
+      command.append(arg);
+    }
+    Json::Value& properties = variant["properties"] = Json::arrayValue;
+    auto addProperty = [&properties](std::string const& name,
+                                     std::string const& value) {
+      Json::Value property = Json::arrayValue;
+      property.append(name);
+      property.append(value);
+      properties.append(std::move(property));
+    };
+    for (auto const& p : v.Properties) {
+      addProperty(p.first, p.second);
+    }
+    if (!triples.empty()) {
+      addProperty("_BACKTRACE_TRIPLES", triples);
+    }
+    variants.append(std::move(variant));
+  }
+  if (this->ManifestNotAvailable) {
+    test["notAvailable"] = true;
+  }
+  tests.append(std::move(test));
+  return true;
 }
+#endif
 
 std::vector<std::string> cmTestGenerator::EvaluateCommandLineArguments(
   std::vector<std::string> const& argv, cmGeneratorExpression& ge,
-  std::string const& config) const
+  std::string const& config)
 {
   // Evaluate executable name and arguments
-  auto evaluatedRange =
-    cmMakeRange(argv).transform([&](std::string const& arg) {
-      return ge.Parse(arg)->Evaluate(this->LG, config);
-    });
+  std::vector<std::string> result;
+  result.reserve(argv.size());
+  for (std::string const& arg : argv) {
+    auto cge = ge.Parse(arg);
+    result.emplace_back(cge->Evaluate(this->LG, config));
+    this->AddImpactTargets(*cge);
+  }
+  return result;
+}
+
+void cmTestGenerator::AddImpactTargets(
+  cmCompiledGeneratorExpression const& cge)
+{
+  for (cmGeneratorTarget const* target : cge.GetAllTargetsSeen()) {
+    this->ImpactTargets.insert(target);
+  }
+}
 
-  return { evaluatedRange.begin(), evaluatedRange.end() };
+bool cmTestGenerator::GetImpactInputs(
+  std::set<cmGeneratorTarget const*>& targets,
+  std::set<std::string>& files) const
+{
+  if (!this->Test || !this->ActionsPerConfig) {
+    return false;
+  }
+  targets.insert(this->ImpactTargets.begin(), this->ImpactTargets.end());
+  files.insert(this->ImpactFiles.begin(), this->ImpactFiles.end());
+  return true;
 }
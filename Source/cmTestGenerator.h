@@ -5,17 +5,25 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <iosfwd>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cmPolicies.h"
 #include "cmScriptGenerator.h"
 
+class cmCompiledGeneratorExpression;
 class cmListFileBacktrace;
 class cmGeneratorExpression;
+class cmGeneratorTarget;
 class cmLocalGenerator;
 class cmTest;
 
+namespace Json {
+class Value;
+}
+
 /** \class cmTestGenerator
  * \brief Support class for generating install scripts.
  *
@@ -38,19 +46,58 @@ public:
 
   cmTest* GetTest() const;
 
+#ifndef CMAKE_BOOTSTRAP
+  /**
+   * Append the test as generated by the last call to Generate to the
+   * tests of a manifest that ctest may load instead of the script.
+   * Returns false if the test cannot be described without script code.
+   */
+  bool GenerateManifest(Json::Value& tests) const;
+#endif
+
+  /**
+   * Add the targets and files used by the test as generated by the last
+   * call to Generate: the executable target it runs, targets named by
+   * generator expressions in its command and properties, its
+   * REQUIRED_FILES, and files of the source tree named on its command
+   * line.  Returns false if they are not known, as for old-style tests.
+   */
+  bool GetImpactInputs(std::set<cmGeneratorTarget const*>& targets,
+                       std::set<std::string>& files) const;
+
 private:
   std::vector<std::string> EvaluateCommandLineArguments(
     std::vector<std::string> const& argv, cmGeneratorExpression& ge,
-    std::string const& config) const;
+    std::string const& config);
+  void AddImpactTargets(cmCompiledGeneratorExpression const& cge);
+
+  // The test as evaluated for one configuration.
+  struct ManifestVariant
+  {
+    // The runtime configurations to which the variant is limited, if any.
+    std::vector<std::string> Configurations;
+    std::vector<std::string> Command;
+    std::vector<std::pair<std::string, std::string>> Properties;
+  };
+  std::vector<ManifestVariant> ManifestVariants;
+  bool ManifestNotAvailable = false;
+
+  std::set<cmGeneratorTarget const*> ImpactTargets;
+  std::set<std::string> ImpactFiles;
 
 protected:
   void GenerateBacktrace(std::ostream& os, cmListFileBacktrace bt);
+  std::vector<std::string> EvaluateCommand(
+    std::vector<std::string> const& command, std::string const& config,
+    bool expand, cmGeneratorExpression& ge, cmPolicies::PolicyStatus cmp0158,
+    cmPolicies::PolicyStatus cmp0178);
   void GenerateCommand(std::ostream& os,
                        std::vector<std::string> const& command,
                        std::string const& config, bool expand,
                        cmGeneratorExpression& ge,
                        cmPolicies::PolicyStatus cmp0158 = cmPolicies::NEW,
                        cmPolicies::PolicyStatus cmp0178 = cmPolicies::NEW);
+  void GenerateScript(std::ostream& os) override;
   void GenerateScriptActions(std::ostream& os, Indent indent) override;
   void GenerateScriptForConfig(std::ostream& os, std::string const& config,
                                Indent indent) override;
@@ -0,0 +1,98 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmTryCompileBatch.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <cm/optional>
+
+#ifndef CMAKE_BOOTSTRAP
+#  include <algorithm>
+#  include <thread>
+#endif
+
+#include "cmConfigureLog.h"
+#include "cmGlobalGenerator.h"
+#include "cmMakefile.h"
+#include "cmake.h"
+
+cmTryCompileBatch::cmTryCompileBatch(cmMakefile* mf)
+  : Makefile(mf)
+{
+}
+
+cmTryCompileBatch::~cmTryCompileBatch() = default;
+
+void cmTryCompileBatch::Add(cmCoreTryCompile tryCompile,
+                            cmCoreTryCompile::Arguments arguments)
+{
+  this->Entries.emplace_back(
+    Entry{ std::move(tryCompile), std::move(arguments) });
+}
+
+void cmTryCompileBatch::Collect(unsigned int jobs)
+{
+  // Take the entries so that try_compile(BATCH) calls made while the
+  // results are set, e.g. by a variable_watch callback, start a new batch.
+  std::vector<Entry> entries = std::move(this->Entries);
+  this->Entries.clear();
+
+  // Build only the projects whose result is not cached.
+  std::vector<cmGlobalGenerator::TryCompileBuild> builds(entries.size());
+  std::vector<cmGlobalGenerator::TryCompileBuild> pending;
+  std::vector<std::size_t> pendingEntries;
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    cmCoreTryCompile const& tc = entries[i].TryCompile;
+    if (tc.GetCachedBuild(builds[i].Result, builds[i].Output)) {
+      continue;
+    }
+    cmGlobalGenerator::TryCompileBuild build;
+    build.BinaryDirectory = tc.BinaryDirectory;
+    build.ProjectName = tc.ProjectName;
+    build.TargetName = tc.TargetName;
+    build.Fast = tc.SrcFileSignature;
+    pending.emplace_back(std::move(build));
+    pendingEntries.emplace_back(i);
+  }
+  if (!pending.empty()) {
+    this->Makefile->GetGlobalGenerator()->TryCompileBatch(jobs, pending,
+                                                          this->Makefile);
+  }
+  for (std::size_t i = 0; i < pending.size(); ++i) {
+    std::size_t const entry = pendingEntries[i];
+    entries[entry].TryCompile.StoreCachedBuild(pending[i].Result,
+                                               pending[i].Output);
+    builds[entry] = std::move(pending[i]);
+  }
+
+  cmake* cm = this->Makefile->GetCMakeInstance();
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    cmCoreTryCompile& tc = entries[i].TryCompile;
+    cmCoreTryCompile::Arguments& arguments = entries[i].Arguments;
+    cm::optional<cmTryCompileResult> compileResult = tc.FinishTryCompileCode(
+      arguments, builds[i].Result, std::move(builds[i].Output));
+#ifndef CMAKE_BOOTSTRAP
+    if (compileResult && !arguments.NoLog) {
+      if (cmConfigureLog* log = cm->GetConfigureLog()) {
+        cmCoreTryCompile::WriteTryCompileEvent(*log, *this->Makefile,
+                                               *compileResult);
+      }
+    }
+#endif
+    if (tc.SrcFileSignature && !cm->GetDebugTryCompile()) {
+      tc.CleanupFiles(tc.BinaryDirectory);
+    }
+  }
+}
+
+unsigned int cmTryCompileBatch::DefaultJobs()
+{
+#ifndef CMAKE_BOOTSTRAP
+  return std::max(std::thread::hardware_concurrency(), 1u);
+#else
+  // Bootstrap builds the projects one at a time.
+  return 1;
+#endif
+}
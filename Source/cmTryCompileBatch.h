@@ -0,0 +1,52 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <vector>
+
+#include "cmCoreTryCompile.h"
+
+class cmMakefile;
+
+/** \class cmTryCompileBatch
+ * \brief Projects of try_compile(BATCH) calls waiting to be built
+ *
+ * The project of each call is written and generated when the call is made,
+ * because configuring a project is not thread-safe.  Only the builds are
+ * deferred.  They do not depend on each other, so Collect runs them
+ * concurrently and then sets the results of the calls in order.
+ */
+class cmTryCompileBatch
+{
+public:
+  cmTryCompileBatch(cmMakefile* mf);
+  ~cmTryCompileBatch();
+
+  cmTryCompileBatch(cmTryCompileBatch const&) = delete;
+  cmTryCompileBatch& operator=(cmTryCompileBatch const&) = delete;
+
+  /** Queue the build of a project generated by GenerateTryCompileCode.  */
+  void Add(cmCoreTryCompile tryCompile,
+           cmCoreTryCompile::Arguments arguments);
+
+  bool empty() const { return this->Entries.empty(); }
+
+  /** Build the queued projects, running up to \p jobs builds at a time,
+      and set the results of their try_compile calls.  */
+  void Collect(unsigned int jobs);
+
+  /** Number of concurrent builds to use if none is requested.  */
+  static unsigned int DefaultJobs();
+
+private:
+  struct Entry
+  {
+    cmCoreTryCompile TryCompile;
+    cmCoreTryCompile::Arguments Arguments;
+  };
+
+  cmMakefile* Makefile;
+  std::vector<Entry> Entries;
+};
@@ -0,0 +1,256 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#include "cmTryCompileCache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmGeneratedFileStream.h"
+#include "cmGlobalGenerator.h"
+#include "cmMakefile.h"
+#include "cmState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmValue.h"
+#include "cmVersion.h"
+
+namespace {
+char const* const BinaryDirectoryPlaceholder =
+  "@CMAKE_TRY_COMPILE_BINARY_DIR@";
+char const* const TargetNamePlaceholder = "@CMAKE_TRY_COMPILE_TARGET_NAME@";
+
+// Replace the names that differ between runs of the same check.
+std::string MakePlaceholders(std::string text,
+                             std::string const& binaryDirectory,
+                             std::string const& targetName)
+{
+  cmSystemTools::ReplaceString(text, binaryDirectory,
+                               BinaryDirectoryPlaceholder);
+  if (!targetName.empty()) {
+    cmSystemTools::ReplaceString(text, targetName, TargetNamePlaceholder);
+  }
+  return text;
+}
+
+std::string ReplacePlaceholders(std::string text,
+                                std::string const& binaryDirectory,
+                                std::string const& targetName)
+{
+  cmSystemTools::ReplaceString(text, BinaryDirectoryPlaceholder,
+                               binaryDirectory);
+  cmSystemTools::ReplaceString(text, TargetNamePlaceholder, targetName);
+  return text;
+}
+
+void ListFiles(std::string const& dir, std::string const& rel,
+               std::vector<std::string>& files)
+{
+  cmsys::Directory d;
+  if (!d.Load(dir)) {
+    return;
+  }
+  for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+    std::string const& name = d.GetFileName(i);
+    if (name == "." || name == "..") {
+      continue;
+    }
+    std::string relPath = rel.empty() ? name : cmStrCat(rel, '/', name);
+    if (d.FileIsDirectory(i) && !d.FileIsSymlink(i)) {
+      ListFiles(cmStrCat(dir, '/', name), relPath, files);
+    } else {
+      files.emplace_back(std::move(relPath));
+    }
+  }
+}
+
+bool ReadFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(fin),
+                 std::istreambuf_iterator<char>());
+  return !fin.bad();
+}
+}
+
+std::string cmTryCompileCache::GetFile(cmMakefile const& mf,
+                                       std::string const& binaryDirectory,
+                                       std::string const& targetName,
+                                       std::vector<std::string> const& keyArgs)
+{
+  std::string cacheDir = mf.GetSafeDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if (cacheDir.empty()) {
+    cmSystemTools::GetEnv("CMAKE_TRY_COMPILE_CACHE_DIR", cacheDir);
+  }
+  if (cacheDir.empty()) {
+    return std::string();
+  }
+  cacheDir =
+    cmSystemTools::CollapseFullPath(cacheDir, mf.GetHomeOutputDirectory());
+  cmValue platformInfoDir = mf.GetDefinition("CMAKE_PLATFORM_INFO_DIR");
+  if (!platformInfoDir) {
+    return std::string();
+  }
+
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view value) {
+    hasher.Append(value);
+    hasher.Append(cm::string_view("", 1));
+  };
+  auto appendFile = [&append](std::string const& path) -> bool {
+    std::string content;
+    if (!ReadFile(path, content)) {
+      return false;
+    }
+    append(content);
+    return true;
+  };
+
+  append("try_compile-cache-v1"_s);
+  append(cmVersion::GetCMakeVersion());
+  append(mf.GetGlobalGenerator()->GetName());
+  for (cm::string_view var :
+       { "CMAKE_GENERATOR_INSTANCE"_s, "CMAKE_GENERATOR_PLATFORM"_s,
+         "CMAKE_GENERATOR_TOOLSET"_s, "CMAKE_TRY_COMPILE_CONFIGURATION"_s }) {
+    append(mf.GetSafeDefinition(std::string(var)));
+  }
+
+  // The platform information files describe the toolchain.  They do not
+  // exist until the languages have been enabled and their compilers
+  // tested, so checks made while doing so are not cached.
+  if (!appendFile(cmStrCat(*platformInfoDir, "/CMakeSystem.cmake"))) {
+    return std::string();
+  }
+  for (std::string const& lang : mf.GetState()->GetEnabledLanguages()) {
+    if (lang == "NONE") {
+      continue;
+    }
+    if (!appendFile(
+          cmStrCat(*platformInfoDir, "/CMake", lang, "Compiler.cmake"))) {
+      return std::string();
+    }
+    // A compiler may be replaced without changing its reported version.
+    std::string const& compiler =
+      mf.GetSafeDefinition(cmStrCat("CMAKE_", lang, "_COMPILER"));
+    if (cmSystemTools::FileExists(compiler, true)) {
+      append(std::to_string(cmSystemTools::FileLength(compiler)));
+      append(std::to_string(cmSystemTools::ModifiedTime(compiler)));
+    }
+  }
+
+  std::vector<std::string> files;
+  ListFiles(binaryDirectory, std::string(), files);
+  std::sort(files.begin(), files.end());
+  for (std::string const& file : files) {
+    std::string content;
+    if (!ReadFile(cmStrCat(binaryDirectory, '/', file), content)) {
+      return std::string();
+    }
+    append(MakePlaceholders(file, binaryDirectory, targetName));
+    append(MakePlaceholders(std::move(content), binaryDirectory, targetName));
+  }
+
+  for (std::string const& arg : keyArgs) {
+    append(MakePlaceholders(arg, binaryDirectory, targetName));
+  }
+
+  std::string const hash = hasher.FinalizeHex();
+  return cmStrCat(cacheDir, '/', cm::string_view(hash).substr(0, 2), '/',
+                  hash, ".json");
+}
+
+cm::optional<cmTryCompileCache::Entry> cmTryCompileCache::Load(
+  std::string const& file, std::string const& binaryDirectory,
+  std::string const& targetName)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return cm::nullopt;
+  }
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  if (!Json::parseFromStream(builder, fin, &root, &errors) ||
+      !root.isObject()) {
+    return cm::nullopt;
+  }
+
+  Json::Value const& compile = root["compile"];
+  if (!compile.isObject() || !compile["exitCode"].isInt() ||
+      !compile["output"].isString()) {
+    return cm::nullopt;
+  }
+  Entry entry;
+  entry.CompileExitCode = compile["exitCode"].asInt();
+  entry.CompileOutput = ReplacePlaceholders(compile["output"].asString(),
+                                            binaryDirectory, targetName);
+
+  Json::Value const& run = root["run"];
+  if (run.isObject()) {
+    auto load = [&](char const* name, cm::optional<std::string>& value) {
+      Json::Value const& v = run[name];
+      if (v.isString()) {
+        value = ReplacePlaceholders(v.asString(), binaryDirectory, targetName);
+      }
+    };
+    load("exitCode", entry.RunExitCode);
+    load("output", entry.RunOutput);
+    load("stdout", entry.RunStdOut);
+    load("stderr", entry.RunStdErr);
+  }
+  return cm::optional<Entry>(std::move(entry));
+}
+
+void cmTryCompileCache::Store(std::string const& file, Entry const& entry,
+                              std::string const& binaryDirectory,
+                              std::string const& targetName)
+{
+  if (!cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(file))) {
+    return;
+  }
+
+  Json::Value root(Json::objectValue);
+  Json::Value& compile = root["compile"] = Json::objectValue;
+  compile["exitCode"] = entry.CompileExitCode;
+  compile["output"] =
+    MakePlaceholders(entry.CompileOutput, binaryDirectory, targetName);
+  if (entry.RunExitCode) {
+    Json::Value& run = root["run"] = Json::objectValue;
+    auto store = [&](char const* name,
+                     cm::optional<std::string> const& value) {
+      if (value) {
+        run[name] = MakePlaceholders(*value, binaryDirectory, targetName);
+      }
+    };
+    store("exitCode", entry.RunExitCode);
+    store("output", entry.RunOutput);
+    store("stdout", entry.RunStdOut);
+    store("stderr", entry.RunStdErr);
+  }
+
+  // Concurrent processes may store the same entry.  Each writes its own
+  // temporary file and renames it into place.
+  cmGeneratedFileStream fout(file);
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "\t";
+  std::unique_ptr<Json::StreamWriter> const writer(
+    wbuilder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+}
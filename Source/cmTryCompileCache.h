@@ -0,0 +1,62 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+#include <cm/optional>
+
+class cmMakefile;
+
+/** \class cmTryCompileCache
+ * \brief On-disk cache of try_compile and try_run results
+ *
+ * The result of a check is stored in a file named by a hash of everything
+ * that can affect it: the files of the generated project, with its binary
+ * directory and target name replaced by placeholders, the extra inputs
+ * given by the caller, and the platform and compiler information files of
+ * the enabled languages along with the size and modification time of each
+ * compiler.  A change of toolchain therefore changes the hash, and results
+ * recorded for the old toolchain are no longer found.
+ *
+ * The cache directory may be shared by concurrent CMake processes.  Files
+ * are replaced atomically and unreadable files are treated as missing.
+ */
+class cmTryCompileCache
+{
+public:
+  struct Entry
+  {
+    int CompileExitCode = 1;
+    std::string CompileOutput;
+
+    // The results of running the executable, for try_run.
+    cm::optional<std::string> RunExitCode;
+    cm::optional<std::string> RunOutput;
+    cm::optional<std::string> RunStdOut;
+    cm::optional<std::string> RunStdErr;
+  };
+
+  /**
+   * Return the cache file for the project written to \p binaryDirectory,
+   * or an empty string if no cache directory is configured or the
+   * platform information is not yet available.
+   */
+  static std::string GetFile(cmMakefile const& mf,
+                             std::string const& binaryDirectory,
+                             std::string const& targetName,
+                             std::vector<std::string> const& keyArgs);
+
+  /** Load an entry, with placeholders replaced for the given project.  */
+  static cm::optional<Entry> Load(std::string const& file,
+                                  std::string const& binaryDirectory,
+                                  std::string const& targetName);
+
+  /** Store an entry, with paths of the given project made placeholders.  */
+  static void Store(std::string const& file, Entry const& entry,
+                    std::string const& binaryDirectory,
+                    std::string const& targetName);
+};
@@ -2,8 +2,14 @@
    file LICENSE.rst or https://cmake.org/licensing for details.  */
 #include "cmTryCompileCommand.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include <cm/optional>
+#include <cmext/string_view>
 
+#include "cmArgumentParser.h"
 #include "cmConfigureLog.h"
 #include "cmCoreTryCompile.h"
 #include "cmExecutionStatus.h"
@@ -13,24 +19,49 @@
 #include "cmState.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
+#include "cmTryCompileBatch.h"
 #include "cmValue.h"
 #include "cmake.h"
 
 namespace {
-#ifndef CMAKE_BOOTSTRAP
-void WriteTryCompileEvent(cmConfigureLog& log, cmMakefile const& mf,
-                          cmTryCompileResult const& compileResult)
+bool CollectBatch(std::vector<std::string> const& args, cmMakefile& mf)
 {
-  // Keep in sync with cmFileAPIConfigureLog's DumpEventKindNames.
-  static std::vector<unsigned int> const LogVersionsWithTryCompileV1{ 1 };
+  struct Arguments : public ArgumentParser::ParseResult
+  {
+    cm::optional<std::string> Jobs;
+  };
+  static auto const parser =
+    cmArgumentParser<Arguments>{}.Bind("JOBS"_s, &Arguments::Jobs);
+
+  std::vector<std::string> unparsedArguments;
+  Arguments arguments =
+    parser.Parse(cmMakeRange(args).advance(1), &unparsedArguments);
+  if (arguments.MaybeReportError(mf)) {
+    return true;
+  }
+  if (!unparsedArguments.empty()) {
+    mf.IssueMessage(MessageType::FATAL_ERROR,
+                    cmStrCat("COLLECT_BATCH given unknown argument \"",
+                             unparsedArguments.front(), "\"."));
+    return true;
+  }
 
-  if (log.IsAnyLogVersionEnabled(LogVersionsWithTryCompileV1)) {
-    log.BeginEvent("try_compile-v1", mf);
-    cmCoreTryCompile::WriteTryCompileEventFields(log, compileResult);
-    log.EndEvent();
+  unsigned long jobs = cmTryCompileBatch::DefaultJobs();
+  if (arguments.Jobs &&
+      (!cmStrToULong(*arguments.Jobs, &jobs) || jobs == 0)) {
+    mf.IssueMessage(MessageType::FATAL_ERROR,
+                    cmStrCat("COLLECT_BATCH given invalid JOBS value \"",
+                             *arguments.Jobs,
+                             "\".  It must be a positive integer."));
+    return true;
   }
+
+  // No more builds run at a time than the batch holds, so a value too
+  // large for the thread pool is clamped rather than rejected.
+  mf.GetTryCompileBatch().Collect(static_cast<unsigned int>(
+    std::min<unsigned long>(jobs, std::numeric_limits<unsigned int>::max())));
+  return true;
 }
-#endif
 }
 
 bool cmTryCompileCommand(std::vector<std::string> const& args,
@@ -38,6 +69,10 @@ bool cmTryCompileCommand(std::vector<std::string> const& args,
 {
   cmMakefile& mf = status.GetMakefile();
 
+  if (!args.empty() && args[0] == "COLLECT_BATCH") {
+    return CollectBatch(args, mf);
+  }
+
   if (args.size() < 3) {
     mf.IssueMessage(
       MessageType::FATAL_ERROR,
@@ -81,12 +116,26 @@ bool cmTryCompileCommand(std::vector<std::string> const& args,
     return true;
   }
 
-  cm::optional<cmTryCompileResult> compileResult =
-    tc.TryCompileCode(arguments, targetType);
+  cm::optional<cmTryCompileResult> compileResult;
+  if (arguments.Batch) {
+    // Generate the project now and build it when the batch is collected.
+    if (!tc.WriteTryCompileCode(arguments, targetType)) {
+      return true;
+    }
+    if (tc.GenerateTryCompileCode(arguments)) {
+      mf.GetTryCompileBatch().Add(std::move(tc), std::move(arguments));
+      return true;
+    }
+    // Report a project that cannot be generated as a failed build, as
+    // TryCompileCode does.
+    compileResult = tc.FinishTryCompileCode(arguments, 1, std::string());
+  } else {
+    compileResult = tc.TryCompileCode(arguments, targetType);
+  }
 #ifndef CMAKE_BOOTSTRAP
   if (compileResult && !arguments.NoLog) {
     if (cmConfigureLog* log = mf.GetCMakeInstance()->GetConfigureLog()) {
-      WriteTryCompileEvent(*log, mf, *compileResult);
+      cmCoreTryCompile::WriteTryCompileEvent(*log, mf, *compileResult);
     }
   }
 #endif
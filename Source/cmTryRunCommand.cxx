@@ -25,6 +25,10 @@
 #include "cmValue.h"
 #include "cmake.h"
 
+#ifndef CMAKE_BOOTSTRAP
+#  include "cmTryCompileCache.h"
+#endif
+
 namespace {
 struct cmTryRunResult
 {
@@ -91,6 +95,12 @@ public:
                           std::string* runOutputStdOutContents,
                           std::string* runOutputStdErrContents,
                           bool stdOutErrRequired);
+  void SetRunResult(std::string const& retStr);
+
+  bool HasCachedRun() const;
+  bool LoadCachedRun(std::string* runOutputContents,
+                     std::string* runOutputStdOutContents,
+                     std::string* runOutputStdErrContents);
 
   bool NoCache;
   std::string RunResultVariable;
@@ -161,6 +171,26 @@ bool TryRunCommandImpl::TryRunCode(std::vector<std::string> const& argv)
     }
   }
 
+#ifndef CMAKE_BOOTSTRAP
+  // Results of running the executable may be cached along with the
+  // build result if all inputs of the run are part of the key.
+  {
+    std::vector<std::string> runKey;
+    runKey.emplace_back(
+      this->Makefile->GetSafeDefinition("CMAKE_CROSSCOMPILING_EMULATOR"));
+    runKey.emplace_back(arguments.RunWorkingDirectory
+                          ? *arguments.RunWorkingDirectory
+                          : std::string());
+    runKey.emplace_back(captureRunOutput ? "1" : "0");
+    runKey.emplace_back(captureRunOutputStdOutErr ? "1" : "0");
+    if (arguments.RunArgs) {
+      runKey.insert(runKey.end(), arguments.RunArgs->begin(),
+                    arguments.RunArgs->end());
+    }
+    this->ResultCacheRunKey = std::move(runKey);
+  }
+#endif
+
   // do the try compile
   cm::optional<cmTryCompileResult> compileResult =
     this->TryCompileCode(arguments, cmStateEnums::EXECUTABLE);
@@ -171,7 +201,7 @@ bool TryRunCommandImpl::TryRunCode(std::vector<std::string> const& argv)
 
   // now try running the command if it compiled
   if (compileResult && compileResult->ExitCode == 0) {
-    if (this->OutputFile.empty()) {
+    if (this->OutputFile.empty() && !this->HasCachedRun()) {
       cmSystemTools::Error(this->FindErrorMessage);
     } else {
       std::string runArgs;
@@ -183,7 +213,12 @@ bool TryRunCommandImpl::TryRunCode(std::vector<std::string> const& argv)
       std::string runOutputContents;
       std::string runOutputStdOutContents;
       std::string runOutputStdErrContents;
-      if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING") &&
+      if (this->LoadCachedRun(
+            captureRunOutput ? &runOutputContents : nullptr,
+            captureRunOutputStdOutErr ? &runOutputStdOutContents : nullptr,
+            captureRunOutputStdOutErr ? &runOutputStdErrContents : nullptr)) {
+        // The executable was run by an earlier check with the same inputs.
+      } else if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING") &&
           !this->Makefile->IsDefinitionSet("CMAKE_CROSSCOMPILING_EMULATOR")) {
         // We only require the stdout/stderr cache entries if the project
         // actually asked for the values, not just for logging.
@@ -202,6 +237,24 @@ bool TryRunCommandImpl::TryRunCode(std::vector<std::string> const& argv)
           captureRunOutput ? &runOutputContents : nullptr,
           captureRunOutputStdOutErr ? &runOutputStdOutContents : nullptr,
           captureRunOutputStdOutErr ? &runOutputStdErrContents : nullptr);
+#ifndef CMAKE_BOOTSTRAP
+        if (!this->ResultCacheFile.empty()) {
+          cmTryCompileCache::Entry entry;
+          entry.CompileExitCode = compileResult->ExitCode;
+          entry.CompileOutput = compileResult->Output;
+          entry.RunExitCode =
+            this->Makefile->GetSafeDefinition(this->RunResultVariable);
+          if (captureRunOutput) {
+            entry.RunOutput = runOutputContents;
+          }
+          if (captureRunOutputStdOutErr) {
+            entry.RunStdOut = runOutputStdOutContents;
+            entry.RunStdErr = runOutputStdErrContents;
+          }
+          cmTryCompileCache::Store(this->ResultCacheFile, entry,
+                                   this->BinaryDirectory, this->TargetName);
+        }
+#endif
       }
 
       if (captureRunOutputStdOutErr) {
@@ -245,6 +298,15 @@ bool TryRunCommandImpl::TryRunCode(std::vector<std::string> const& argv)
   }
 
 #ifndef CMAKE_BOOTSTRAP
+  if (compileResult && compileResult->ExitCode != 0 && !this->CachedResult &&
+      !this->ResultCacheFile.empty()) {
+    cmTryCompileCache::Entry entry;
+    entry.CompileExitCode = compileResult->ExitCode;
+    entry.CompileOutput = compileResult->Output;
+    cmTryCompileCache::Store(this->ResultCacheFile, entry,
+                             this->BinaryDirectory, this->TargetName);
+  }
+
   if (compileResult && !arguments.NoLog) {
     cmMakefile const& mf = *(this->Makefile);
     if (cmConfigureLog* log = mf.GetCMakeInstance()->GetConfigureLog()) {
@@ -286,7 +348,11 @@ void TryRunCommandImpl::RunExecutable(std::string const& runArgs,
     workDir ? workDir->c_str() : nullptr, cmSystemTools::OUTPUT_NONE,
     cmDuration::zero());
   // set the run var
-  std::string retStr = worked ? std::to_string(retVal) : "FAILED_TO_RUN";
+  this->SetRunResult(worked ? std::to_string(retVal) : "FAILED_TO_RUN");
+}
+
+void TryRunCommandImpl::SetRunResult(std::string const& retStr)
+{
   if (this->NoCache) {
     this->Makefile->AddDefinition(this->RunResultVariable, retStr);
   } else {
@@ -296,6 +362,41 @@ void TryRunCommandImpl::RunExecutable(std::string const& runArgs,
   }
 }
 
+bool TryRunCommandImpl::HasCachedRun() const
+{
+#ifndef CMAKE_BOOTSTRAP
+  return this->CachedResult && this->CachedResult->RunExitCode;
+#else
+  return false;
+#endif
+}
+
+bool TryRunCommandImpl::LoadCachedRun(std::string* out, std::string* stdOut,
+                                      std::string* stdErr)
+{
+  if (!this->HasCachedRun()) {
+    return false;
+  }
+#ifndef CMAKE_BOOTSTRAP
+  cmTryCompileCache::Entry const& entry = *this->CachedResult;
+  if (out) {
+    *out = entry.RunOutput.value_or(std::string());
+  }
+  if (stdOut) {
+    *stdOut = entry.RunStdOut.value_or(std::string());
+  }
+  if (stdErr) {
+    *stdErr = entry.RunStdErr.value_or(std::string());
+  }
+  this->SetRunResult(*entry.RunExitCode);
+#else
+  static_cast<void>(out);
+  static_cast<void>(stdOut);
+  static_cast<void>(stdErr);
+#endif
+  return true;
+}
+
 /* This is only used when cross compiling. Instead of running the
  executable, two cache variables are created which will hold the results
  the executable would have produced.
@@ -6,6 +6,7 @@
 #include "cmMakefile.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
 
 // cmUnsetCommand
 bool cmUnsetCommand(std::vector<std::string> const& args,
@@ -24,6 +25,8 @@ bool cmUnsetCommand(std::vector<std::string> const& args,
     auto const& envVarName = variable.substr(4, variable.size() - 5);
 
 #ifndef CMAKE_BOOTSTRAP
+    status.GetMakefile().GetCMakeInstance()->RecordEnvironmentVariable(
+      envVarName);
     cmSystemTools::UnsetEnv(envVarName.c_str());
 #endif
     return true;
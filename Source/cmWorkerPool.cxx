@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <deque>
@@ -17,6 +18,8 @@
 
 #include <sys/types.h>
 
+#include "cmsys/Process.h"
+
 #include "cmRange.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -152,6 +155,7 @@ public:
     std::vector<std::string> Command;
     cmWorkerPool::ProcessResultT* Result = nullptr;
     bool MergedOutput = false;
+    cmDuration Timeout = cmDuration::zero();
   };
 
   // -- Const accessors
@@ -163,12 +167,14 @@ public:
   // -- Runtime
   void setup(cmWorkerPool::ProcessResultT* result, bool mergedOutput,
              std::vector<std::string> command,
-             std::string const& workingDirectory = std::string());
+             std::string const& workingDirectory = std::string(),
+             cmDuration timeout = cmDuration::zero());
   bool start(uv_loop_t* uv_loop, std::function<void()> finishedCallback);
 
 private:
   // -- Libuv callbacks
   static void UVExit(uv_process_t* handle, int64_t exitStatus, int termSignal);
+  static void UVTimeout(uv_timer_t* handle);
   void UVPipeOutData(cmUVPipeBuffer::DataRange data) const;
   void UVPipeOutEnd(ssize_t error);
   void UVPipeErrData(cmUVPipeBuffer::DataRange data) const;
@@ -185,6 +191,7 @@ private:
   std::array<uv_stdio_container_t, 3> UVOptionsStdIO_;
   uv_process_options_t UVOptions_;
   cm::uv_process_ptr UVProcess_;
+  cm::uv_timer_ptr UVTimer_;
   cmUVPipeBuffer UVPipeOut_;
   cmUVPipeBuffer UVPipeErr_;
 };
@@ -192,13 +199,15 @@ private:
 void cmUVReadOnlyProcess::setup(cmWorkerPool::ProcessResultT* result,
                                 bool mergedOutput,
                                 std::vector<std::string> command,
-                                std::string const& workingDirectory)
+                                std::string const& workingDirectory,
+                                cmDuration timeout)
 {
   cmSystemTools::MaybePrependCmdExe(command);
   this->Setup_.WorkingDirectory = workingDirectory;
   this->Setup_.Command = std::move(command);
   this->Setup_.Result = result;
   this->Setup_.MergedOutput = mergedOutput;
+  this->Setup_.Timeout = timeout;
 }
 
 bool cmUVReadOnlyProcess::start(uv_loop_t* uv_loop,
@@ -293,11 +302,27 @@ bool cmUVReadOnlyProcess::start(uv_loop_t* uv_loop,
     }
   }
 
+  // -- Start the timeout timer
+  if (!this->Result()->error() &&
+      this->Setup().Timeout > cmDuration::zero()) {
+    auto const timeout =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        this->Setup().Timeout)
+        .count();
+    if (this->UVTimer_.init(*uv_loop, this) != 0 ||
+        this->UVTimer_.start(&cmUVReadOnlyProcess::UVTimeout,
+                             static_cast<uint64_t>(timeout), 0,
+                             cm::uv_update_time::yes) != 0) {
+      this->Result()->ErrorMessage = "libuv timer initialization failed";
+    }
+  }
+
   if (!this->Result()->error()) {
     this->IsStarted_ = true;
     this->FinishedCallback_ = std::move(finishedCallback);
   } else {
     // Clear libuv handles and finish
+    this->UVTimer_.reset();
     this->UVProcess_.reset();
     this->UVPipeOut_.reset();
     this->UVPipeErr_.reset();
@@ -325,13 +350,24 @@ void cmUVReadOnlyProcess::UVExit(uv_process_t* handle, int64_t exitStatus,
       }
     }
 
-    // Reset process handle
+    // Reset process and timer handles
     proc.UVProcess_.reset();
+    proc.UVTimer_.reset();
     // Try finish
     proc.UVTryFinish();
   }
 }
 
+void cmUVReadOnlyProcess::UVTimeout(uv_timer_t* handle)
+{
+  auto& proc = *reinterpret_cast<cmUVReadOnlyProcess*>(handle->data);
+  if (proc.UVProcess_.get()) {
+    // Kill the process and let the exit callback finish
+    proc.Result()->ErrorMessage = "Process timed out";
+    cmsysProcess_KillPID(static_cast<unsigned long>(proc.UVProcess_->pid));
+  }
+}
+
 void cmUVReadOnlyProcess::UVPipeOutData(cmUVPipeBuffer::DataRange data) const
 {
   this->Result()->StdOut.append(data.begin(), data.end());
@@ -401,7 +437,7 @@ public:
    */
   bool RunProcess(cmWorkerPool::ProcessResultT& result,
                   std::vector<std::string> command,
-                  std::string const& workingDirectory);
+                  std::string const& workingDirectory, cmDuration timeout);
 
 private:
   // -- Libuv callbacks
@@ -434,7 +470,8 @@ cmWorkerPoolWorker::~cmWorkerPoolWorker()
 
 bool cmWorkerPoolWorker::RunProcess(cmWorkerPool::ProcessResultT& result,
                                     std::vector<std::string> command,
-                                    std::string const& workingDirectory)
+                                    std::string const& workingDirectory,
+                                    cmDuration timeout)
 {
   if (command.empty()) {
     return false;
@@ -444,7 +481,7 @@ bool cmWorkerPoolWorker::RunProcess(cmWorkerPool::ProcessResultT& result,
     std::lock_guard<std::mutex> lock(this->Proc_.Mutex);
     this->Proc_.ROP = cm::make_unique<cmUVReadOnlyProcess>();
     this->Proc_.ROP->setup(&result, true, std::move(command),
-                           workingDirectory);
+                           workingDirectory, timeout);
   }
   // Send asynchronous process start request to libuv loop
   this->Proc_.Request.send();
@@ -737,11 +774,13 @@ cmWorkerPool::JobT::~JobT() = default;
 
 bool cmWorkerPool::JobT::RunProcess(ProcessResultT& result,
                                     std::vector<std::string> command,
-                                    std::string const& workingDirectory)
+                                    std::string const& workingDirectory,
+                                    cmDuration timeout)
 {
   // Get worker by index
   auto* worker = this->Pool_->Int_->Workers.at(this->WorkerIndex_).get();
-  return worker->RunProcess(result, std::move(command), workingDirectory);
+  return worker->RunProcess(result, std::move(command), workingDirectory,
+                            timeout);
 }
 
 cmWorkerPool::cmWorkerPool()
@@ -11,6 +11,8 @@
 
 #include <cm/memory>
 
+#include "cmDuration.h"
+
 // -- Types
 class cmWorkerPoolInternal;
 
@@ -100,10 +102,12 @@ public:
 
     /**
      * Run an external read only process.
+     * The process is killed if it runs longer than a non-zero \a timeout.
      * Use only during JobT::Process() call!
      */
     bool RunProcess(ProcessResultT& result, std::vector<std::string> command,
-                    std::string const& workingDirectory);
+                    std::string const& workingDirectory,
+                    cmDuration timeout = cmDuration::zero());
 
   private:
     //! Needs access to Work()
@@ -40,6 +40,7 @@
 #include "cmCMakePresetsGraph.h"
 #include "cmCommandLineArgument.h"
 #include "cmCommands.h"
+#include "cmCryptoHash.h"
 #ifdef CMake_ENABLE_DEBUGGER
 #  include "cmDebuggerAdapter.h"
 #  ifdef _WIN32
@@ -51,8 +52,10 @@
 #include "cmDocumentation.h"
 #include "cmDocumentationEntry.h"
 #include "cmDuration.h"
+#include "cmExperimental.h"
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmFileTimeCache.h"
+#include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobCacheEntry.h" // IWYU pragma: keep
 #include "cmGlobalGenerator.h"
@@ -62,6 +65,7 @@
 #include "cmMakefile.h"
 #if !defined(CMAKE_BOOTSTRAP)
 #  include "cmMakefileProfilingData.h"
+#  include "cmMakefileUpToDateIndex.h"
 #endif
 #include "cmJSONState.h"
 #include "cmList.h"
@@ -315,6 +319,9 @@ cmDocumentationEntry cmake::CMAKE_STANDARD_OPTIONS_TABLE[15] = {
 cmake::cmake(cmState::Role role, cmState::TryCompile isTryCompile)
   : CMakeWorkingDirectory(cmSystemTools::GetLogicalWorkingDirectory())
   , FileTimeCache(cm::make_unique<cmFileTimeCache>())
+  , ListFileCache(cm::make_unique<cmListFileCache>())
+  , GeneratorExpressionInterner(
+      cm::make_unique<cmGeneratorExpressionInterner>(*this))
 #ifndef CMAKE_BOOTSTRAP
   , VariableWatch(cm::make_unique<cmVariableWatch>())
 #endif
@@ -380,7 +387,12 @@ cmake::cmake(cmState::Role role, cmState::TryCompile isTryCompile)
   }
 }
 
-cmake::~cmake() = default;
+cmake::~cmake()
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  this->StopConfigureSnapshotRecording();
+#endif
+}
 
 #if !defined(CMAKE_BOOTSTRAP)
 Json::Value cmake::ReportVersionJson() const
@@ -2753,6 +2765,13 @@ int cmake::ActualConfigure()
   }
 #endif
 
+  // Reuse list files parsed by a previous run if it persisted them.
+  std::string const listFileCachePath =
+    cmStrCat(this->GetHomeOutputDirectory(), "/CMakeFiles/ListFileCache.bin");
+  if (!this->GetIsInTryCompile()) {
+    this->ListFileCache->Load(listFileCachePath);
+  }
+
   // actually do the configure
   auto startTime = std::chrono::steady_clock::now();
 #if !defined(CMAKE_BOOTSTRAP)
@@ -2841,6 +2860,18 @@ int cmake::ActualConfigure()
   }
 #endif
 
+  if (!this->GetIsInTryCompile()) {
+    if (mf->IsOn("CMAKE_PERSIST_LISTFILE_CACHE")) {
+      if (!this->ListFileCache->Save(listFileCachePath)) {
+        this->IssueMessage(
+          MessageType::WARNING,
+          cmStrCat("Unable to write list file cache:\n  ", listFileCachePath));
+      }
+    } else if (cmSystemTools::FileExists(listFileCachePath)) {
+      cmSystemTools::RemoveFile(listFileCachePath);
+    }
+  }
+
   this->State->SaveVerificationScript(this->GetHomeOutputDirectory(),
                                       this->Messenger.get());
   this->SaveCache(this->GetHomeOutputDirectory());
@@ -3154,6 +3185,22 @@ int cmake::Run(std::vector<std::string> const& args, bool noconfigure)
     return 0;
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // Skip a build tree whose inputs did not change since it was last
+  // configured.  Regeneration requested by the build system itself is
+  // driven by file timestamps, so it always configures again.
+  if (this->CheckBuildSystemArgument.empty() &&
+      !this->RegenerateDuringBuild && this->IsConfigureSnapshotCurrent()) {
+    this->UpdateProgress("Configuring skipped: inputs are unchanged", -1);
+    this->UpdateProgress(cmStrCat("Build files have been written to: ",
+                                  this->GetHomeOutputDirectory()),
+                         -1);
+    return 0;
+  }
+  cmSystemTools::RemoveFile(this->GetConfigureSnapshotFile());
+  this->StartConfigureSnapshotRecording();
+#endif
+
 #ifdef CMake_ENABLE_DEBUGGER
   if (!this->StartDebuggerIfEnabled()) {
     return -1;
@@ -3185,6 +3232,9 @@ int cmake::Run(std::vector<std::string> const& args, bool noconfigure)
                            "Build files cannot be regenerated correctly.");
     return ret;
   }
+#if !defined(CMAKE_BOOTSTRAP)
+  this->WriteConfigureSnapshot();
+#endif
   std::string message = cmStrCat("Build files have been written to: ",
                                  this->GetHomeOutputDirectory());
   this->UpdateProgress(message, -1);
@@ -3258,6 +3308,227 @@ int cmake::Generate()
   return 0;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+bool ConfigureSnapshotEnabled(cmState* state)
+{
+  // The feature must be enabled by a cache entry so that it is known
+  // before any list file runs.
+  auto const& feature = cmExperimental::DataForFeature(
+    cmExperimental::Feature::ConfigureSnapshot);
+  cmValue value = state->GetCacheEntryValue(feature.Variable);
+  return value && *value == feature.Uuid;
+}
+
+std::string HashEnvironmentValue(cm::optional<std::string> const& value)
+{
+  // Distinguish an unset variable from an empty one.
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  return hasher.HashString(value ? cmStrCat('=', *value) : std::string());
+}
+}
+
+void cmake::StartConfigureSnapshotRecording()
+{
+  this->StopConfigureSnapshotRecording();
+  if (!ConfigureSnapshotEnabled(this->State.get())) {
+    return;
+  }
+  this->RecordConfigureSnapshot = true;
+  this->ConfigureSnapshotOutputs.clear();
+  this->ConfigureSnapshotEnvironment.clear();
+  cmGeneratedFileStream::SetCloseCallback([this](std::string const& file) {
+    this->ConfigureSnapshotOutputs.insert(file);
+  });
+}
+
+void cmake::StopConfigureSnapshotRecording()
+{
+  if (this->RecordConfigureSnapshot) {
+    cmGeneratedFileStream::SetCloseCallback(nullptr);
+    this->RecordConfigureSnapshot = false;
+  }
+}
+
+std::string cmake::GetConfigureSnapshotFile() const
+{
+  return cmStrCat(this->GetHomeOutputDirectory(),
+                  "/CMakeFiles/ConfigureSnapshot.txt");
+}
+
+std::string cmake::ComputeConfigureSnapshotKey() const
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view value) {
+    hasher.Append(value);
+    hasher.Append(cm::string_view("", 1));
+  };
+
+  append(CMake_VERSION);
+  std::string const& cmakeCommand = cmSystemTools::GetCMakeCommand();
+  append(cmakeCommand);
+  append(std::to_string(cmSystemTools::ModifiedTime(cmakeCommand)));
+
+  std::vector<std::string> keys = this->State->GetCacheEntryKeys();
+  std::sort(keys.begin(), keys.end());
+  for (std::string const& key : keys) {
+    append(key);
+    append(cmState::CacheEntryTypeToString(
+      this->State->GetCacheEntryType(key)));
+    append(*this->State->GetCacheEntryValue(key));
+    for (std::string const& prop :
+         this->State->GetCacheEntryPropertyList(key)) {
+      append(prop);
+      append(*this->State->GetCacheEntryProperty(key, prop));
+    }
+  }
+  return hasher.FinalizeHex();
+}
+
+bool cmake::IsConfigureSnapshotCurrent() const
+{
+  if (!ConfigureSnapshotEnabled(this->State.get())) {
+    return false;
+  }
+
+  // Only plain invocations qualify.  Cache entries given by -D are covered
+  // by the snapshot key, but other options may ask for different output.
+  if (this->cmdArgs.empty()) {
+    return false;
+  }
+  for (auto ai = this->cmdArgs.begin() + 1; ai != this->cmdArgs.end(); ++ai) {
+    if (*ai == "-S" || *ai == "-B" || *ai == "-D") {
+      if (++ai == this->cmdArgs.end()) {
+        return false;
+      }
+    } else if (!cmHasLiteralPrefix(*ai, "-S") &&
+               !cmHasLiteralPrefix(*ai, "-B") &&
+               !cmHasLiteralPrefix(*ai, "-D") && cmHasPrefix(*ai, '-')) {
+      return false;
+    }
+  }
+
+  // File API and instrumentation queries may ask for replies that the
+  // last run did not write.
+  if (cmSystemTools::FileExists(
+        cmStrCat(this->GetHomeOutputDirectory(), "/.cmake"))) {
+    return false;
+  }
+  if (cm::optional<std::string> configDir =
+        cmSystemTools::GetCMakeConfigDirectory()) {
+    if (cmSystemTools::FileExists(cmStrCat(*configDir, "/api/v1/query")) ||
+        cmSystemTools::FileExists(
+          cmStrCat(*configDir, "/instrumentation/v1/query"))) {
+      return false;
+    }
+  }
+
+  cmsys::ifstream fin(this->GetConfigureSnapshotFile().c_str());
+  std::string line;
+  if (!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+      !cmSystemTools::GetLineFromStream(fin, line) ||
+      line != this->ComputeConfigureSnapshotKey()) {
+    return false;
+  }
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    // Each input is recorded as "I <sha256> <path>".
+    if (cmHasLiteralPrefix(line, "I ") && line.size() > 67 &&
+        line[66] == ' ') {
+      if (hasher.HashFile(line.substr(67)) != line.substr(2, 64)) {
+        return false;
+      }
+    } else if (cmHasLiteralPrefix(line, "E ") && line.size() > 67 &&
+               line[66] == ' ') {
+      // Each environment variable is recorded as "E <sha256> <name>".
+      if (HashEnvironmentValue(cmSystemTools::GetEnvVar(line.substr(67))) !=
+          line.substr(2, 64)) {
+        return false;
+      }
+    } else if (cmHasLiteralPrefix(line, "O ")) {
+      if (!cmSystemTools::FileExists(line.substr(2))) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+void cmake::RecordEnvironmentVariable(std::string const& name)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  // Keep the first value seen, from before the project changed it.
+  if (this->RecordConfigureSnapshot &&
+      this->ConfigureSnapshotEnvironment.find(name) ==
+        this->ConfigureSnapshotEnvironment.end()) {
+    this->ConfigureSnapshotEnvironment.emplace(
+      name, cmSystemTools::GetEnvVar(name));
+  }
+#else
+  static_cast<void>(name);
+#endif
+}
+
+#if !defined(CMAKE_BOOTSTRAP)
+void cmake::WriteConfigureSnapshot()
+{
+  bool const recorded = this->RecordConfigureSnapshot;
+  this->StopConfigureSnapshotRecording();
+  if (!this->GlobalGenerator || !recorded) {
+    return;
+  }
+  cmMakefile const& mf = *this->GlobalGenerator->GetMakefiles()[0];
+  if (!cmExperimental::HasSupportEnabled(
+        mf, cmExperimental::Feature::ConfigureSnapshot)) {
+    return;
+  }
+
+  // Globs with CONFIGURE_DEPENDS must be verified on every run.
+  if (this->State->DoWriteGlobVerifyTarget() ||
+      this->Instrumentation->HasQuery()) {
+    return;
+  }
+
+  // The outputs are the files written by configure_file and every file
+  // generated by this run that still exists.  Temporary files, such as
+  // those of try_compile projects, are removed by the time it ends.
+  std::set<std::string> inputs;
+  std::set<std::string> outputs;
+  for (auto const& makefile : this->GlobalGenerator->GetMakefiles()) {
+    inputs.insert(makefile->GetListFiles().begin(),
+                  makefile->GetListFiles().end());
+    outputs.insert(makefile->GetOutputFiles().begin(),
+                   makefile->GetOutputFiles().end());
+  }
+  for (std::string const& output : this->ConfigureSnapshotOutputs) {
+    if (cmSystemTools::FileExists(output, true)) {
+      outputs.insert(output);
+    }
+  }
+
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  cmGeneratedFileStream fout(this->GetConfigureSnapshotFile());
+  fout << "# Inputs of the last configuration of this build tree.\n"
+       << this->ComputeConfigureSnapshotKey() << '\n';
+  for (std::string const& input : inputs) {
+    fout << "I " << hasher.HashFile(input) << ' ' << input << '\n';
+  }
+  for (auto const& env : this->ConfigureSnapshotEnvironment) {
+    fout << "E " << HashEnvironmentValue(env.second) << ' ' << env.first
+         << '\n';
+  }
+  for (std::string const& output : outputs) {
+    fout << "O " << output << '\n';
+  }
+  this->ConfigureSnapshotOutputs.clear();
+  this->ConfigureSnapshotEnvironment.clear();
+}
+#endif
+
 void cmake::AddCacheEntry(std::string const& key, cmValue value,
                           cmValue helpString, int type)
 {
@@ -4132,13 +4403,43 @@ int cmake::Build(cmBuildArgs buildArgs, std::vector<std::string> targets,
 #endif
 
   this->GlobalGenerator->PrintBuildCommandAdvice(std::cerr, buildArgs.jobs);
+
+  // The Makefile generators may index the rules of the "all" target so
+  // that a build with nothing to do does not run make at all.
+  bool upToDate = false;
+#if !defined(CMAKE_BOOTSTRAP)
+  if ((targets.empty() ||
+       (targets.size() == 1 &&
+        targets.front() == this->GlobalGenerator->GetAllTargetName())) &&
+      !buildOptions.Clean && nativeOptions.empty() &&
+      cmMakefileUpToDateIndex::HasIndex(cachePath)) {
+    // The rerun check file names outputs relative to the build tree.
+    cmWorkingDirectory workdir(cachePath);
+    this->CheckBuildSystemArgument = "CMakeFiles/Makefile.cmake";
+    std::string reason;
+    if (workdir.Failed() || this->CheckBuildSystem() != 0) {
+      reason = "The build system must be generated again.";
+    } else if (cmMakefileUpToDateIndex::IsUpToDate(
+                 cachePath, *this->FileTimeCache, reason)) {
+      upToDate = true;
+      reason = "The build is up to date.";
+    }
+    if (buildArgs.verbose) {
+      std::cout << reason << std::endl;
+    }
+  }
+#endif
+
   std::stringstream ostr;
   // `cmGlobalGenerator::Build` logs metadata about what directory and commands
   // are being executed to the `output` parameter. If CMake is verbose, print
   // this out.
   std::ostream& verbose_ostr = buildArgs.verbose ? std::cout : ostr;
   auto doBuild = [this, targets, &verbose_ostr, buildOptions, buildArgs,
-                  nativeOptions]() -> int {
+                  nativeOptions, upToDate]() -> int {
+    if (upToDate) {
+      return 0;
+    }
     return this->GlobalGenerator->Build(
       buildArgs, targets, verbose_ostr, "", buildArgs.config, buildOptions,
       buildArgs.timeout, cmSystemTools::OUTPUT_PASSTHROUGH, nativeOptions);
@@ -51,6 +51,7 @@ class cmExternalMakefileProjectGeneratorFactory;
 class cmFileAPI;
 class cmInstrumentation;
 class cmFileTimeCache;
+class cmGeneratorExpressionInterner;
 class cmGlobalGenerator;
 class cmMakefile;
 class cmMessenger;
@@ -471,6 +472,25 @@ public:
    */
   cmFileTimeCache* GetFileTimeCache() { return this->FileTimeCache.get(); }
 
+  /**
+   * Get the cache of parsed list files shared by all directories
+   */
+  cmListFileCache* GetListFileCache() { return this->ListFileCache.get(); }
+
+  /**
+   * Note that the project read, or is about to set, an environment
+   * variable, so that its value is part of the configure snapshot.
+   */
+  void RecordEnvironmentVariable(std::string const& name);
+
+  /**
+   * Get the table of parsed generator expressions
+   */
+  cmGeneratorExpressionInterner* GetGeneratorExpressionInterner()
+  {
+    return this->GeneratorExpressionInterner.get();
+  }
+
   bool WasLogLevelSetViaCLI() const { return this->LogLevelWasSetViaCLI; }
 
   //! Get the selected log level for `message()` commands during the cmake run.
@@ -768,6 +788,17 @@ protected:
 
   void GenerateGraphViz(std::string const& fileName) const;
 
+#if !defined(CMAKE_BOOTSTRAP)
+  //! Snapshot of the inputs of a successful configuration, used to skip
+  /// configuring a build tree again when none of them changed.
+  std::string GetConfigureSnapshotFile() const;
+  std::string ComputeConfigureSnapshotKey() const;
+  bool IsConfigureSnapshotCurrent() const;
+  void StartConfigureSnapshotRecording();
+  void StopConfigureSnapshotRecording();
+  void WriteConfigureSnapshot();
+#endif
+
 private:
   std::vector<std::string> cmdArgs;
   std::string CMakeWorkingDirectory;
@@ -785,6 +816,13 @@ private:
   cmake* TraceRedirect = nullptr;
 #ifndef CMAKE_BOOTSTRAP
   std::unique_ptr<cmConfigureLog> ConfigureLog;
+  // Files generated and environment variables read by the current run,
+  // with their values before the project changed them, if it records a
+  // configure snapshot.
+  bool RecordConfigureSnapshot = false;
+  std::set<std::string> ConfigureSnapshotOutputs;
+  std::map<std::string, cm::optional<std::string>>
+    ConfigureSnapshotEnvironment;
 #endif
   bool CheckSystemVars = false;
   bool IgnoreCompileWarningAsError = false;
@@ -811,6 +849,8 @@ private:
   bool InInitialCache = false;
   std::string CMakeListName;
   std::unique_ptr<cmFileTimeCache> FileTimeCache;
+  std::unique_ptr<cmListFileCache> ListFileCache;
+  std::unique_ptr<cmGeneratorExpressionInterner> GeneratorExpressionInterner;
   std::string GraphVizFile;
   InstalledFilesMap InstalledFiles;
 #ifndef CMAKE_BOOTSTRAP
@@ -48,6 +48,9 @@ cmDocumentationEntry const cmDocumentationOptions[] = {
   { "--test-output-truncation <mode>",
     "Truncate 'tail' (default), 'middle' or 'head' of test output once "
     "maximum output size is reached" },
+  { "--test-output-spool",
+    "Spool test output to compressed files, keeping only the part "
+    "shown in memory" },
   { "-F", "Enable failover." },
   { "-j [<level>], --parallel [<level>]",
     "Run tests in parallel, "
@@ -111,6 +114,9 @@ cmDocumentationEntry const cmDocumentationOptions[] = {
   { "--tests-from-file <file>", "Run the tests listed in the given file" },
   { "--exclude-from-file <file>",
     "Run tests except those listed in the given file" },
+  { "--affected-by <file>",
+    "Run the tests affected by changes to the files listed in the given "
+    "file" },
   { "--repeat until-fail:<n>, --repeat-until-fail <n>",
     "Require each test to run <n> times without failing in order to pass" },
   { "--repeat until-pass:<n>",
@@ -150,6 +156,14 @@ cmDocumentationEntry const cmDocumentationOptions[] = {
   { "--http-header <header>", "Append HTTP header when submitting" },
   { "--schedule-random", "Use a random order for scheduling tests" },
   { "--schedule-random-seed", "Override seed for random order of tests" },
+  { "--schedule-critical-path",
+    "Start tests on the longest dependency chains first" },
+  { "--test-history",
+    "Record test durations and schedule on their 90th percentile" },
+  { "--shard-count <n>", "Split the tests into <n> shards of equal cost" },
+  { "--shard-index <k>", "Run only the tests of shard <k>, from 0" },
+  { "--test-memory-limit <size>",
+    "Limit the expected peak memory of running tests" },
   { "--submit-index",
     "Submit individual dashboard tests with specific index" },
   { "--timeout <seconds>", "Set the default test timeout." },
@@ -0,0 +1,133 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCTestCoverageHandler.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+#include "testCommon.h"
+
+namespace {
+
+using CoverageMap = cmCTestCoverageHandlerContainer::TotalCoverageMap;
+using CoverageVector =
+  cmCTestCoverageHandlerContainer::SingleFileCoverageVector;
+
+std::string dataDir;
+
+// The output of gcov 12 --json-format --stdout for two objects, a.o and
+// b.o, run in /work/build.  Both include an inline function from h.h, a.o
+// has a line that was not executed, and b.c defines two functions on one
+// line, so that line is listed twice.
+std::string readRecordedOutput()
+{
+  cmsys::ifstream file(cmStrCat(dataDir, "/gcov-12.json").c_str());
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+std::string sourcePath(char const* name)
+{
+  return cmSystemTools::CollapseFullPath(name, "/work/build");
+}
+
+bool checkCounts(CoverageMap const& sources, char const* name,
+                 CoverageVector const& expected)
+{
+  auto const it = sources.find(sourcePath(name));
+  if (it == sources.end()) {
+    std::cout << "No counts for " << name << '\n';
+    return false;
+  }
+  if (it->second != expected) {
+    std::cout << "Counts of " << name << ":\n  Actual:";
+    for (int count : it->second) {
+      std::cout << ' ' << count;
+    }
+    std::cout << "\nExpected:";
+    for (int count : expected) {
+      std::cout << ' ' << count;
+    }
+    std::cout << '\n';
+    return false;
+  }
+  return true;
+}
+
+bool testMultipleFiles()
+{
+  CoverageMap sources;
+  ASSERT_TRUE(
+    cmCTestCoverageHandler::ReadGCovJson(readRecordedOutput(), sources));
+  ASSERT_EQUAL(sources.size(), 3u);
+
+  // The counts of h.h from both objects are added.
+  ASSERT_TRUE(checkCounts(sources, "h.h", { 1, -1, 1 }));
+  return true;
+}
+
+bool testDuplicateLines()
+{
+  CoverageMap sources;
+  ASSERT_TRUE(
+    cmCTestCoverageHandler::ReadGCovJson(readRecordedOutput(), sources));
+
+  // Line 2 of b.c is listed once for each of its functions.
+  ASSERT_TRUE(checkCounts(sources, "b.c", { -1, 1 }));
+  return true;
+}
+
+bool testUnexecutedLines()
+{
+  CoverageMap sources;
+  ASSERT_TRUE(
+    cmCTestCoverageHandler::ReadGCovJson(readRecordedOutput(), sources));
+
+  // Line 7 of a.c was not executed, and lines without code are unused.
+  ASSERT_TRUE(checkCounts(sources, "a.c", { -1, -1, 1, -1, -1, 1, 0, -1, 1 }));
+  return true;
+}
+
+bool testExistingCounts()
+{
+  CoverageMap sources;
+  sources[sourcePath("a.c")] = { 2, -1, 3 };
+  ASSERT_TRUE(
+    cmCTestCoverageHandler::ReadGCovJson(readRecordedOutput(), sources));
+  ASSERT_TRUE(checkCounts(sources, "a.c", { 2, -1, 4, -1, -1, 1, 0, -1, 1 }));
+  return true;
+}
+
+bool testMalformedUnit()
+{
+  std::string output = readRecordedOutput();
+  std::string::size_type const split = output.find('\n') + 1;
+  output.insert(split, "{\"files\": [\n");
+
+  // The malformed unit is reported, and the others are still read.
+  CoverageMap sources;
+  ASSERT_TRUE(!cmCTestCoverageHandler::ReadGCovJson(output, sources));
+  ASSERT_TRUE(checkCounts(sources, "a.c", { -1, -1, 1, -1, -1, 1, 0, -1, 1 }));
+  ASSERT_TRUE(checkCounts(sources, "b.c", { -1, 1 }));
+  return true;
+}
+}
+
+int testCTestCoverageGCovJson(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cout << "Invalid arguments.\n";
+    return -1;
+  }
+  dataDir = cmStrCat(argv[1], "/testCTestCoverageGCovJson_data");
+
+  return runTests({ testMultipleFiles, testDuplicateLines, testUnexecutedLines,
+                    testExistingCounts, testMalformedUnit });
+}
@@ -0,0 +1,129 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+
+#include <string>
+#include <vector>
+
+#include <cm/optional>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCTestTestHistory.h"
+#include "cmSystemTools.h"
+
+#include "testCommon.h"
+
+namespace {
+
+std::string const historyFile = "testCTestTestHistory.log";
+
+std::vector<cmCTestTestHistory::Run> makeRuns(std::string const& name,
+                                              std::string const& config,
+                                              int first, int last)
+{
+  std::vector<cmCTestTestHistory::Run> runs;
+  for (int i = first; i <= last; ++i) {
+    cmCTestTestHistory::Run run;
+    run.Name = name;
+    run.Config = config;
+    run.StartTime = 1000 + i;
+    run.Duration = i;
+    // Every fourth run fails after a long time.
+    run.Passed = i % 4 != 0;
+    if (!run.Passed) {
+      run.Duration = 1000;
+    }
+    runs.emplace_back(run);
+  }
+  return runs;
+}
+
+bool testStatistics()
+{
+  cmSystemTools::RemoveFile(historyFile);
+  cmCTestTestHistory history(historyFile);
+  history.Load();
+  ASSERT_TRUE(!history.GetStatistics("a", "Debug"));
+
+  ASSERT_TRUE(history.Record(makeRuns("a", "Debug", 1, 10)));
+  cm::optional<cmCTestTestHistory::Statistics> stats =
+    history.GetStatistics("a", "Debug");
+  ASSERT_TRUE(stats);
+  ASSERT_EQUAL(stats->Runs, 10u);
+  // Passed durations are 1 2 3 5 6 7 9 10.
+  ASSERT_EQUAL(stats->Median, 5.0);
+  ASSERT_EQUAL(stats->Percentile90, 10.0);
+  ASSERT_EQUAL(stats->Maximum, 10.0);
+  ASSERT_EQUAL(stats->FailureRate, 0.2);
+  ASSERT_EQUAL(stats->LastRun, 1010.0);
+
+  // Configurations are separate.
+  ASSERT_TRUE(!history.GetStatistics("a", "Release"));
+  return true;
+}
+
+bool testReload()
+{
+  cmSystemTools::RemoveFile(historyFile);
+  {
+    cmCTestTestHistory history(historyFile);
+    history.Load();
+    ASSERT_TRUE(history.Record(makeRuns("a", "", 1, 5)));
+    ASSERT_TRUE(history.Record(makeRuns("b", "", 1, 3)));
+  }
+
+  // Malformed lines are ignored.
+  {
+    cmsys::ofstream fout(historyFile.c_str(), std::ios::app);
+    fout << "not json\n{\"name\":\"a\"}\n";
+  }
+
+  cmCTestTestHistory history(historyFile);
+  history.Load();
+  cm::optional<cmCTestTestHistory::Statistics> stats =
+    history.GetStatistics("a", "");
+  ASSERT_TRUE(stats);
+  ASSERT_EQUAL(stats->Runs, 5u);
+  ASSERT_EQUAL(stats->Maximum, 5.0);
+  stats = history.GetStatistics("b", "");
+  ASSERT_TRUE(stats);
+  ASSERT_EQUAL(stats->Runs, 3u);
+  return true;
+}
+
+bool testWindow()
+{
+  cmSystemTools::RemoveFile(historyFile);
+  int const total = static_cast<int>(cmCTestTestHistory::Window) * 3;
+  {
+    cmCTestTestHistory history(historyFile);
+    history.Load();
+    for (int i = 1; i <= total; ++i) {
+      ASSERT_TRUE(history.Record(makeRuns("a", "", i, i)));
+    }
+  }
+
+  cmCTestTestHistory history(historyFile);
+  history.Load();
+  cm::optional<cmCTestTestHistory::Statistics> stats =
+    history.GetStatistics("a", "");
+  ASSERT_TRUE(stats);
+  ASSERT_EQUAL(stats->Runs, cmCTestTestHistory::Window);
+  ASSERT_EQUAL(stats->LastRun, 1000.0 + total);
+
+  // The file is compacted rather than growing without bound.
+  unsigned long lines = 0;
+  cmsys::ifstream fin(historyFile.c_str());
+  std::string line;
+  while (std::getline(fin, line)) {
+    ++lines;
+  }
+  ASSERT_TRUE(lines <= 2 * cmCTestTestHistory::Window);
+  return true;
+}
+}
+
+int testCTestTestHistory(int /*unused*/, char* /*unused*/[])
+{
+  return runTests({ testStatistics, testReload, testWindow });
+}
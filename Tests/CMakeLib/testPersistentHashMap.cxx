@@ -0,0 +1,110 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file LICENSE.rst or https://cmake.org/licensing for details.  */
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "cmPersistentHashMap.h"
+
+#include "testCommon.h"
+
+namespace {
+
+// Force every key to collide so the hash is exhausted.
+struct CollidingHash
+{
+  std::size_t operator()(std::string const&) const { return 42; }
+};
+
+template <typename Map>
+std::map<std::string, int> toStdMap(Map const& map)
+{
+  std::map<std::string, int> result;
+  map.ForEach([&result](std::string const& key, int value) {
+    result.emplace(key, value);
+  });
+  return result;
+}
+
+template <typename Map>
+bool checkInsertAndErase()
+{
+  Map map;
+  std::map<std::string, int> expect;
+  for (int i = 0; i < 1000; ++i) {
+    std::string const key = std::to_string(i);
+    ASSERT_TRUE(map.Set(key, i) == i);
+    expect[key] = i;
+  }
+  ASSERT_EQUAL(map.size(), 1000u);
+  ASSERT_TRUE(toStdMap(map) == expect);
+
+  ASSERT_TRUE(map.Set("7", 70) == 70);
+  ASSERT_EQUAL(map.size(), 1000u);
+  ASSERT_EQUAL(*map.Find("7"), 70);
+  expect["7"] = 70;
+
+  for (int i = 0; i < 1000; i += 2) {
+    std::string const key = std::to_string(i);
+    ASSERT_TRUE(map.Erase(key));
+    ASSERT_TRUE(!map.Erase(key));
+    expect.erase(key);
+  }
+  ASSERT_EQUAL(map.size(), 500u);
+  ASSERT_TRUE(map.Find("0") == nullptr);
+  ASSERT_TRUE(map.Find("missing") == nullptr);
+  ASSERT_TRUE(toStdMap(map) == expect);
+
+  for (auto const& e : expect) {
+    ASSERT_TRUE(map.Erase(e.first));
+  }
+  ASSERT_TRUE(map.empty());
+  return true;
+}
+
+bool testInsertAndErase()
+{
+  return checkInsertAndErase<cmPersistentHashMap<std::string, int>>();
+}
+
+bool testCollisions()
+{
+  return checkInsertAndErase<
+    cmPersistentHashMap<std::string, int, CollidingHash>>();
+}
+
+bool testSharing()
+{
+  cmPersistentHashMap<std::string, int> original;
+  for (int i = 0; i < 100; ++i) {
+    original.Set(std::to_string(i), i);
+  }
+
+  cmPersistentHashMap<std::string, int> copy = original;
+  copy.Set("1", 10);
+  copy.Set("new", 1);
+  copy.Erase("2");
+
+  // Changes to the copy must not be visible in the original.
+  ASSERT_EQUAL(original.size(), 100u);
+  ASSERT_EQUAL(*original.Find("1"), 1);
+  ASSERT_TRUE(original.Find("new") == nullptr);
+  ASSERT_EQUAL(*original.Find("2"), 2);
+
+  ASSERT_EQUAL(copy.size(), 100u);
+  ASSERT_EQUAL(*copy.Find("1"), 10);
+  ASSERT_EQUAL(*copy.Find("new"), 1);
+  ASSERT_TRUE(copy.Find("2") == nullptr);
+
+  // Nor the other way around.
+  original.Set("3", 30);
+  ASSERT_EQUAL(*copy.Find("3"), 3);
+  return true;
+}
+}
+
+int testPersistentHashMap(int /*unused*/, char* /*unused*/[])
+{
+  return runTests({ testInsertAndErase, testCollisions, testSharing });
+}
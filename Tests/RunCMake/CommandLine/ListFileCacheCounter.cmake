@@ -0,0 +1,6 @@
+# Read the counts of the last listfile_cache counter in the profiling output.
+foreach(count IN ITEMS hits misses)
+  file(STRINGS "${ProfilingTestOutput}" counters REGEX "\"${count}\"[ ]*:")
+  list(GET counters -1 last)
+  string(REGEX REPLACE ".*: *" "" ${count} "${last}")
+endforeach()
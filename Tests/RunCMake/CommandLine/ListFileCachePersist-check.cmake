@@ -0,0 +1,10 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache.bin")
+  set(RunCMake_TEST_FAILED "Expected persisted list file cache")
+  return()
+endif()
+
+include(${CMAKE_CURRENT_LIST_DIR}/ListFileCacheCounter.cmake)
+if(NOT hits EQUAL 0 OR misses EQUAL 0)
+  set(RunCMake_TEST_FAILED
+    "Expected only list file cache misses, got ${hits} hits and ${misses} misses")
+endif()
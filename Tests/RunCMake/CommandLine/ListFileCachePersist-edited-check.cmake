@@ -0,0 +1,6 @@
+# Only the edited CMakeLists.txt is parsed again.
+include(${CMAKE_CURRENT_LIST_DIR}/ListFileCacheCounter.cmake)
+if(hits EQUAL 0 OR NOT misses EQUAL 1)
+  set(RunCMake_TEST_FAILED
+    "Expected one list file cache miss, got ${hits} hits and ${misses} misses")
+endif()
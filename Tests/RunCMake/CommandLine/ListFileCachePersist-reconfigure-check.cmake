@@ -0,0 +1,11 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache.bin")
+  set(RunCMake_TEST_FAILED "Expected persisted list file cache")
+  return()
+endif()
+
+# Every list file was parsed by the first configure.
+include(${CMAKE_CURRENT_LIST_DIR}/ListFileCacheCounter.cmake)
+if(hits EQUAL 0 OR NOT misses EQUAL 0)
+  set(RunCMake_TEST_FAILED
+    "Expected only list file cache hits, got ${hits} hits and ${misses} misses")
+endif()
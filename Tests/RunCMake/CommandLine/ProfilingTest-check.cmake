@@ -29,3 +29,31 @@ if (NOT numInvocations EQUAL 1)
   set(RunCMake_TEST_FAILED
       "Unexpected number of lowercase command names: ${numInvocations}")
 endif()
+
+file(STRINGS ${ProfilingTestOutput} listFileCacheCounter
+  REGEX [["name"[ ]*:[ ]*"listfile_cache"]])
+file(STRINGS ${ProfilingTestOutput} listFileCacheHits
+  REGEX [=["hits"[ ]*:[ ]*[1-9]]=])
+if (NOT listFileCacheCounter OR NOT listFileCacheHits)
+  set(RunCMake_TEST_FAILED "Expected listfile_cache counter with hits")
+endif()
+
+file(READ "${ProfilingTestOutput}" PROFILING_CONTENT)
+string(REGEX MATCHALL
+  [["cat"[ ]*:[ ]*"genex_compile",[^"]*"name"[ ]*:[ ]*"\$<\$<CONFIG:ProfilingTest>:Genex>"]]
+  genexCompile "${PROFILING_CONTENT}")
+list(LENGTH genexCompile numCompiles)
+if (NOT numCompiles EQUAL 1)
+  set(RunCMake_TEST_FAILED
+      "Unexpected number of genex_compile entries: ${numCompiles}")
+endif()
+
+foreach(entry IN ITEMS
+    [["cat"[ ]*:[ ]*"project",[^"]*"name"[ ]*:[ ]*"compute"]]
+    [["cat"[ ]*:[ ]*"compute",[^"]*"name"[ ]*:[ ]*"target_depends"]]
+    [["cat"[ ]*:[ ]*"generate",[^"]*"name"[ ]*:[ ]*"ProfilingTarget"]]
+    )
+  if (NOT PROFILING_CONTENT MATCHES "${entry}")
+    set(RunCMake_TEST_FAILED "Expected profiling entry matching ${entry}")
+  endif()
+endforeach()
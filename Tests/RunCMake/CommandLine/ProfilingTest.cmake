@@ -3,3 +3,14 @@ endfunction()
 
 # This must not appear in the profiling output as uppercase
 __TESTING_COMMAND_CASE()
+
+# The second inclusion must be served by the list file cache
+include(${CMAKE_CURRENT_LIST_DIR}/ProfilingTestInclude.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/ProfilingTestInclude.cmake)
+
+# Identical expressions must be parsed only once
+file(GENERATE OUTPUT genex1.txt CONTENT "$<$<CONFIG:ProfilingTest>:Genex>")
+file(GENERATE OUTPUT genex2.txt CONTENT "$<$<CONFIG:ProfilingTest>:Genex>")
+
+# The compute and generate steps must be recorded per target
+add_custom_target(ProfilingTarget)
@@ -0,0 +1 @@
+set(profiling_test_include_var 1)
@@ -1265,6 +1265,29 @@ set(RunCMake_TEST_OPTIONS --profiling-format=google-trace --profiling-output=${P
 run_cmake(ProfilingTest)
 unset(RunCMake_TEST_OPTIONS)
 
+block()
+  set(source_dir "${RunCMake_BINARY_DIR}/ListFileCachePersist")
+  file(REMOVE_RECURSE "${source_dir}")
+  file(WRITE "${source_dir}/CMakeLists.txt" [=[
+cmake_minimum_required(VERSION 3.10)
+project(ListFileCachePersist NONE)
+set(CMAKE_PERSIST_LISTFILE_CACHE ON)
+]=])
+  set(RunCMake_TEST_SOURCE_DIR "${source_dir}")
+  set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/ListFileCachePersist-build")
+  function(run_ListFileCachePersist case)
+    set(ProfilingTestOutput "${RunCMake_TEST_BINARY_DIR}/${case}.json")
+    set(RunCMake_TEST_OPTIONS
+      --profiling-format=google-trace --profiling-output=${ProfilingTestOutput})
+    run_cmake(${case})
+  endfunction()
+  run_ListFileCachePersist(ListFileCachePersist)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_ListFileCachePersist(ListFileCachePersist-reconfigure)
+  file(APPEND "${source_dir}/CMakeLists.txt" "message(STATUS \"Edited\")\n")
+  run_ListFileCachePersist(ListFileCachePersist-edited)
+endblock()
+
 run_cmake_with_options(help-arbitrary "--help" "CMAKE_CXX_IGNORE_EXTENSIONS")
 
 if (WIN32 OR DEFINED ENV{HOME})
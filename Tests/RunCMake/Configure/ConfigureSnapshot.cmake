@@ -0,0 +1,8 @@
+set(depend ${CMAKE_CURRENT_BINARY_DIR}/ConfigureSnapshotDepend.txt)
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${depend})
+file(READ ${depend} content)
+message(STATUS "ConfigureSnapshot configured with '${content}'")
+if(DEFINED ENV{CONFIGURE_SNAPSHOT_ENV})
+  message(STATUS "ConfigureSnapshot environment '$ENV{CONFIGURE_SNAPSHOT_ENV}'")
+endif()
+file(GENERATE OUTPUT ConfigureSnapshotGenerated.txt CONTENT "generated\n")
@@ -39,6 +39,47 @@ block()
   endif()
 endblock()
 
+block()
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ConfigureSnapshot-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  set(depend "${RunCMake_TEST_BINARY_DIR}/ConfigureSnapshotDepend.txt")
+  file(WRITE "${depend}" "1")
+  set(RunCMake_TEST_OPTIONS -Wno-author
+    -DCMAKE_EXPERIMENTAL_CONFIGURE_SNAPSHOT=2f0c4d6e-8b1a-4e37-9c5d-73a1e0b6f4c8)
+  run_cmake(ConfigureSnapshot)
+  run_cmake_command(ConfigureSnapshot-unchanged ${CMAKE_COMMAND} .)
+  set(ENV{CONFIGURE_SNAPSHOT_ENV} 1)
+  run_cmake_command(ConfigureSnapshot-env ${CMAKE_COMMAND} -Wno-author .)
+  run_cmake_command(ConfigureSnapshot-env-unchanged ${CMAKE_COMMAND} .)
+  unset(ENV{CONFIGURE_SNAPSHOT_ENV})
+  run_cmake_command(ConfigureSnapshot-env-unset ${CMAKE_COMMAND} -Wno-author .)
+  if(RunCMake_GENERATOR MATCHES "Make")
+    set(build_file Makefile)
+  elseif(RunCMake_GENERATOR MATCHES "Ninja")
+    set(build_file build.ninja)
+  endif()
+  if(build_file)
+    file(REMOVE "${RunCMake_TEST_BINARY_DIR}/${build_file}")
+    run_cmake_command(ConfigureSnapshot-build-file ${CMAKE_COMMAND} -Wno-author .)
+    if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${build_file}")
+      message(SEND_ERROR "ConfigureSnapshot did not regenerate ${build_file}")
+    endif()
+  endif()
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/TargetDirectories.txt")
+  run_cmake_command(ConfigureSnapshot-cmakefiles ${CMAKE_COMMAND} -Wno-author .)
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/ConfigureSnapshotGenerated.txt")
+  run_cmake_command(ConfigureSnapshot-generated ${CMAKE_COMMAND} -Wno-author .)
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/ConfigureSnapshotGenerated.txt")
+    message(SEND_ERROR "ConfigureSnapshot did not regenerate file(GENERATE) output")
+  endif()
+  file(WRITE "${depend}" "2")
+  run_cmake_command(ConfigureSnapshot-changed ${CMAKE_COMMAND} -Wno-author .)
+  run_cmake_command(ConfigureSnapshot-cache ${CMAKE_COMMAND} -Wno-author -DSOME_CACHE_ENTRY=1 .)
+  run_cmake_command(ConfigureSnapshot-option ${CMAKE_COMMAND} -Wno-author --log-level=STATUS .)
+endblock()
+
 if(RunCMake_GENERATOR MATCHES "^Ninja")
   block()
     set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/RerunCMakeNinja-build)
@@ -0,0 +1,4 @@
+include("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/hello.dir/DependInfo.cmake")
+if(CMAKE_DEPENDS_DEPENDENCY_FILES AND NOT actual_stdout MATCHES "cmake_depends")
+  set(RunCMake_TEST_FAILED "Compiler generated dependencies not consolidated.")
+endif()
@@ -0,0 +1,3 @@
+if(NOT actual_stdout MATCHES "depend\\.c\\.o")
+  set(RunCMake_TEST_FAILED "Object not rebuilt after its header changed.")
+endif()
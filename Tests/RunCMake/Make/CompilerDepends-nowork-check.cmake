@@ -0,0 +1,8 @@
+include("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/hello.dir/DependInfo.cmake")
+file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/hello.dir/build.make" build_make)
+# On file systems with time stamps in whole seconds, CMake checks the
+# dependencies itself on every build.
+if(CMAKE_DEPENDS_DEPENDENCY_FILES AND build_make MATCHES "compiler_depend\\.internal:"
+    AND actual_stdout MATCHES "cmake_depends")
+  set(RunCMake_TEST_FAILED "Unchanged compiler generated dependencies consolidated again.")
+endif()
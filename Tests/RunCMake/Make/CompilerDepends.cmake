@@ -0,0 +1,16 @@
+enable_language(C)
+
+# Write a header to the build tree so the test can touch it.
+file(CONFIGURE OUTPUT depend.h CONTENT [[
+#define DEPEND 0
+]])
+file(CONFIGURE OUTPUT depend.c CONTENT [[
+#include "depend.h"
+
+int depend(void)
+{
+  return DEPEND;
+}
+]])
+
+add_executable(hello hello.c ${CMAKE_CURRENT_BINARY_DIR}/depend.c)
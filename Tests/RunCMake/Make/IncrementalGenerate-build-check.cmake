@@ -0,0 +1,5 @@
+foreach(stamp IN ITEMS same/same.stamp changed/changed-2.stamp)
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate/${stamp}")
+    string(APPEND RunCMake_TEST_FAILED "Missing ${stamp}\n")
+  endif()
+endforeach()
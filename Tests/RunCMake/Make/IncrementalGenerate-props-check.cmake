@@ -0,0 +1,27 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate")
+
+file(READ "${dir}/same/CMakeFiles/same.dir/build.make" same_content)
+if(NOT same_content MATCHES "# reused")
+  string(APPEND RunCMake_TEST_FAILED
+    "Unchanged directory was generated again:\n  ${dir}/same\n")
+endif()
+
+foreach(case IN ITEMS sourceprops genex)
+  set(build "${dir}/${case}/CMakeFiles/${case}.dir/build.make")
+  file(READ "${build}" content)
+  if(content MATCHES "# reused")
+    string(APPEND RunCMake_TEST_FAILED
+      "Directory with changed properties was not generated again:\n  ${build}\n")
+  endif()
+endforeach()
+
+file(READ "${dir}/sourceprops/CMakeFiles/sourceprops.dir/build.make" content)
+if(NOT content MATCHES "PROPS_VALUE=2")
+  string(APPEND RunCMake_TEST_FAILED
+    "Source compile definitions were not generated again.\n")
+endif()
+file(READ "${dir}/genex/CMakeFiles/genex.dir/build.make" content)
+if(NOT content MATCHES "props-2")
+  string(APPEND RunCMake_TEST_FAILED
+    "Referenced target property was not evaluated again.\n")
+endif()
@@ -0,0 +1,17 @@
+set(same_build "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate/same/CMakeFiles/same.dir/build.make")
+set(changed_build "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate/changed/CMakeFiles/changed.dir/build.make")
+
+file(READ "${same_build}" same_content)
+if(NOT same_content MATCHES "# reused")
+  string(APPEND RunCMake_TEST_FAILED
+    "Unchanged directory was generated again:\n  ${same_build}\n")
+endif()
+
+file(READ "${changed_build}" changed_content)
+if(changed_content MATCHES "# reused")
+  string(APPEND RunCMake_TEST_FAILED
+    "Changed directory was not generated again:\n  ${changed_build}\n")
+elseif(NOT changed_content MATCHES "changed-2\\.stamp")
+  string(APPEND RunCMake_TEST_FAILED
+    "Changed directory does not have the new command:\n  ${changed_build}\n")
+endif()
@@ -0,0 +1,13 @@
+set(CMAKE_EXPERIMENTAL_INCREMENTAL_GENERATE "ba1c8f5e-0071-421f-ac92-b77df7a82f38")
+enable_language(C)
+add_subdirectory(IncrementalGenerate/same)
+add_subdirectory(IncrementalGenerate/changed)
+add_subdirectory(IncrementalGenerate/sourceprops)
+add_subdirectory(IncrementalGenerate/genex)
+
+# Change what other directories generate only through properties.
+include(${CMAKE_BINARY_DIR}/props.cmake)
+set_source_files_properties(hello.c DIRECTORY IncrementalGenerate/sourceprops
+  PROPERTIES COMPILE_DEFINITIONS "PROPS_VALUE=${props_value}")
+add_custom_target(referenced)
+set_property(TARGET referenced PROPERTY PROPS_VALUE "props-${props_value}")
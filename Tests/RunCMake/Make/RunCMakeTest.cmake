@@ -62,6 +62,47 @@ function(run_VerboseBuildShort)
 endfunction()
 run_VerboseBuildShort()
 
+function(run_CompilerDepends)
+  run_cmake(CompilerDepends)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CompilerDepends-build)
+  run_cmake_command(CompilerDepends-build ${CMAKE_COMMAND} --build .)
+  run_cmake_command(CompilerDepends-consolidate ${CMAKE_COMMAND} --build . --verbose)
+  run_cmake_command(CompilerDepends-nowork ${CMAKE_COMMAND} --build . --verbose)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(TOUCH "${RunCMake_TEST_BINARY_DIR}/depend.h")
+  run_cmake_command(CompilerDepends-header ${CMAKE_COMMAND} --build . --verbose)
+endfunction()
+if(NOT RunCMake_GENERATOR STREQUAL "Watcom WMake")
+  # wmake does not actually show the verbose output.
+  run_CompilerDepends()
+endif()
+
+function(run_UpToDateCheck_touch touched rebuilt)
+  # Make must run after an input of a rule changes.
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/UpToDateCheck-build)
+  set(RunCMake-check-file UpToDateCheck-touch-check.cmake)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(TOUCH "${RunCMake_TEST_BINARY_DIR}/${touched}")
+  run_cmake_command(UpToDateCheck-touch-${touched} ${CMAKE_COMMAND} --build . --verbose)
+endfunction()
+function(run_UpToDateCheck)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_MAKEFILE_UP_TO_DATE_CHECK=ON)
+  run_cmake(UpToDateCheck)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/UpToDateCheck-build)
+  run_cmake_command(UpToDateCheck-build ${CMAKE_COMMAND} --build .)
+  run_cmake_command(UpToDateCheck-consolidate ${CMAKE_COMMAND} --build .)
+  run_cmake_command(UpToDateCheck-nowork ${CMAKE_COMMAND} --build . --verbose)
+  run_UpToDateCheck_touch(hello.c "hello\\.c\\.o")
+  run_UpToDateCheck_touch(hello.h "hello\\.c\\.o")
+  run_UpToDateCheck_touch(message.txt "UpToDateCheck-message\\.cmake")
+endfunction()
+if(NOT RunCMake_GENERATOR STREQUAL "Watcom WMake")
+  run_UpToDateCheck()
+endif()
+
 run_cmake(IncludeRegexSubdir)
 
 function(run_MakefileConflict)
@@ -135,3 +176,35 @@ if(MAKE_IS_GNU)
   # commands with the '+' operator.
   run_cmake(GNUMakeJobServerAware)
 endif()
+
+function(run_IncrementalGenerate)
+  set(RunCMake_TEST_OPTIONS -Wno-author)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/IncrementalGenerate-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/value.cmake" "set(value 1)\n")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/props.cmake" "set(props_value 1)\n")
+  run_cmake(IncrementalGenerate)
+  # The first configuration sets some variables only once, so the
+  # fingerprints settle on the second run.
+  run_cmake_command(IncrementalGenerate-again ${CMAKE_COMMAND} -Wno-author .)
+
+  # Mark the rule files to tell which ones are generated again.
+  foreach(dir IN ITEMS same changed)
+    file(APPEND "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate/${dir}/CMakeFiles/${dir}.dir/build.make"
+      "# reused\n")
+  endforeach()
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/value.cmake" "set(value 2)\n")
+  run_cmake_command(IncrementalGenerate-rerun ${CMAKE_COMMAND} -Wno-author .)
+  run_cmake_command(IncrementalGenerate-build ${CMAKE_COMMAND} --build .)
+
+  # Change a source property and a target property set by another directory.
+  foreach(dir IN ITEMS same sourceprops genex)
+    file(APPEND "${RunCMake_TEST_BINARY_DIR}/IncrementalGenerate/${dir}/CMakeFiles/${dir}.dir/build.make"
+      "# reused\n")
+  endforeach()
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/props.cmake" "set(props_value 2)\n")
+  run_cmake_command(IncrementalGenerate-props ${CMAKE_COMMAND} -Wno-author .)
+endfunction()
+run_IncrementalGenerate()
@@ -0,0 +1,4 @@
+file(READ "${INPUT}" message)
+string(STRIP "${message}" message)
+file(WRITE "${OUTPUT}" "char const* ${message}(void) { return \"${message}\"; }\n")
+file(WRITE "${DEPFILE}" "${OUTPUT}: ${INPUT}\n")
@@ -0,0 +1,6 @@
+include("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/hello.dir/DependInfo.cmake")
+if(CMAKE_DEPENDS_DEPENDENCY_FILES AND NOT actual_stdout MATCHES "The build is up to date\\.")
+  set(RunCMake_TEST_FAILED "Build with nothing to do was not found up to date.")
+elseif(actual_stdout MATCHES "The build is up to date\\." AND NOT CMAKE_DEPENDS_DEPENDENCY_FILES)
+  set(RunCMake_TEST_FAILED "Build with dependencies scanned by CMake was found up to date.")
+endif()
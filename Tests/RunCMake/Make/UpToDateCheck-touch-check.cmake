@@ -0,0 +1,5 @@
+if(actual_stdout MATCHES "The build is up to date\\.")
+  set(RunCMake_TEST_FAILED "Build after touching ${touched} was found up to date.")
+elseif(NOT actual_stdout MATCHES "${rebuilt}")
+  set(RunCMake_TEST_FAILED "Build after touching ${touched} did not run:\n  ${rebuilt}")
+endif()
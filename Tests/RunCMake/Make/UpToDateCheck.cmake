@@ -0,0 +1,31 @@
+enable_language(C)
+cmake_policy(SET CMP0116 NEW)
+
+# Write the sources to the build tree so the test can touch them.
+file(CONFIGURE OUTPUT hello.h CONTENT [[
+#define GREETING "Hello world!"
+]])
+file(CONFIGURE OUTPUT hello.c CONTENT [[
+#include <stdio.h>
+
+#include "hello.h"
+
+int main(void)
+{
+  printf("%s\n", GREETING);
+  return 0;
+}
+]])
+file(CONFIGURE OUTPUT message.txt CONTENT "message\n")
+
+add_custom_command(
+  OUTPUT message.c
+  COMMAND ${CMAKE_COMMAND}
+    -DINPUT=${CMAKE_CURRENT_BINARY_DIR}/message.txt
+    -DOUTPUT=message.c
+    -DDEPFILE=message.c.d
+    -P ${CMAKE_CURRENT_SOURCE_DIR}/UpToDateCheck-message.cmake
+  DEPFILE message.c.d
+  )
+
+add_executable(hello ${CMAKE_CURRENT_BINARY_DIR}/hello.c message.c)
@@ -73,6 +73,22 @@ function(run_NoWorkToDo)
 endfunction()
 run_NoWorkToDo()
 
+function(run_SplitBuildFile)
+  run_cmake(SplitBuildFile)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SplitBuildFile-build)
+  set(RunCMake_TEST_OUTPUT_MERGE 1)
+  run_cmake_command(SplitBuildFile-build ${CMAKE_COMMAND} --build .)
+  run_cmake_command(SplitBuildFile-nowork ${CMAKE_COMMAND} --build . -- -d explain)
+  # The first configure step defines variables that later ones only load.
+  run_cmake_command(SplitBuildFile-reconfigure ${CMAKE_COMMAND} .)
+  file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory.ninja" top_time "%s")
+  file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/SubDirPrefix/CMakeFiles/directory.ninja" sub_time "%s")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake_command(SplitBuildFile-regenerate ${CMAKE_COMMAND} -DSPLIT_DEFINITION=1 .)
+endfunction()
+run_SplitBuildFile()
+
 function(run_WithBuild name)
   run_cmake("${name}")
   set(RunCMake_TEST_NO_CLEAN 1)
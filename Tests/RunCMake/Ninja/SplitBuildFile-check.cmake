@@ -0,0 +1,13 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_file)
+foreach(dir IN ITEMS "" "SubDirPrefix/")
+  set(directory_file "${dir}CMakeFiles/directory.ninja")
+  if(NOT build_file MATCHES "\nsubninja ${directory_file}\n")
+    string(APPEND RunCMake_TEST_FAILED "build.ninja does not include ${directory_file}\n")
+  endif()
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${directory_file}")
+    string(APPEND RunCMake_TEST_FAILED "${directory_file} does not exist\n")
+  endif()
+endforeach()
+if(build_file MATCHES "greeting\\.c")
+  string(APPEND RunCMake_TEST_FAILED "build.ninja has the build statements of SubDirPrefix\n")
+endif()
@@ -0,0 +1,8 @@
+file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory.ninja" top_time_new "%s")
+file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/SubDirPrefix/CMakeFiles/directory.ninja" sub_time_new "%s")
+if(top_time_new STREQUAL top_time)
+  string(APPEND RunCMake_TEST_FAILED "CMakeFiles/directory.ninja was not written again\n")
+endif()
+if(NOT sub_time_new STREQUAL sub_time)
+  string(APPEND RunCMake_TEST_FAILED "SubDirPrefix/CMakeFiles/directory.ninja was written again\n")
+endif()
@@ -0,0 +1,10 @@
+enable_language(C)
+
+set(CMAKE_NINJA_SPLIT_BUILD_FILE ON)
+
+add_subdirectory(SubDirPrefix)
+add_executable(hello_with_greeting hello_with_greeting.c)
+target_link_libraries(hello_with_greeting PRIVATE greeting)
+if(SPLIT_DEFINITION)
+  target_compile_definitions(hello_with_greeting PRIVATE SPLIT_DEFINITION)
+endif()
@@ -41,12 +41,29 @@ if(CMake_TEST_CUDA)
 endif()
 run_cmake(unitybuild_batchsize)
 run_cmake(unitybuild_default_batchsize)
+run_cmake(unitybuild_balanced)
+run_cmake(unitybuild_balanced_spread)
+
+function(run_balanced_regenerate)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/unitybuild_balanced_regenerate-build)
+  run_cmake(unitybuild_balanced_regenerate)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(GLOB unity_files "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_*_c.c")
+  foreach(unity_file IN LISTS unity_files)
+    file(READ "${unity_file}" "content_${unity_file}")
+    file(TIMESTAMP "${unity_file}" "time_${unity_file}" "%s")
+  endforeach()
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake_command(unitybuild_balanced_regenerate-cost ${CMAKE_COMMAND} -DS16_COST=150 .)
+endfunction()
+run_balanced_regenerate()
 run_cmake(unitybuild_skip)
 run_cmake(unitybuild_code_before_and_after_include)
 run_cmake(unitybuild_c_no_unity_build)
 run_cmake(unitybuild_c_no_unity_build_group)
 run_cmake(unitybuild_order)
 run_cmake(unitybuild_invalid_mode)
+run_cmake(unitybuild_balanced_invalid_cost)
 run_build(unitybuild_anon_ns)
 run_build(unitybuild_anon_ns_no_unity_build)
 run_build(unitybuild_anon_ns_group_mode)
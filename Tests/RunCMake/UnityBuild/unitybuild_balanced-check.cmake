@@ -0,0 +1,23 @@
+file(GLOB unity_files "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_*_c.c")
+set(found "")
+foreach(unity_file IN LISTS unity_files)
+  file(STRINGS "${unity_file}" includes REGEX "#include")
+  foreach(include IN LISTS includes)
+    if(include MATCHES "(s[0-9]+\\.c)")
+      list(APPEND found "${CMAKE_MATCH_1}")
+    endif()
+  endforeach()
+  if(includes MATCHES "s1\\.c" AND NOT includes STREQUAL "#include \"${RunCMake_TEST_BINARY_DIR}/s1.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unity_file} does not contain only the costly source s1.c")
+    return()
+  endif()
+endforeach()
+list(SORT found)
+if(NOT found STREQUAL "s1.c;s2.c;s3.c;s4.c;s5.c;s6.c;s7.c;s8.c")
+  set(RunCMake_TEST_FAILED "Generated unity files do not contain each source once:\n  ${found}")
+  return()
+endif()
+list(LENGTH unity_files count)
+if(count LESS 2)
+  set(RunCMake_TEST_FAILED "The costly source s1.c is not compiled alone.")
+endif()
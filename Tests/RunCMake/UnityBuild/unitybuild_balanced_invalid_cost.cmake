@@ -0,0 +1,15 @@
+project(unitybuild_balanced_invalid_cost C)
+
+set(srcs "")
+foreach(s RANGE 1 2)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt PROPERTIES UNITY_BUILD ON
+                                     UNITY_BUILD_MODE BALANCED)
+
+set_source_files_properties(s1.c PROPERTIES UNITY_BUILD_COST fast)
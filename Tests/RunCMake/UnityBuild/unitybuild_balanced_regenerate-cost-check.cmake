@@ -0,0 +1,24 @@
+# The unity files that neither contain s16.c nor start with s17.c are
+# not written again.
+set(kept 0)
+foreach(unity_file IN LISTS unity_files)
+  set(old_content "${content_${unity_file}}")
+  if(old_content MATCHES "/s16\\.c\"" OR old_content MATCHES "^[^#]*#include \"[^\"]*/s17\\.c\"")
+    continue()
+  endif()
+  if(NOT EXISTS "${unity_file}")
+    string(APPEND RunCMake_TEST_FAILED "${unity_file} no longer exists\n")
+    continue()
+  endif()
+  file(READ "${unity_file}" new_content)
+  file(TIMESTAMP "${unity_file}" new_time "%s")
+  if(NOT new_content STREQUAL old_content)
+    string(APPEND RunCMake_TEST_FAILED "${unity_file} changed\n")
+  elseif(NOT new_time STREQUAL "${time_${unity_file}}")
+    string(APPEND RunCMake_TEST_FAILED "${unity_file} was written again\n")
+  endif()
+  math(EXPR kept "${kept} + 1")
+endforeach()
+if(kept LESS 2)
+  string(APPEND RunCMake_TEST_FAILED "Only ${kept} unity files were compared\n")
+endif()
@@ -0,0 +1,24 @@
+set(CMAKE_INTERMEDIATE_DIR_STRATEGY FULL CACHE STRING "" FORCE)
+
+project(unitybuild_balanced_regenerate C)
+
+set(srcs "")
+foreach(s RANGE 1 32)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt
+  PROPERTIES
+    UNITY_BUILD ON
+    UNITY_BUILD_MODE BALANCED
+    UNITY_BUILD_BATCH_SIZE 4
+)
+
+set_source_files_properties(${srcs} PROPERTIES UNITY_BUILD_COST 100)
+if(S16_COST)
+  set_source_files_properties(s16.c PROPERTIES UNITY_BUILD_COST ${S16_COST})
+endif()
@@ -0,0 +1,33 @@
+# Apart from the costly source s40.c, which is compiled alone, no unity
+# file costs more than twice the median cost of a unity file.
+file(GLOB unity_files "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_*_c.c")
+set(file_costs "")
+foreach(unity_file IN LISTS unity_files)
+  file(STRINGS "${unity_file}" includes REGEX "#include")
+  if(includes MATCHES "/s40\\.c\"")
+    if(NOT includes STREQUAL "#include \"${RunCMake_TEST_BINARY_DIR}/s40.c\"")
+      string(APPEND RunCMake_TEST_FAILED "The costly source s40.c is not compiled alone\n")
+    endif()
+    continue()
+  endif()
+  set(file_cost 0)
+  foreach(include IN LISTS includes)
+    if(include MATCHES "/s([0-9]+)\\.c\"")
+      math(EXPR file_cost "${file_cost} + 20 + (${CMAKE_MATCH_1} * 37 % 101) * 4")
+    endif()
+  endforeach()
+  list(APPEND file_costs "${file_cost}")
+endforeach()
+list(SORT file_costs COMPARE NATURAL)
+list(LENGTH file_costs count)
+if(count LESS 4)
+  set(RunCMake_TEST_FAILED "Only ${count} unity files were written")
+  return()
+endif()
+math(EXPR middle "${count} / 2")
+list(GET file_costs ${middle} median)
+list(GET file_costs -1 max)
+math(EXPR limit "2 * ${median}")
+if(max GREATER limit)
+  string(APPEND RunCMake_TEST_FAILED "The costliest unity file costs ${max}, more than twice the median ${median}:\n  ${file_costs}\n")
+endif()
@@ -0,0 +1,22 @@
+set(CMAKE_INTERMEDIATE_DIR_STRATEGY FULL CACHE STRING "" FORCE)
+
+project(unitybuild_balanced_spread C)
+
+set(srcs "")
+foreach(s RANGE 1 64)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+  math(EXPR cost "20 + (${s} * 37 % 101) * 4")
+  set_source_files_properties(${src} PROPERTIES UNITY_BUILD_COST ${cost})
+endforeach()
+set_source_files_properties("${CMAKE_CURRENT_BINARY_DIR}/s40.c" PROPERTIES UNITY_BUILD_COST 5000)
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt
+  PROPERTIES
+    UNITY_BUILD ON
+    UNITY_BUILD_MODE BALANCED
+    UNITY_BUILD_BATCH_SIZE 8
+)
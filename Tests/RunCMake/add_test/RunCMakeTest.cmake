@@ -58,3 +58,41 @@ block()
   run_cmake_command(TestLauncher-test ${CMAKE_CTEST_COMMAND} -C Debug -V)
 endblock()
 unset(RunCMake_TEST_OPTIONS)
+
+block()
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestManifest-build)
+  run_cmake(TestManifest)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(TestManifest-ctest ${CMAKE_CTEST_COMMAND} -C Debug -L top)
+  # Evaluate the test files instead and expect the same tests.
+  file(REMOVE
+    ${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json
+    ${RunCMake_TEST_BINARY_DIR}/TestManifest/CTestTestfile.json
+    )
+  set(RunCMake-stdout-file TestManifest-ctest-stdout.txt)
+  run_cmake_command(TestManifest-script ${CMAKE_CTEST_COMMAND} -C Debug -L top)
+endblock()
+run_cmake(TestManifestInclude)
+
+block()
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestImpact-build)
+  run_cmake(TestImpact)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_OUTPUT_MERGE 1)
+  run_cmake_command(TestImpact-build ${CMAKE_COMMAND} --build . --config Debug)
+  unset(RunCMake_TEST_OUTPUT_MERGE)
+  function(run_TestImpact case)
+    list(JOIN ARGN "\n" changed)
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/changed.txt" "${changed}\n")
+    run_cmake_command(TestImpact-${case}
+      ${CMAKE_CTEST_COMMAND} -C Debug -N --affected-by changed.txt)
+  endfunction()
+  run_TestImpact(lib TestImpact/lib.c)
+  run_TestImpact(exe main.c TestImpact/untested.c)
+  run_TestImpact(script ${RunCMake_SOURCE_DIR}/TestImpact/script.cmake)
+  run_TestImpact(file TestImpact/data.txt)
+  run_TestImpact(listfile TestImpact.cmake)
+  run_TestImpact(none TestImpact/untested.c)
+  run_TestImpact(unknown main.c TestImpact/unknown.h)
+endblock()
+run_cmake(TestImpactDisabled)
@@ -0,0 +1,4 @@
+set(index "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/TestImpact.json")
+if(NOT EXISTS "${index}")
+  set(RunCMake_TEST_FAILED "Test impact index not generated:\n  ${index}")
+endif()
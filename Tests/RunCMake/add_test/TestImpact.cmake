@@ -0,0 +1,17 @@
+enable_language(C)
+enable_testing()
+set(CMAKE_EXPORT_TEST_IMPACT ON)
+add_library(lib STATIC TestImpact/lib.c)
+add_executable(exe main.c)
+target_link_libraries(exe PRIVATE lib)
+add_executable(other TestImpact/other.c)
+add_library(untested STATIC TestImpact/untested.c)
+add_test(NAME uses_exe COMMAND exe)
+add_test(NAME uses_other COMMAND other)
+add_test(NAME uses_genex COMMAND ${CMAKE_COMMAND} -E echo $<TARGET_FILE:lib>)
+add_test(NAME uses_script
+  COMMAND ${CMAKE_COMMAND} -P ${CMAKE_CURRENT_SOURCE_DIR}/TestImpact/script.cmake)
+add_test(NAME uses_file COMMAND ${CMAKE_COMMAND} -E true)
+set_property(TEST uses_file PROPERTY REQUIRED_FILES
+  ${CMAKE_CURRENT_SOURCE_DIR}/TestImpact/data.txt)
+add_test(NAME uses_nothing COMMAND ${CMAKE_COMMAND} -E true)
@@ -0,0 +1,4 @@
+int untested(void)
+{
+  return 0;
+}
@@ -0,0 +1,4 @@
+set(index "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/TestImpact.json")
+if(EXISTS "${index}")
+  set(RunCMake_TEST_FAILED "Test impact index generated without being enabled:\n  ${index}")
+endif()
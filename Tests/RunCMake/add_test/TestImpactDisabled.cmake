@@ -0,0 +1,2 @@
+enable_testing()
+add_test(NAME uses_nothing COMMAND ${CMAKE_COMMAND} -E true)
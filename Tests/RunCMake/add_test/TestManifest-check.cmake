@@ -0,0 +1,10 @@
+foreach(dir IN ITEMS "" "/TestManifest")
+  set(manifest "${RunCMake_TEST_BINARY_DIR}${dir}/CTestTestfile.json")
+  if(NOT EXISTS "${manifest}")
+    string(APPEND RunCMake_TEST_FAILED "Test manifest not generated:\n  ${manifest}\n")
+  endif()
+  file(STRINGS "${RunCMake_TEST_BINARY_DIR}${dir}/CTestTestfile.cmake" marker REGEX "^# Test manifest: ")
+  if(NOT marker STREQUAL "# Test manifest: CTestTestfile.json")
+    string(APPEND RunCMake_TEST_FAILED "Test file does not name the manifest:\n  ${dir}\n")
+  endif()
+endforeach()
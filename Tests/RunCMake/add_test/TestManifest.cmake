@@ -0,0 +1,8 @@
+enable_testing()
+set_property(DIRECTORY PROPERTY LABELS top)
+add_test(NAME first COMMAND ${CMAKE_COMMAND} -E echo "one;two" "")
+set_property(TEST first PROPERTY LABELS first)
+add_test(NAME release COMMAND ${CMAKE_COMMAND} -E true CONFIGURATIONS Release)
+add_test(NAME disabled COMMAND ${CMAKE_COMMAND} -E false)
+set_property(TEST disabled PROPERTY DISABLED ON)
+add_subdirectory(TestManifest)
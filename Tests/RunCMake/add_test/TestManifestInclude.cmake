@@ -0,0 +1,4 @@
+enable_testing()
+add_test(NAME first COMMAND ${CMAKE_COMMAND} -E true)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/include.cmake "add_test(second \"${CMAKE_COMMAND}\" -E true)\n")
+set_property(DIRECTORY PROPERTY TEST_INCLUDE_FILES ${CMAKE_CURRENT_BINARY_DIR}/include.cmake)
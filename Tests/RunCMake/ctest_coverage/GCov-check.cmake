@@ -0,0 +1,28 @@
+file(GLOB coverage_log "${RunCMake_TEST_BINARY_DIR}/Testing/*/CoverageLog-0.xml")
+if(NOT coverage_log)
+  set(RunCMake_TEST_FAILED "CoverageLog-0.xml not found")
+  return()
+endif()
+file(READ "${coverage_log}" coverage_log_xml)
+if(NOT coverage_log_xml MATCHES "<File Name=\"used.c\"[^>]*>(.*</Report>)")
+  set(RunCMake_TEST_FAILED "No report for used.c in:\n  ${coverage_log}")
+  return()
+endif()
+string(REGEX REPLACE "</Report>.*" "" report "${CMAKE_MATCH_1}")
+string(REGEX MATCHALL "Number=\"[0-9]+\" Count=\"-?[0-9]+\"" lines "${report}")
+string(REGEX REPLACE "Number=\"([0-9]+)\" Count=\"(-?[0-9]+)\"" "\\1:\\2"
+  counts "${lines}")
+
+# The used function runs three times, and the unused function never runs.
+set(expect "0:3;1:-1;2:3;3:-1;4:-1;5:0;6:-1;7:0;8:-1")
+if(NOT counts STREQUAL expect)
+  string(APPEND RunCMake_TEST_FAILED
+    "Line counts of used.c are\n  ${counts}\nbut expected\n  ${expect}\n")
+endif()
+
+file(GLOB coverage "${RunCMake_TEST_BINARY_DIR}/Testing/*/Coverage.xml")
+file(READ "${coverage}" coverage_xml)
+if(NOT coverage_xml MATCHES "<File Name=\"used.c\"[^>]*>[ \t\n]*<LOCTested>2</LOCTested>[ \t\n]*<LOCUnTested>2</LOCUnTested>")
+  string(APPEND RunCMake_TEST_FAILED
+    "Coverage.xml does not report 2 tested and 2 untested lines of used.c\n")
+endif()
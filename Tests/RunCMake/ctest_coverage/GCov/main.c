@@ -0,0 +1,11 @@
+int used(int x);
+
+int main(void)
+{
+  int sum = 0;
+  int i;
+  for (i = 0; i < 3; ++i) {
+    sum += used(i);
+  }
+  return sum == 3 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+int used(int x)
+{
+  return x;
+}
+
+int unused(int x)
+{
+  return -x;
+}
@@ -0,0 +1,17 @@
+include("${CMAKE_CURRENT_LIST_DIR}/GCovText-check.cmake")
+
+# The coverage log of a parallel run matches that of the serial run.
+function(read_coverage_log case var)
+  file(GLOB coverage_log "${RunCMake_BINARY_DIR}/${case}-build/Testing/*/CoverageLog-0.xml")
+  file(STRINGS "${coverage_log}" lines REGEX "<(File|Line) ")
+  set("${var}" "${lines}" PARENT_SCOPE)
+endfunction()
+read_coverage_log(GCovText serial)
+read_coverage_log(GCovParallel parallel)
+if(NOT parallel STREQUAL serial)
+  string(REPLACE ";" "\n  " serial "${serial}")
+  string(REPLACE ";" "\n  " parallel "${parallel}")
+  string(APPEND RunCMake_TEST_FAILED
+    "The coverage log of the parallel run is\n  ${parallel}\n"
+    "but that of the serial run is\n  ${serial}\n")
+endif()
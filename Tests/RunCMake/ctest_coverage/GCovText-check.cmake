@@ -0,0 +1,8 @@
+include("${CMAKE_CURRENT_LIST_DIR}/GCov-check.cmake")
+
+file(GLOB coverage_log "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastCoverage_*.log")
+file(READ "${coverage_log}" coverage_log_text)
+if(coverage_log_text MATCHES "--json-format")
+  string(APPEND RunCMake_TEST_FAILED
+    "gcov ran with --json-format although CTEST_COVERAGE_GCOV_JSON is OFF\n")
+endif()
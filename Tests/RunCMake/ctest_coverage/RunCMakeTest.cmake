@@ -8,3 +8,24 @@ function(run_ctest_coverage CASE_NAME)
 endfunction()
 
 run_ctest_coverage(CoverageQuiet QUIET)
+
+if(CMAKE_C_COMPILER_ID STREQUAL "GNU" AND COVERAGE_COMMAND MATCHES "gcov")
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+enable_language(C)
+add_compile_options(--coverage)
+add_link_options(--coverage)
+add_executable(covered GCov/main.c GCov/used.c)
+add_test(NAME covered COMMAND covered)
+]])
+  function(run_GCov CASE_NAME)
+    file(COPY "${RunCMake_SOURCE_DIR}/GCov"
+      DESTINATION "${RunCMake_BINARY_DIR}/${CASE_NAME}")
+    run_ctest(${CASE_NAME} ${ARGN})
+  endfunction()
+  run_GCov(GCov)
+  set(CASE_TEST_PREFIX_CODE "set(CTEST_COVERAGE_GCOV_JSON OFF)")
+  run_GCov(GCovText)
+  run_GCov(GCovParallel -j2)
+  unset(CASE_TEST_PREFIX_CODE)
+  unset(CASE_CMAKELISTS_SUFFIX_CODE)
+endif()
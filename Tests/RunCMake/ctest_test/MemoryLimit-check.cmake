@@ -0,0 +1,15 @@
+# The peak memory of the tests is measured only on Linux.
+if(NOT CMAKE_HOST_SYSTEM_NAME STREQUAL "Linux")
+  return()
+endif()
+file(STRINGS "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestMemoryData.txt" lines)
+foreach(test IN ITEMS test_a test_b)
+  if(NOT lines MATCHES "(^|;)${test} ([0-9]+)(;|$)" OR CMAKE_MATCH_2 EQUAL 600)
+    string(APPEND RunCMake_TEST_FAILED "Peak memory of ${test} not recorded:\n  ${lines}\n")
+  endif()
+  set(peak_${test} "${CMAKE_MATCH_2}")
+endforeach()
+# test_b runs a second process, which counts too.
+if(NOT peak_test_b GREATER peak_test_a)
+  string(APPEND RunCMake_TEST_FAILED "Peak memory of the process started by test_b not counted:\n  ${lines}\n")
+endif()
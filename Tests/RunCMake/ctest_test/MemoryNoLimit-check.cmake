@@ -0,0 +1,5 @@
+# Memory is neither measured nor recorded without a memory limit.
+file(READ "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestMemoryData.txt" data)
+if(NOT data STREQUAL "test_a 600\ntest_b 600\n")
+  string(APPEND RunCMake_TEST_FAILED "Memory data was written:\n  ${data}\n")
+endif()
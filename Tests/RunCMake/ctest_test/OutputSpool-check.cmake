@@ -0,0 +1,28 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/TestOutput")
+foreach(test IN ITEMS 3-test_fail 4-test_full 6-test_same_name)
+  if(NOT EXISTS "${dir}/${test}.log.gz")
+    string(APPEND RunCMake_TEST_FAILED "Output of ${test} not spooled.\n")
+  endif()
+endforeach()
+foreach(test IN ITEMS 2-test_pass 5-test_same_name)
+  if(EXISTS "${dir}/${test}.log.gz")
+    string(APPEND RunCMake_TEST_FAILED "Output of ${test} not removed.\n")
+  endif()
+endforeach()
+
+file(READ "${RunCMake_TEST_BINARY_DIR}/junit.xml" junit_xml)
+foreach(test IN ITEMS test_fail test_pass test_full)
+  if(junit_xml MATCHES "<testcase name=\"${test}\"[^\n]*\n(.*)</testcase>")
+    string(REGEX REPLACE "</testcase>.*" "" "${test}_out" "${CMAKE_MATCH_1}")
+  else()
+    string(APPEND RunCMake_TEST_FAILED "${test} not found in junit.xml.\n")
+  endif()
+endforeach()
+if(NOT test_fail_out MATCHES "exceeds the threshold of 200 bytes")
+  string(APPEND RunCMake_TEST_FAILED
+    "Output of test_fail not truncated:\n${test_fail_out}\n")
+endif()
+if(NOT test_full_out MATCHES "line 25 x+\nline 26 x+\n.*CTEST_FULL_OUTPUT")
+  string(APPEND RunCMake_TEST_FAILED
+    "Output of test_full not read from its spool file:\n${test_full_out}\n")
+endif()
@@ -0,0 +1,10 @@
+string(REPEAT "x" 100 pad)
+foreach(i RANGE 1 50)
+  message("line ${i} ${pad}")
+endforeach()
+if(FULL)
+  message("CTEST_FULL_OUTPUT")
+endif()
+if(FAIL)
+  message(FATAL_ERROR "failed")
+endif()
@@ -39,6 +39,74 @@ run_ctest_test(SerialOrder INCLUDE test)
 unset(CASE_CMAKELISTS_SUFFIX_CODE)
 unset(ENV{__CTEST_FAKE_PROCESSOR_COUNT_FOR_TESTING)
 
+# The resource lock makes the tests run one at a time in priority order.
+set(CASE_CMAKELISTS_SUFFIX_CODE [[
+foreach(t IN ITEMS a1 a2 a3 b c)
+  add_test(NAME test_${t} COMMAND ${CMAKE_COMMAND} -E true)
+  set_property(TEST test_${t} PROPERTY RESOURCE_LOCK resource)
+endforeach()
+set_property(TEST test_a1 test_a2 test_a3 PROPERTY COST 1)
+set_property(TEST test_a2 PROPERTY DEPENDS test_a1)
+set_property(TEST test_a3 PROPERTY DEPENDS test_a2)
+set_property(TEST test_b PROPERTY COST 2)
+set_property(TEST test_c PROPERTY COST 0.5)
+]])
+run_ctest_test(CriticalPathOrder INCLUDE test_ PARALLEL_LEVEL 2 SCHEDULE_CRITICAL_PATH ON)
+unset(CASE_CMAKELISTS_SUFFIX_CODE)
+
+# Dependent tests and tests locking a common resource stay together.
+set(CASE_CMAKELISTS_SUFFIX_CODE [[
+foreach(t IN ITEMS a1 a2 b c1 c2 d)
+  add_test(NAME test_${t} COMMAND ${CMAKE_COMMAND} -E true)
+endforeach()
+set_property(TEST test_a1 test_a2 test_c1 test_c2 PROPERTY COST 1)
+set_property(TEST test_a2 PROPERTY DEPENDS test_a1)
+set_property(TEST test_b PROPERTY COST 3)
+set_property(TEST test_c1 test_c2 PROPERTY RESOURCE_LOCK resource)
+]])
+run_ctest_test(Shard0 INCLUDE test_ SHARD_COUNT 2 SHARD_INDEX 0)
+run_ctest_test(Shard1 INCLUDE test_ SHARD_COUNT 2 SHARD_INDEX 1 OUTPUT_JUNIT junit.xml)
+run_ctest_test(ShardBad INCLUDE test_ SHARD_COUNT 2 SHARD_INDEX 2)
+unset(CASE_CMAKELISTS_SUFFIX_CODE)
+
+set(CASE_CMAKELISTS_SUFFIX_CODE [[
+foreach(t IN ITEMS a b c d)
+  add_test(NAME test_${t} COMMAND ${CMAKE_COMMAND} -E true)
+endforeach()
+file(WRITE "${CMAKE_BINARY_DIR}/Testing/Temporary/CTestCostData.txt"
+  "test_a 1 5\ntest_b 1 4\ntest_c 1 3\ntest_d 1 2\n---\n")
+]])
+run_ctest_test(ShardSameTree INCLUDE test_ SHARD_COUNT 2 PARALLEL_LEVEL 2)
+unset(CASE_CMAKELISTS_SUFFIX_CODE)
+
+set(CASE_CMAKELISTS_SUFFIX_CODE [[
+add_test(NAME test_a COMMAND ${CMAKE_COMMAND} -E sleep 1)
+add_test(NAME test_b COMMAND ${CMAKE_COMMAND} -E env ${CMAKE_COMMAND} -E sleep 1)
+file(WRITE "${CMAKE_BINARY_DIR}/Testing/Temporary/CTestMemoryData.txt"
+  "test_a 600\ntest_b 600\n")
+]])
+run_ctest_test(MemoryLimit INCLUDE test_ PARALLEL_LEVEL 2 TEST_MEMORY_LIMIT 1000K)
+run_ctest_test(MemoryNoLimit INCLUDE test_ PARALLEL_LEVEL 2)
+run_ctest_test(MemoryLimitBad INCLUDE test_ TEST_MEMORY_LIMIT 1X)
+unset(CASE_CMAKELISTS_SUFFIX_CODE)
+
+set(CASE_TEST_PREFIX_CODE [[
+set(CTEST_CUSTOM_MAXIMUM_PASSED_TEST_OUTPUT_SIZE 200)
+set(CTEST_CUSTOM_MAXIMUM_FAILED_TEST_OUTPUT_SIZE 200)
+]])
+set(CASE_CMAKELISTS_SUFFIX_CODE [[
+set(script ]] "${RunCMake_SOURCE_DIR}/OutputSpool.cmake" [[)
+add_test(NAME test_pass COMMAND ${CMAKE_COMMAND} -P ${script})
+add_test(NAME test_fail COMMAND ${CMAKE_COMMAND} -DFAIL=1 -P ${script})
+add_test(NAME test_full COMMAND ${CMAKE_COMMAND} -DFULL=1 -P ${script})
+add_test(NAME test_same_name COMMAND ${CMAKE_COMMAND} -P ${script})
+add_test(NAME test_same+name COMMAND ${CMAKE_COMMAND} -DFAIL=1 -P ${script})
+]])
+run_ctest_test(OutputSpool INCLUDE test_ OUTPUT_SPOOL ON OUTPUT_JUNIT junit.xml
+  PARALLEL_LEVEL 2)
+unset(CASE_CMAKELISTS_SUFFIX_CODE)
+unset(CASE_TEST_PREFIX_CODE)
+
 set(CASE_CMAKELISTS_SUFFIX_CODE [[
 add_test(NAME skip COMMAND ${CMAKE_COMMAND} -E true)
 set_property(TEST skip PROPERTY SKIP_RETURN_CODE 0)
@@ -262,6 +330,7 @@ run_environment()
 
 # test for OUTPUT_JUNIT
 run_ctest_test(OutputJUnit OUTPUT_JUNIT junit.xml REPEAT UNTIL_FAIL:2)
+run_ctest_test(TestHistory TEST_HISTORY ON)
 
 # Verify that extra measurements get reported.
 function(run_measurements)
@@ -0,0 +1,7 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/junit.xml" junit_xml)
+if(NOT junit_xml MATCHES "<property name=\"cmake_shard_index\" value=\"1\"/>")
+  string(APPEND RunCMake_TEST_FAILED "cmake_shard_index property not found\n")
+endif()
+if(NOT junit_xml MATCHES "<property name=\"cmake_shard_count\" value=\"2\"/>")
+  string(APPEND RunCMake_TEST_FAILED "cmake_shard_count property not found\n")
+endif()
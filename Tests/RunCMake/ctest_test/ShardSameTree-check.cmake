@@ -0,0 +1,9 @@
+# The second shard must select its tests from the same costs as the
+# first one, so every test runs exactly once.
+foreach(t IN ITEMS a b c d)
+  string(REGEX MATCHALL "Test +#[0-9]+: test_${t} " runs "${actual_stdout}")
+  list(LENGTH runs count)
+  if(NOT count EQUAL 1)
+    string(APPEND RunCMake_TEST_FAILED "test_${t} ran ${count} times\n")
+  endif()
+endforeach()
@@ -0,0 +1,23 @@
+set(history_log "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestTestHistory.log")
+set(history_json "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestTestHistory.json")
+if(NOT EXISTS "${history_log}")
+  set(RunCMake_TEST_FAILED "CTestTestHistory.log not found")
+  return()
+endif()
+file(STRINGS "${history_log}" runs)
+list(LENGTH runs count)
+if(NOT count EQUAL 1 OR NOT runs MATCHES [["name":"RunCMakeVersion"]] OR NOT runs MATCHES [["passed":true]])
+  set(RunCMake_TEST_FAILED "Unexpected CTestTestHistory.log content:\n${runs}")
+  return()
+endif()
+if(NOT EXISTS "${history_json}")
+  set(RunCMake_TEST_FAILED "CTestTestHistory.json not found")
+  return()
+endif()
+file(READ "${history_json}" json)
+string(JSON name GET "${json}" tests 0 name)
+string(JSON runs GET "${json}" tests 0 runs)
+string(JSON p90 GET "${json}" tests 0 duration p90)
+if(NOT name STREQUAL "RunCMakeVersion" OR NOT runs EQUAL 1 OR NOT p90 GREATER_EQUAL 0)
+  set(RunCMake_TEST_FAILED "Unexpected CTestTestHistory.json content:\n${json}")
+endif()
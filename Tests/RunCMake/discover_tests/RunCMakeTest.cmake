@@ -35,3 +35,25 @@ run_case(bad-command)
 run_case(bad-regex)
 run_case(discovery-failure)
 run_case(discovery-timeout)
+
+block()
+  set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/cache-build")
+  run_cmake(cache)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(cache-first ${CMAKE_CTEST_COMMAND} -C Debug -N)
+  run_cmake_command(cache-cached ${CMAKE_CTEST_COMMAND} -C Debug -N)
+  file(APPEND "${RunCMake_TEST_BINARY_DIR}/list.cmake" "message(STATUS \"case_two\")\n")
+  run_cmake_command(cache-changed ${CMAKE_CTEST_COMMAND} -C Debug -N)
+  # Variables not named by the discovery properties do not invalidate the
+  # cache.  Entries of other commands are removed only once their input
+  # files no longer exist.
+  set(cache_dir "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/DiscoverTests")
+  file(WRITE "${cache_dir}/stale.json" "{}\n")
+  file(WRITE "${cache_dir}/gone.json"
+    "{\"files\":[\"${RunCMake_TEST_BINARY_DIR}/gone.cmake\"]}\n")
+  file(WRITE "${cache_dir}/other.json"
+    "{\"files\":[\"${RunCMake_TEST_BINARY_DIR}/list.cmake\"]}\n")
+  set(ENV{CMAKE_DISCOVER_TESTS_UNRELATED} 1)
+  run_cmake_command(cache-unrelated ${CMAKE_CTEST_COMMAND} -C Debug -N)
+  unset(ENV{CMAKE_DISCOVER_TESTS_UNRELATED})
+endblock()
@@ -0,0 +1,5 @@
+file(STRINGS "${RunCMake_TEST_BINARY_DIR}/count.txt" runs)
+list(LENGTH runs count)
+if(NOT count EQUAL 1)
+  set(RunCMake_TEST_FAILED "Discovery command ran ${count} times, expected 1.")
+endif()
@@ -0,0 +1,11 @@
+file(STRINGS "${RunCMake_TEST_BINARY_DIR}/count.txt" runs)
+list(LENGTH runs count)
+if(NOT count EQUAL 2)
+  set(RunCMake_TEST_FAILED "Discovery command ran ${count} times, expected 2.")
+endif()
+file(GLOB entries "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/DiscoverTests/*")
+list(LENGTH entries count)
+if(NOT count EQUAL 2 OR NOT entries MATCHES "other\\.json" OR
+    entries MATCHES "stale|gone")
+  string(APPEND RunCMake_TEST_FAILED "Discovery cache not pruned:\n  ${entries}\n")
+endif()
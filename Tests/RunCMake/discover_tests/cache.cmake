@@ -0,0 +1,13 @@
+enable_testing()
+
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/list.cmake [[
+file(APPEND "${CMAKE_CURRENT_LIST_DIR}/count.txt" "run\n")
+message(STATUS "case_one")
+]])
+
+discover_tests(COMMAND ${CMAKE_COMMAND}
+  DISCOVERY_ARGS -P ${CMAKE_CURRENT_BINARY_DIR}/list.cmake
+  DISCOVERY_MATCH "^-- (.*)$"
+  TEST_NAME "Cache.\\1"
+  TEST_ARGS -E true
+)
@@ -0,0 +1,77 @@
+enable_language(C)
+
+set(good_source "int main(void) { return 0; }\n")
+set(bad_source "#error \"this source does not compile\"\n")
+
+try_compile(BATCH_GOOD
+  SOURCE_FROM_VAR good.c good_source
+  BATCH
+  OUTPUT_VARIABLE BATCH_GOOD_OUTPUT
+  COPY_FILE "${CMAKE_CURRENT_BINARY_DIR}/batch_copy"
+  )
+try_compile(BATCH_BAD
+  SOURCE_FROM_VAR bad.c bad_source
+  BATCH
+  )
+try_compile(BATCH_NO_CACHE
+  SOURCE_FROM_VAR good.c good_source
+  NO_CACHE
+  BATCH
+  )
+try_compile(BATCH_PROJECT
+  PROJECT TestProject
+  SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/proj
+  BINARY_DIR ${CMAKE_CURRENT_BINARY_DIR}/batch_proj
+  BATCH
+  )
+
+foreach(var IN ITEMS BATCH_GOOD BATCH_GOOD_OUTPUT BATCH_BAD BATCH_NO_CACHE BATCH_PROJECT)
+  if(DEFINED ${var})
+    message(SEND_ERROR "${var} defined before the batch was collected")
+  endif()
+endforeach()
+
+try_compile(COLLECT_BATCH JOBS 2)
+
+if(NOT BATCH_GOOD)
+  message(SEND_ERROR "BATCH_GOOD is not true:\n${BATCH_GOOD_OUTPUT}")
+endif()
+if(NOT BATCH_GOOD_OUTPUT MATCHES "Run Build Command")
+  message(SEND_ERROR "BATCH_GOOD_OUTPUT has no build output:\n${BATCH_GOOD_OUTPUT}")
+endif()
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/batch_copy")
+  message(SEND_ERROR "COPY_FILE of BATCH_GOOD not created")
+endif()
+if(NOT DEFINED BATCH_BAD OR BATCH_BAD)
+  message(SEND_ERROR "BATCH_BAD is not false")
+endif()
+if(NOT BATCH_NO_CACHE)
+  message(SEND_ERROR "BATCH_NO_CACHE is not true")
+endif()
+get_property(cached CACHE BATCH_NO_CACHE PROPERTY TYPE SET)
+if(cached)
+  message(SEND_ERROR "BATCH_NO_CACHE is cached")
+endif()
+if(NOT BATCH_PROJECT)
+  message(SEND_ERROR "BATCH_PROJECT is not true")
+endif()
+
+# An empty batch may be collected.
+try_compile(COLLECT_BATCH)
+
+# Calls not collected by a directory are collected at its end.
+add_subdirectory(BatchSubdir)
+if(NOT BATCH_SUBDIR)
+  message(SEND_ERROR "BATCH_SUBDIR is not true")
+endif()
+
+# A value too large for the thread pool is clamped.
+try_compile(BATCH_MANY_JOBS
+  SOURCE_FROM_VAR good.c good_source
+  NO_CACHE
+  BATCH
+  )
+try_compile(COLLECT_BATCH JOBS 4294967297)
+if(NOT BATCH_MANY_JOBS)
+  message(SEND_ERROR "BATCH_MANY_JOBS is not true")
+endif()
@@ -0,0 +1 @@
+try_compile(COLLECT_BATCH JOBS 0)
@@ -0,0 +1,4 @@
+file(STRINGS "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt" result REGEX "^BATCH_GENERATE_FAIL:")
+if(NOT result STREQUAL "BATCH_GENERATE_FAIL:INTERNAL=FALSE")
+  set(RunCMake_TEST_FAILED "The result of a batched project that fails to generate is not FALSE:\n  ${result}")
+endif()
@@ -0,0 +1,6 @@
+try_compile(BATCH_GENERATE_FAIL
+  PROJECT TestProject
+  SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/BatchGenerateFail
+  BINARY_DIR ${CMAKE_CURRENT_BINARY_DIR}/batch_generate_fail
+  BATCH
+  )
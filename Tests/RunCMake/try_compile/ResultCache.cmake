@@ -0,0 +1,64 @@
+enable_language(C)
+
+set(CMAKE_TRY_COMPILE_CACHE_DIR "${CMAKE_CURRENT_BINARY_DIR}/cache")
+file(REMOVE_RECURSE "${CMAKE_TRY_COMPILE_CACHE_DIR}")
+
+set(good_source "int main(void) { return 0; }\n")
+set(bad_source "#error \"this source does not compile\"\n")
+set(run_source "#include <stdio.h>\nint main(void) { puts(\"ran\"); return 3; }\n")
+
+try_compile(GOOD SOURCE_FROM_VAR good.c good_source NO_CACHE)
+try_compile(BAD SOURCE_FROM_VAR bad.c bad_source NO_CACHE)
+try_run(RUN_RESULT RUN_COMPILED SOURCE_FROM_VAR run.c run_source NO_CACHE
+  RUN_OUTPUT_VARIABLE RUN_OUTPUT)
+if(NOT GOOD OR BAD OR NOT RUN_COMPILED OR NOT RUN_RESULT EQUAL 3)
+  message(FATAL_ERROR "Checks failed before caching.")
+endif()
+
+file(GLOB_RECURSE entries "${CMAKE_TRY_COMPILE_CACHE_DIR}/*.json")
+list(LENGTH entries count)
+if(NOT count EQUAL 3)
+  message(FATAL_ERROR "Expected 3 cache entries, found ${count}:\n${entries}")
+endif()
+
+# Mark the cached output so that results taken from the cache are known.
+foreach(entry IN LISTS entries)
+  file(READ "${entry}" content)
+  string(REPLACE "Change Dir:" "From the cache. Change Dir:" content "${content}")
+  string(REPLACE "ran" "ran from the cache" content "${content}")
+  file(WRITE "${entry}" "${content}")
+endforeach()
+
+try_compile(GOOD SOURCE_FROM_VAR good.c good_source NO_CACHE
+  OUTPUT_VARIABLE GOOD_OUTPUT)
+try_compile(BAD SOURCE_FROM_VAR bad.c bad_source NO_CACHE BATCH
+  OUTPUT_VARIABLE BAD_OUTPUT)
+try_compile(COLLECT_BATCH)
+try_run(RUN_RESULT RUN_COMPILED SOURCE_FROM_VAR run.c run_source NO_CACHE
+  RUN_OUTPUT_VARIABLE RUN_OUTPUT)
+if(NOT GOOD OR NOT GOOD_OUTPUT MATCHES "^From the cache")
+  message(SEND_ERROR "GOOD not taken from the cache:\n${GOOD_OUTPUT}")
+endif()
+if(BAD OR NOT BAD_OUTPUT MATCHES "^From the cache")
+  message(SEND_ERROR "BAD not taken from the cache:\n${BAD_OUTPUT}")
+endif()
+if(NOT RUN_RESULT EQUAL 3 OR NOT RUN_OUTPUT MATCHES "^ran from the cache")
+  message(SEND_ERROR "RUN_RESULT not taken from the cache:\n${RUN_OUTPUT}")
+endif()
+
+# A different source is a different check.
+set(good_source "int main(void) { return 1; }\n")
+try_compile(GOOD SOURCE_FROM_VAR good.c good_source NO_CACHE
+  OUTPUT_VARIABLE GOOD_OUTPUT)
+if(NOT GOOD OR GOOD_OUTPUT MATCHES "^From the cache")
+  message(SEND_ERROR "GOOD taken from the cache after its source changed")
+endif()
+
+# Checks with COPY_FILE are not cached.
+try_compile(COPIED SOURCE_FROM_VAR good.c good_source NO_CACHE
+  COPY_FILE "${CMAKE_CURRENT_BINARY_DIR}/copied")
+file(GLOB_RECURSE entries "${CMAKE_TRY_COMPILE_CACHE_DIR}/*.json")
+list(LENGTH entries count)
+if(NOT count EQUAL 4)
+  message(SEND_ERROR "Expected 4 cache entries, found ${count}:\n${entries}")
+endif()
@@ -42,6 +42,11 @@ run_cmake(SourceFromThreeArgs)
 run_cmake(SourceFromBadName)
 run_cmake(SourceFromBadFile)
 
+run_cmake(Batch)
+run_cmake(BatchBadJobs)
+run_cmake(BatchGenerateFail)
+run_cmake(ResultCache)
+
 run_cmake(ProjectCopyFile)
 run_cmake(NonSourceCopyFile)
 run_cmake(NonSourceCompileDefinitions)